@@ -0,0 +1,84 @@
+//
+//  RZAssertBenchmarkAllocations.c
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Counts heap allocations per thread. On glibc, defining malloc, calloc and realloc
+// in the executable interposes them for every library in the process, including
+// Foundation and the Objective-C runtime. Aligned allocations are not counted.
+// Elsewhere, allocations are not counted and the benchmarks report them as null.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GLIBC__)
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static __thread uint64_t t_allocationCount = 0;
+
+void *malloc(size_t size)
+{
+    t_allocationCount++;
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    t_allocationCount++;
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    t_allocationCount++;
+    return __libc_realloc(pointer, size);
+}
+
+uint64_t RZAssertBenchmarkAllocationCount(void)
+{
+    return t_allocationCount;
+}
+
+int RZAssertBenchmarkCountsAllocations(void)
+{
+    return 1;
+}
+
+#else
+
+uint64_t RZAssertBenchmarkAllocationCount(void)
+{
+    return 0;
+}
+
+int RZAssertBenchmarkCountsAllocations(void)
+{
+    return 0;
+}
+
+#endif
@@ -0,0 +1,399 @@
+//
+//  RZAssertBenchmarkCases.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Compiled twice by `rake benchmark`: with RZASSERT_BENCHMARK_MODE=Enabled, and with
+// RZASSERT_BENCHMARK_MODE=Disabled plus NS_BLOCK_ASSERTIONS and NDEBUG.
+
+#import "RZAssertBenchmarks.h"
+
+#include <assert.h>
+
+#if !defined(RZASSERT_BENCHMARK_MODE)
+#error "Define RZASSERT_BENCHMARK_MODE as Enabled or Disabled"
+#endif
+
+#define RZASSERT_BENCHMARK_CONCAT_(a, b)    a##b
+#define RZASSERT_BENCHMARK_CONCAT(a, b)     RZASSERT_BENCHMARK_CONCAT_(a, b)
+
+#define RZAssertBenchmarkTarget             RZASSERT_BENCHMARK_CONCAT(RZAssertBenchmarkTarget, RZASSERT_BENCHMARK_MODE)
+#define RZAssertBenchmarkSuiteFunction      RZASSERT_BENCHMARK_CONCAT(RZAssertBenchmarkSuite, RZASSERT_BENCHMARK_MODE)
+
+#define RZAssertBenchmarkNetworkingCategory RZASSERT_CATEGORY(1)
+
+#define RZASSERT_BENCHMARK_SAMPLE_COUNT     256
+
+// Defines a method that runs one statement in a loop.
+#define RZASSERT_BENCHMARK(selectorName, ...) \
+    - (void)selectorName:(uint64_t)iterations \
+    { \
+        for ( uint64_t i = 0; i < iterations; i++ ) { \
+            __VA_ARGS__; \
+        } \
+    }
+
+#define RZASSERT_BENCHMARK_CASE(macro, passSelector, failSelector) \
+    { #macro, passSelector, failSelector }
+
+@interface RZAssertBenchmarkTarget : NSObject
+@end
+
+// Operands are ivars, so the compiler can't fold the conditions away.
+@implementation RZAssertBenchmarkTarget {
+    id _object;
+    id _nilObject;
+    id _equalObject;
+    NSString *_string;
+    NSString *_emptyString;
+    NSString *_otherString;
+    BOOL _yes;
+    BOOL _no;
+    NSInteger _one;
+    NSInteger _two;
+    double _pi;
+    double _samples[RZASSERT_BENCHMARK_SAMPLE_COUNT];
+    double _badSamples[RZASSERT_BENCHMARK_SAMPLE_COUNT];
+    NSArray *_numbers;
+    NSArray *_badNumbers;
+    NSDictionary *_numbersByName;
+    NSDictionary *_badNumbersByName;
+    NSString *_longString;
+    NSString *_equalLongString;
+    NSString *_otherLongString;
+}
+
+- (instancetype)init
+{
+    self = [super init];
+    if ( self ) {
+        _object = [NSMutableString stringWithString:@"benchmark"];
+        _nilObject = nil;
+        _equalObject = [_object copy];
+        _string = @"benchmark";
+        _emptyString = @"";
+        _otherString = @"other";
+        _yes = YES;
+        _no = NO;
+        _one = 1;
+        _two = 2;
+        _pi = M_PI;
+        // The bad buffer fails at its last element, so failing cases still scan the whole buffer.
+        for ( NSUInteger i = 0; i < RZASSERT_BENCHMARK_SAMPLE_COUNT; i++ ) {
+            _samples[i] = i;
+            _badSamples[i] = i;
+        }
+        _badSamples[RZASSERT_BENCHMARK_SAMPLE_COUNT - 1] = NAN;
+
+        // The bad array fails at its last element. The bad dictionary has one extra entry, which fails wherever it lands in enumeration order.
+        NSMutableArray *numbers = [NSMutableArray array];
+        NSMutableDictionary *numbersByName = [NSMutableDictionary dictionary];
+        for ( NSUInteger i = 0; i < RZASSERT_BENCHMARK_SAMPLE_COUNT; i++ ) {
+            [numbers addObject:@(i)];
+            numbersByName[[NSString stringWithFormat:@"%lu", (unsigned long)i]] = @(i);
+        }
+        _numbers = [numbers copy];
+        _numbersByName = [numbersByName copy];
+        numbers[RZASSERT_BENCHMARK_SAMPLE_COUNT - 1] = _string;
+        _badNumbers = [numbers copy];
+        numbersByName[@"bad"] = _string;
+        _badNumbersByName = [numbersByName copy];
+
+        // Long strings that differ only in their last character, in separate storage.
+        NSMutableString *longString = [NSMutableString string];
+        for ( NSUInteger i = 0; i < 64 * RZASSERT_BENCHMARK_SAMPLE_COUNT; i++ ) {
+            [longString appendFormat:@"%lu", (unsigned long)(i % 10)];
+        }
+        _longString = [longString copy];
+        _equalLongString = [longString copy];
+        [longString replaceCharactersInRange:NSMakeRange(longString.length - 1, 1) withString:@"!"];
+        _otherLongString = [longString copy];
+    }
+    return self;
+}
+
+#pragma mark - Baselines
+
+RZASSERT_BENCHMARK(passNSAssert, NSAssert(_yes, @"benchmark"))
+RZASSERT_BENCHMARK(failNSAssert, NSAssert(_no, @"benchmark"))
+RZASSERT_BENCHMARK(passNSCAssert, NSCAssert(_yes, @"benchmark"))
+RZASSERT_BENCHMARK(failNSCAssert, NSCAssert(_no, @"benchmark"))
+// A failing assert() aborts, so it is only measured passing.
+RZASSERT_BENCHMARK(passAssert, assert(_yes))
+
+#pragma mark - Objective-C Assertions
+
+RZASSERT_BENCHMARK(passNil, RZASSERT_NIL(_nilObject))
+RZASSERT_BENCHMARK(failNil, RZASSERT_NIL(_object))
+RZASSERT_BENCHMARK(passNotNil, RZASSERT_NOT_NIL(_object))
+RZASSERT_BENCHMARK(failNotNil, RZASSERT_NOT_NIL(_nilObject))
+RZASSERT_BENCHMARK(failAlways, RZASSERT_ALWAYS)
+RZASSERT_BENCHMARK(passTrue, RZASSERT_TRUE(_yes))
+RZASSERT_BENCHMARK(failTrue, RZASSERT_TRUE(_no))
+RZASSERT_BENCHMARK(passFalse, RZASSERT_FALSE(_no))
+RZASSERT_BENCHMARK(failFalse, RZASSERT_FALSE(_yes))
+RZASSERT_BENCHMARK(failWithMessage, RZASSERT_WITH_MESSAGE(@"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(failWithMessageLog, RZASSERT_WITH_MESSAGE_LOG(_string, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(passTrueWithMessage, RZASSERT_TRUE_WITH_MESSAGE(_yes, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(failTrueWithMessage, RZASSERT_TRUE_WITH_MESSAGE(_no, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(passTrueWithMessageLog, RZASSERT_TRUE_WITH_MESSAGE_LOG(_yes, _string, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(failTrueWithMessageLog, RZASSERT_TRUE_WITH_MESSAGE_LOG(_no, _string, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(passTrueLog, RZASSERT_TRUE_LOG(_yes, _string))
+RZASSERT_BENCHMARK(failTrueLog, RZASSERT_TRUE_LOG(_no, _string))
+RZASSERT_BENCHMARK(passLevel, RZASSERT_LEVEL(RZAssertLevelNormal, RZAssertBenchmarkNetworkingCategory, _yes))
+RZASSERT_BENCHMARK(failLevel, RZASSERT_LEVEL(RZAssertLevelNormal, RZAssertBenchmarkNetworkingCategory, _no))
+RZASSERT_BENCHMARK(passLevelDisabled, RZASSERT_LEVEL(RZAssertLevelNormal, RZAssertBenchmarkDisabledCategory, _yes))
+RZASSERT_BENCHMARK(failLevelDisabled, RZASSERT_LEVEL(RZAssertLevelNormal, RZAssertBenchmarkDisabledCategory, _no))
+RZASSERT_BENCHMARK(passCheap, RZASSERT_CHEAP(_yes))
+RZASSERT_BENCHMARK(failCheap, RZASSERT_CHEAP(_no))
+RZASSERT_BENCHMARK(passExpensive, RZASSERT_EXPENSIVE(_yes))
+RZASSERT_BENCHMARK(failExpensive, RZASSERT_EXPENSIVE(_no))
+RZASSERT_BENCHMARK(passSampled, RZASSERT_SAMPLED(0.01, _yes))
+RZASSERT_BENCHMARK(failSampled, RZASSERT_SAMPLED(0.01, _no))
+RZASSERT_BENCHMARK(passEqualObjectPointers, RZASSERT_EQUAL_OBJECT_POINTERS(_object, _object))
+RZASSERT_BENCHMARK(failEqualObjectPointers, RZASSERT_EQUAL_OBJECT_POINTERS(_object, _equalObject))
+RZASSERT_BENCHMARK(passEqualObjects, RZASSERT_EQUAL_OBJECTS(_object, _equalObject))
+RZASSERT_BENCHMARK(failEqualObjects, RZASSERT_EQUAL_OBJECTS(_object, _otherString))
+RZASSERT_BENCHMARK(passEQ, RZASSERT_EQ(_one, _one))
+RZASSERT_BENCHMARK(failEQ, RZASSERT_EQ(_one, _two))
+RZASSERT_BENCHMARK(passNE, RZASSERT_NE(_one, _two))
+RZASSERT_BENCHMARK(failNE, RZASSERT_NE(_one, _one))
+RZASSERT_BENCHMARK(passLT, RZASSERT_LT(_one, _two))
+RZASSERT_BENCHMARK(failLT, RZASSERT_LT(_two, _one))
+RZASSERT_BENCHMARK(passLE, RZASSERT_LE(_one, _one))
+RZASSERT_BENCHMARK(failLE, RZASSERT_LE(_two, _one))
+RZASSERT_BENCHMARK(passGT, RZASSERT_GT(_two, _one))
+RZASSERT_BENCHMARK(failGT, RZASSERT_GT(_one, _two))
+RZASSERT_BENCHMARK(passGE, RZASSERT_GE(_two, _two))
+RZASSERT_BENCHMARK(failGE, RZASSERT_GE(_one, _two))
+RZASSERT_BENCHMARK(passInRange, RZASSERT_IN_RANGE(_pi, _one, _pi))
+RZASSERT_BENCHMARK(failInRange, RZASSERT_IN_RANGE(_pi, _one, _two))
+RZASSERT_BENCHMARK(passApproxEqual, RZASSERT_APPROX_EQUAL(_pi, 3.14, 0.01))
+RZASSERT_BENCHMARK(failApproxEqual, RZASSERT_APPROX_EQUAL(_pi, 3.0, 0.01))
+RZASSERT_BENCHMARK(passAllFinite, RZASSERT_ALL_FINITE(_samples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(failAllFinite, RZASSERT_ALL_FINITE(_badSamples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(passAllInRange, RZASSERT_ALL_IN_RANGE(_samples, RZASSERT_BENCHMARK_SAMPLE_COUNT, 0, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(failAllInRange, RZASSERT_ALL_IN_RANGE(_badSamples, RZASSERT_BENCHMARK_SAMPLE_COUNT, 0, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(passSorted, RZASSERT_SORTED(_samples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(failSorted, RZASSERT_SORTED(_badSamples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(passEqualStrings, RZASSERT_EQUAL_STRINGS(_string, _object))
+RZASSERT_BENCHMARK(failEqualStrings, RZASSERT_EQUAL_STRINGS(_string, _otherString))
+RZASSERT_BENCHMARK(passEqualLongStrings, RZASSERT_EQUAL_STRINGS(_longString, _equalLongString))
+RZASSERT_BENCHMARK(failEqualLongStrings, RZASSERT_EQUAL_STRINGS(_longString, _otherLongString))
+RZASSERT_BENCHMARK(passNonemptyString, RZASSERT_NONEMPTY_STRING(_string))
+RZASSERT_BENCHMARK(failNonemptyString, RZASSERT_NONEMPTY_STRING(_emptyString))
+RZASSERT_BENCHMARK(passKindOf, RZASSERT_KINDOF(_object, NSString))
+RZASSERT_BENCHMARK(failKindOf, RZASSERT_KINDOF(_object, NSNumber))
+RZASSERT_BENCHMARK(passKindOfOrNil, RZASSERT_KINDOF_OR_NIL(_nilObject, NSString))
+RZASSERT_BENCHMARK(failKindOfOrNil, RZASSERT_KINDOF_OR_NIL(_object, NSNumber))
+RZASSERT_BENCHMARK(passAllKindOf, RZASSERT_ALL_KINDOF(_numbers, NSNumber))
+RZASSERT_BENCHMARK(failAllKindOf, RZASSERT_ALL_KINDOF(_badNumbers, NSNumber))
+RZASSERT_BENCHMARK(passAllKeysValuesKindOf, RZASSERT_ALL_KEYS_VALUES_KINDOF(_numbersByName, NSString, NSNumber))
+RZASSERT_BENCHMARK(failAllKeysValuesKindOf, RZASSERT_ALL_KEYS_VALUES_KINDOF(_badNumbersByName, NSString, NSNumber))
+RZASSERT_BENCHMARK(passConformsProtocol, RZASSERT_CONFORMS_PROTOCOL(_object, @protocol(NSCopying)))
+RZASSERT_BENCHMARK(failConformsProtocol, RZASSERT_CONFORMS_PROTOCOL(_object, @protocol(NSFastEnumeration)))
+RZASSERT_BENCHMARK(passClassSubclassOfClass, RZASSERT_CLASS_SUBCLASS_OF_CLASS(NSMutableString, NSString))
+RZASSERT_BENCHMARK(failClassSubclassOfClass, RZASSERT_CLASS_SUBCLASS_OF_CLASS(NSString, NSMutableString))
+RZASSERT_BENCHMARK(passClassSubclassOfClassEveryTime, RZASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME(NSMutableString, NSString))
+RZASSERT_BENCHMARK(failClassSubclassOfClassEveryTime, RZASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME(NSString, NSMutableString))
+RZASSERT_BENCHMARK(failSubclassesMustOverride, RZASSERT_SUBCLASSES_MUST_OVERRIDE)
+RZASSERT_BENCHMARK(failShouldNeverGetHere, RZASSERT_SHOULD_NEVER_GET_HERE)
+
+#pragma mark - C Assertions
+
+RZASSERT_BENCHMARK(passCNil, RZCASSERT_NIL(_nilObject))
+RZASSERT_BENCHMARK(failCNil, RZCASSERT_NIL(_object))
+RZASSERT_BENCHMARK(passCNotNil, RZCASSERT_NOT_NIL(_object))
+RZASSERT_BENCHMARK(failCNotNil, RZCASSERT_NOT_NIL(_nilObject))
+RZASSERT_BENCHMARK(failCAlways, RZCASSERT_ALWAYS)
+RZASSERT_BENCHMARK(passCTrue, RZCASSERT_TRUE(_yes))
+RZASSERT_BENCHMARK(failCTrue, RZCASSERT_TRUE(_no))
+RZASSERT_BENCHMARK(passCFalse, RZCASSERT_FALSE(_no))
+RZASSERT_BENCHMARK(failCFalse, RZCASSERT_FALSE(_yes))
+RZASSERT_BENCHMARK(failCWithMessage, RZCASSERT_WITH_MESSAGE(@"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(failCWithMessageLog, RZCASSERT_WITH_MESSAGE_LOG(_string, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(passCTrueWithMessage, RZCASSERT_TRUE_WITH_MESSAGE(_yes, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(failCTrueWithMessage, RZCASSERT_TRUE_WITH_MESSAGE(_no, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(passCTrueWithMessageLog, RZCASSERT_TRUE_WITH_MESSAGE_LOG(_yes, _string, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(failCTrueWithMessageLog, RZCASSERT_TRUE_WITH_MESSAGE_LOG(_no, _string, @"iteration %llu", (unsigned long long)i))
+RZASSERT_BENCHMARK(passCTrueLog, RZCASSERT_TRUE_LOG(_yes, _string))
+RZASSERT_BENCHMARK(failCTrueLog, RZCASSERT_TRUE_LOG(_no, _string))
+RZASSERT_BENCHMARK(passCLevel, RZCASSERT_LEVEL(RZAssertLevelNormal, RZAssertBenchmarkNetworkingCategory, _yes))
+RZASSERT_BENCHMARK(failCLevel, RZCASSERT_LEVEL(RZAssertLevelNormal, RZAssertBenchmarkNetworkingCategory, _no))
+RZASSERT_BENCHMARK(passCCheap, RZCASSERT_CHEAP(_yes))
+RZASSERT_BENCHMARK(failCCheap, RZCASSERT_CHEAP(_no))
+RZASSERT_BENCHMARK(passCExpensive, RZCASSERT_EXPENSIVE(_yes))
+RZASSERT_BENCHMARK(failCExpensive, RZCASSERT_EXPENSIVE(_no))
+RZASSERT_BENCHMARK(passCSampled, RZCASSERT_SAMPLED(0.01, _yes))
+RZASSERT_BENCHMARK(failCSampled, RZCASSERT_SAMPLED(0.01, _no))
+RZASSERT_BENCHMARK(passCEqualObjectPointers, RZCASSERT_EQUAL_OBJECT_POINTERS(_object, _object))
+RZASSERT_BENCHMARK(failCEqualObjectPointers, RZCASSERT_EQUAL_OBJECT_POINTERS(_object, _equalObject))
+RZASSERT_BENCHMARK(passCEqualObjects, RZCASSERT_EQUAL_OBJECTS(_object, _equalObject))
+RZASSERT_BENCHMARK(failCEqualObjects, RZCASSERT_EQUAL_OBJECTS(_object, _otherString))
+RZASSERT_BENCHMARK(passCEQ, RZCASSERT_EQ(_one, _one))
+RZASSERT_BENCHMARK(failCEQ, RZCASSERT_EQ(_one, _two))
+RZASSERT_BENCHMARK(passCNE, RZCASSERT_NE(_one, _two))
+RZASSERT_BENCHMARK(failCNE, RZCASSERT_NE(_one, _one))
+RZASSERT_BENCHMARK(passCLT, RZCASSERT_LT(_one, _two))
+RZASSERT_BENCHMARK(failCLT, RZCASSERT_LT(_two, _one))
+RZASSERT_BENCHMARK(passCLE, RZCASSERT_LE(_one, _one))
+RZASSERT_BENCHMARK(failCLE, RZCASSERT_LE(_two, _one))
+RZASSERT_BENCHMARK(passCGT, RZCASSERT_GT(_two, _one))
+RZASSERT_BENCHMARK(failCGT, RZCASSERT_GT(_one, _two))
+RZASSERT_BENCHMARK(passCGE, RZCASSERT_GE(_two, _two))
+RZASSERT_BENCHMARK(failCGE, RZCASSERT_GE(_one, _two))
+RZASSERT_BENCHMARK(passCInRange, RZCASSERT_IN_RANGE(_pi, _one, _pi))
+RZASSERT_BENCHMARK(failCInRange, RZCASSERT_IN_RANGE(_pi, _one, _two))
+RZASSERT_BENCHMARK(passCApproxEqual, RZCASSERT_APPROX_EQUAL(_pi, 3.14, 0.01))
+RZASSERT_BENCHMARK(failCApproxEqual, RZCASSERT_APPROX_EQUAL(_pi, 3.0, 0.01))
+RZASSERT_BENCHMARK(passCAllFinite, RZCASSERT_ALL_FINITE(_samples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(failCAllFinite, RZCASSERT_ALL_FINITE(_badSamples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(passCAllInRange, RZCASSERT_ALL_IN_RANGE(_samples, RZASSERT_BENCHMARK_SAMPLE_COUNT, 0, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(failCAllInRange, RZCASSERT_ALL_IN_RANGE(_badSamples, RZASSERT_BENCHMARK_SAMPLE_COUNT, 0, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(passCSorted, RZCASSERT_SORTED(_samples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(failCSorted, RZCASSERT_SORTED(_badSamples, RZASSERT_BENCHMARK_SAMPLE_COUNT))
+RZASSERT_BENCHMARK(passCEqualStrings, RZCASSERT_EQUAL_STRINGS(_string, _object))
+RZASSERT_BENCHMARK(failCEqualStrings, RZCASSERT_EQUAL_STRINGS(_string, _otherString))
+RZASSERT_BENCHMARK(passCEqualLongStrings, RZCASSERT_EQUAL_STRINGS(_longString, _equalLongString))
+RZASSERT_BENCHMARK(failCEqualLongStrings, RZCASSERT_EQUAL_STRINGS(_longString, _otherLongString))
+RZASSERT_BENCHMARK(passCNonemptyString, RZCASSERT_NONEMPTY_STRING(_string))
+RZASSERT_BENCHMARK(failCNonemptyString, RZCASSERT_NONEMPTY_STRING(_emptyString))
+RZASSERT_BENCHMARK(passCKindOf, RZCASSERT_KINDOF(_object, NSString))
+RZASSERT_BENCHMARK(failCKindOf, RZCASSERT_KINDOF(_object, NSNumber))
+RZASSERT_BENCHMARK(passCKindOfOrNil, RZCASSERT_KINDOF_OR_NIL(_nilObject, NSString))
+RZASSERT_BENCHMARK(failCKindOfOrNil, RZCASSERT_KINDOF_OR_NIL(_object, NSNumber))
+RZASSERT_BENCHMARK(passCAllKindOf, RZCASSERT_ALL_KINDOF(_numbers, NSNumber))
+RZASSERT_BENCHMARK(failCAllKindOf, RZCASSERT_ALL_KINDOF(_badNumbers, NSNumber))
+RZASSERT_BENCHMARK(passCAllKeysValuesKindOf, RZCASSERT_ALL_KEYS_VALUES_KINDOF(_numbersByName, NSString, NSNumber))
+RZASSERT_BENCHMARK(failCAllKeysValuesKindOf, RZCASSERT_ALL_KEYS_VALUES_KINDOF(_badNumbersByName, NSString, NSNumber))
+RZASSERT_BENCHMARK(passCConformsProtocol, RZCASSERT_CONFORMS_PROTOCOL(_object, @protocol(NSCopying)))
+RZASSERT_BENCHMARK(failCConformsProtocol, RZCASSERT_CONFORMS_PROTOCOL(_object, @protocol(NSFastEnumeration)))
+RZASSERT_BENCHMARK(passCClassSubclassOfClass, RZCASSERT_CLASS_SUBCLASS_OF_CLASS(NSMutableString, NSString))
+RZASSERT_BENCHMARK(failCClassSubclassOfClass, RZCASSERT_CLASS_SUBCLASS_OF_CLASS(NSString, NSMutableString))
+RZASSERT_BENCHMARK(passCClassSubclassOfClassEveryTime, RZCASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME(NSMutableString, NSString))
+RZASSERT_BENCHMARK(failCClassSubclassOfClassEveryTime, RZCASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME(NSString, NSMutableString))
+RZASSERT_BENCHMARK(failCShouldNeverGetHere, RZCASSERT_SHOULD_NEVER_GET_HERE)
+
+@end
+
+static const RZAssertBenchmarkCase kCases[] = {
+    RZASSERT_BENCHMARK_CASE(NSAssert, "passNSAssert:", "failNSAssert:"),
+    RZASSERT_BENCHMARK_CASE(NSCAssert, "passNSCAssert:", "failNSCAssert:"),
+    RZASSERT_BENCHMARK_CASE(assert, "passAssert:", NULL),
+
+    RZASSERT_BENCHMARK_CASE(RZASSERT_NIL, "passNil:", "failNil:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_NOT_NIL, "passNotNil:", "failNotNil:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_ALWAYS, NULL, "failAlways:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_TRUE, "passTrue:", "failTrue:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_FALSE, "passFalse:", "failFalse:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_WITH_MESSAGE, NULL, "failWithMessage:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_WITH_MESSAGE_LOG, NULL, "failWithMessageLog:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_TRUE_WITH_MESSAGE, "passTrueWithMessage:", "failTrueWithMessage:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_TRUE_WITH_MESSAGE_LOG, "passTrueWithMessageLog:", "failTrueWithMessageLog:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_TRUE_LOG, "passTrueLog:", "failTrueLog:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_LEVEL, "passLevel:", "failLevel:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_LEVEL (disabled category), "passLevelDisabled:", "failLevelDisabled:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_CHEAP, "passCheap:", "failCheap:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_EXPENSIVE (disabled level), "passExpensive:", "failExpensive:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_SAMPLED, "passSampled:", "failSampled:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_EQUAL_OBJECT_POINTERS, "passEqualObjectPointers:", "failEqualObjectPointers:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_EQUAL_OBJECTS, "passEqualObjects:", "failEqualObjects:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_EQ, "passEQ:", "failEQ:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_NE, "passNE:", "failNE:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_LT, "passLT:", "failLT:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_LE, "passLE:", "failLE:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_GT, "passGT:", "failGT:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_GE, "passGE:", "failGE:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_IN_RANGE, "passInRange:", "failInRange:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_APPROX_EQUAL, "passApproxEqual:", "failApproxEqual:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_ALL_FINITE, "passAllFinite:", "failAllFinite:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_ALL_IN_RANGE, "passAllInRange:", "failAllInRange:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_SORTED, "passSorted:", "failSorted:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_EQUAL_STRINGS, "passEqualStrings:", "failEqualStrings:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_EQUAL_STRINGS (long), "passEqualLongStrings:", "failEqualLongStrings:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_NONEMPTY_STRING, "passNonemptyString:", "failNonemptyString:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_KINDOF, "passKindOf:", "failKindOf:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_KINDOF_OR_NIL, "passKindOfOrNil:", "failKindOfOrNil:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_ALL_KINDOF, "passAllKindOf:", "failAllKindOf:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_ALL_KEYS_VALUES_KINDOF, "passAllKeysValuesKindOf:", "failAllKeysValuesKindOf:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_CONFORMS_PROTOCOL, "passConformsProtocol:", "failConformsProtocol:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_CLASS_SUBCLASS_OF_CLASS, "passClassSubclassOfClass:", "failClassSubclassOfClass:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME, "passClassSubclassOfClassEveryTime:", "failClassSubclassOfClassEveryTime:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_SUBCLASSES_MUST_OVERRIDE, NULL, "failSubclassesMustOverride:"),
+    RZASSERT_BENCHMARK_CASE(RZASSERT_SHOULD_NEVER_GET_HERE, NULL, "failShouldNeverGetHere:"),
+
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_NIL, "passCNil:", "failCNil:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_NOT_NIL, "passCNotNil:", "failCNotNil:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_ALWAYS, NULL, "failCAlways:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_TRUE, "passCTrue:", "failCTrue:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_FALSE, "passCFalse:", "failCFalse:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_WITH_MESSAGE, NULL, "failCWithMessage:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_WITH_MESSAGE_LOG, NULL, "failCWithMessageLog:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_TRUE_WITH_MESSAGE, "passCTrueWithMessage:", "failCTrueWithMessage:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_TRUE_WITH_MESSAGE_LOG, "passCTrueWithMessageLog:", "failCTrueWithMessageLog:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_TRUE_LOG, "passCTrueLog:", "failCTrueLog:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_LEVEL, "passCLevel:", "failCLevel:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_CHEAP, "passCCheap:", "failCCheap:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_EXPENSIVE (disabled level), "passCExpensive:", "failCExpensive:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_SAMPLED, "passCSampled:", "failCSampled:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_EQUAL_OBJECT_POINTERS, "passCEqualObjectPointers:", "failCEqualObjectPointers:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_EQUAL_OBJECTS, "passCEqualObjects:", "failCEqualObjects:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_EQ, "passCEQ:", "failCEQ:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_NE, "passCNE:", "failCNE:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_LT, "passCLT:", "failCLT:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_LE, "passCLE:", "failCLE:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_GT, "passCGT:", "failCGT:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_GE, "passCGE:", "failCGE:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_IN_RANGE, "passCInRange:", "failCInRange:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_APPROX_EQUAL, "passCApproxEqual:", "failCApproxEqual:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_ALL_FINITE, "passCAllFinite:", "failCAllFinite:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_ALL_IN_RANGE, "passCAllInRange:", "failCAllInRange:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_SORTED, "passCSorted:", "failCSorted:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_EQUAL_STRINGS, "passCEqualStrings:", "failCEqualStrings:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_EQUAL_STRINGS (long), "passCEqualLongStrings:", "failCEqualLongStrings:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_NONEMPTY_STRING, "passCNonemptyString:", "failCNonemptyString:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_KINDOF, "passCKindOf:", "failCKindOf:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_KINDOF_OR_NIL, "passCKindOfOrNil:", "failCKindOfOrNil:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_ALL_KINDOF, "passCAllKindOf:", "failCAllKindOf:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_ALL_KEYS_VALUES_KINDOF, "passCAllKeysValuesKindOf:", "failCAllKeysValuesKindOf:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_CONFORMS_PROTOCOL, "passCConformsProtocol:", "failCConformsProtocol:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_CLASS_SUBCLASS_OF_CLASS, "passCClassSubclassOfClass:", "failCClassSubclassOfClass:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME, "passCClassSubclassOfClassEveryTime:", "failCClassSubclassOfClassEveryTime:"),
+    RZASSERT_BENCHMARK_CASE(RZCASSERT_SHOULD_NEVER_GET_HERE, NULL, "failCShouldNeverGetHere:"),
+};
+
+RZAssertBenchmarkSuite RZAssertBenchmarkSuiteFunction(void)
+{
+    RZAssertBenchmarkSuite suite;
+#if defined(NS_BLOCK_ASSERTIONS)
+    suite.mode = "disabled";
+#else
+    suite.mode = "enabled";
+#endif
+    suite.targetClass = [RZAssertBenchmarkTarget class];
+    suite.cases = kCases;
+    suite.caseCount = sizeof(kCases) / sizeof(kCases[0]);
+    return suite;
+}
@@ -0,0 +1,86 @@
+//
+//  RZAssertBenchmarks.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Shared between the benchmark driver and the case table, which is compiled
+// once with assertions enabled and once with NS_BLOCK_ASSERTIONS defined.
+
+#import "RZAssert.h"
+
+/**
+ *  A category the driver disables, to measure assertions skipped by category.
+ */
+#define RZAssertBenchmarkDisabledCategory RZASSERT_CATEGORY(15)
+
+/**
+ *  Runs one assertion statement in a loop. Cases are methods so that the
+ *  Objective-C macros, which refer to self and _cmd, can be measured.
+ */
+typedef void (*RZAssertBenchmarkBody)(id target, SEL selector, uint64_t iterations);
+
+typedef struct {
+    /**
+     *  The macro being measured, such as "RZASSERT_NOT_NIL".
+     */
+    const char *name;
+    /**
+     *  The selector that runs the macro with operands that pass, or NULL if the macro always fails.
+     */
+    const char *pass;
+    /**
+     *  The selector that runs the macro with operands that fail, or NULL if the macro cannot fail.
+     */
+    const char *fail;
+} RZAssertBenchmarkCase;
+
+typedef struct {
+    /**
+     *  "enabled" or "disabled", for whether NS_BLOCK_ASSERTIONS was defined.
+     */
+    const char *mode;
+    /**
+     *  Implements the case selectors. Instances hold the operands.
+     */
+    Class targetClass;
+    const RZAssertBenchmarkCase *cases;
+    NSUInteger caseCount;
+} RZAssertBenchmarkSuite;
+
+FOUNDATION_EXPORT RZAssertBenchmarkSuite RZAssertBenchmarkSuiteEnabled(void);
+FOUNDATION_EXPORT RZAssertBenchmarkSuite RZAssertBenchmarkSuiteDisabled(void);
+
+/**
+ *  Makes failing assertions on the calling thread return instead of raising,
+ *  so failures can be measured in a loop when assertions are enabled.
+ */
+FOUNDATION_EXPORT void RZAssertBenchmarkInstallQuietAssertionHandler(void);
+
+/**
+ *  The number of heap allocations made by the calling thread so far, or 0 if
+ *  allocations can't be counted on this platform.
+ */
+FOUNDATION_EXPORT uint64_t RZAssertBenchmarkAllocationCount(void);
+FOUNDATION_EXPORT int RZAssertBenchmarkCountsAllocations(void);
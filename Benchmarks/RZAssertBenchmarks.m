@@ -0,0 +1,432 @@
+//
+//  RZAssertBenchmarks.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Build and run with `rake benchmark`, on macOS or on Linux with clang and GNUstep.
+//
+// Every macro in RZAssert.h, plus NSAssert, NSCAssert and assert() as baselines, is
+// measured passing and failing; with assertions enabled and with NS_BLOCK_ASSERTIONS;
+// with and without a logging handler; and on one thread and on several threads
+// hitting the same call sites at once. Results are printed as a table, and written
+// as JSON with --output so runs can be compared. The size of the failing cases' failures
+// in the wire encoding is printed too, against their flat messages.
+//
+// Options:
+//   --output PATH   write JSON results to PATH
+//   --threads N     threads for contended runs (default: active processors, 2 to 8)
+//   --time MS       target duration of each measurement (default: 50)
+//   --filter TEXT   only run macros whose name contains TEXT
+
+#import "RZAssertBenchmarks.h"
+
+#include <objc/runtime.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const uint64_t kNanosecondsPerSecond = 1000000000ull;
+static const uint64_t kNanosecondsPerMillisecond = 1000000ull;
+
+static uintptr_t s_sink = 0;
+
+#pragma mark - Quiet Assertion Handler
+
+// Formats the failure like the default handler, but returns instead of raising.
+@interface RZAssertBenchmarkAssertionHandler : NSAssertionHandler
+@end
+
+@implementation RZAssertBenchmarkAssertionHandler
+
+- (void)handleFailureInMethod:(SEL)selector object:(id)object file:(NSString *)fileName lineNumber:(NSInteger)line description:(NSString *)format, ...
+{
+    va_list args;
+    va_start(args, format);
+    NSString *description = [[NSString alloc] initWithFormat:format arguments:args];
+    va_end(args);
+
+    __atomic_add_fetch(&s_sink, [description length], __ATOMIC_RELAXED);
+}
+
+- (void)handleFailureInFunction:(NSString *)functionName file:(NSString *)fileName lineNumber:(NSInteger)line description:(NSString *)format, ...
+{
+    va_list args;
+    va_start(args, format);
+    NSString *description = [[NSString alloc] initWithFormat:format arguments:args];
+    va_end(args);
+
+    __atomic_add_fetch(&s_sink, [description length], __ATOMIC_RELAXED);
+}
+
+@end
+
+void RZAssertBenchmarkInstallQuietAssertionHandler(void)
+{
+    NSMutableDictionary *threadDictionary = [[NSThread currentThread] threadDictionary];
+    threadDictionary[NSAssertionHandlerKey] = [[RZAssertBenchmarkAssertionHandler alloc] init];
+}
+
+#pragma mark - Measurement
+
+typedef struct {
+    const char *mode;
+    const char *macro;
+    const char *outcome;
+    const char *logger;
+    NSUInteger threads;
+    uint64_t iterations;
+    double nanosecondsPerCall;
+    double allocationsPerCall;
+} RZAssertBenchmarkResult;
+
+typedef struct {
+    RZAssertBenchmarkBody body;
+    __unsafe_unretained id target;
+    SEL selector;
+    uint64_t iterations;
+    int32_t *readyCount;
+    int32_t *started;
+    uint64_t elapsed;
+    uint64_t allocations;
+} RZAssertBenchmarkRun;
+
+static uint64_t benchmarkNow(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * kNanosecondsPerSecond) + (uint64_t)ts.tv_nsec;
+}
+
+static void *benchmarkRunThread(void *context)
+{
+    RZAssertBenchmarkRun *run = context;
+
+    @autoreleasepool {
+        RZAssertBenchmarkInstallQuietAssertionHandler();
+
+        // Start every thread together, so they contend for the same call sites.
+        __atomic_add_fetch(run->readyCount, 1, __ATOMIC_RELEASE);
+        while ( __atomic_load_n(run->started, __ATOMIC_ACQUIRE) == 0 ) {
+        }
+
+        uint64_t allocations = RZAssertBenchmarkAllocationCount();
+        uint64_t start = benchmarkNow();
+        run->body(run->target, run->selector, run->iterations);
+        run->elapsed = benchmarkNow() - start;
+        run->allocations = RZAssertBenchmarkAllocationCount() - allocations;
+    }
+
+    return NULL;
+}
+
+static void benchmarkRun(RZAssertBenchmarkRun *runs, NSUInteger threadCount)
+{
+    int32_t readyCount = 0;
+    int32_t started = 0;
+
+    for ( NSUInteger i = 0; i < threadCount; i++ ) {
+        runs[i].readyCount = &readyCount;
+        runs[i].started = &started;
+    }
+
+    if ( threadCount == 1 ) {
+        started = 1;
+        benchmarkRunThread(&runs[0]);
+        return;
+    }
+
+    pthread_t threads[threadCount];
+    for ( NSUInteger i = 0; i < threadCount; i++ ) {
+        pthread_create(&threads[i], NULL, benchmarkRunThread, &runs[i]);
+    }
+
+    while ( __atomic_load_n(&readyCount, __ATOMIC_ACQUIRE) < (int32_t)threadCount ) {
+    }
+    __atomic_store_n(&started, 1, __ATOMIC_RELEASE);
+
+    for ( NSUInteger i = 0; i < threadCount; i++ ) {
+        pthread_join(threads[i], NULL);
+    }
+}
+
+// Grows the iteration count until a run takes a tenth of the target, then scales it to the target.
+static uint64_t benchmarkCalibrate(RZAssertBenchmarkBody body, id target, SEL selector, uint64_t targetNanoseconds)
+{
+    uint64_t iterations = 16;
+    uint64_t elapsed = 0;
+
+    while ( YES ) {
+        @autoreleasepool {
+            uint64_t start = benchmarkNow();
+            body(target, selector, iterations);
+            elapsed = benchmarkNow() - start;
+        }
+
+        if ( elapsed >= targetNanoseconds / 10 || iterations >= (1ull << 34) ) {
+            break;
+        }
+        iterations *= 4;
+    }
+
+    uint64_t scaled = (uint64_t)((double)iterations * (double)targetNanoseconds / (double)MAX(elapsed, 1ull));
+    return MAX(scaled, 16ull);
+}
+
+static RZAssertBenchmarkResult benchmarkMeasure(RZAssertBenchmarkSuite suite, id target, const RZAssertBenchmarkCase *benchmarkCase, const char *selectorName, const char *logger, NSUInteger threadCount, uint64_t targetNanoseconds)
+{
+    SEL selector = sel_registerName(selectorName);
+    RZAssertBenchmarkBody body = (RZAssertBenchmarkBody)[target methodForSelector:selector];
+    uint64_t iterations = benchmarkCalibrate(body, target, selector, targetNanoseconds);
+
+    RZAssertBenchmarkRun runs[threadCount];
+    for ( NSUInteger i = 0; i < threadCount; i++ ) {
+        runs[i] = (RZAssertBenchmarkRun){ .body = body, .target = target, .selector = selector, .iterations = iterations };
+    }
+
+    benchmarkRun(runs, threadCount);
+
+    uint64_t elapsed = 0;
+    uint64_t allocations = 0;
+    for ( NSUInteger i = 0; i < threadCount; i++ ) {
+        elapsed += runs[i].elapsed;
+        allocations += runs[i].allocations;
+    }
+
+    double calls = (double)iterations * (double)threadCount;
+
+    RZAssertBenchmarkResult result;
+    result.mode = suite.mode;
+    result.macro = benchmarkCase->name;
+    result.outcome = ( selectorName == benchmarkCase->pass ) ? "pass" : "fail";
+    result.logger = logger;
+    result.threads = threadCount;
+    result.iterations = iterations;
+    result.nanosecondsPerCall = (double)elapsed / calls;
+    result.allocationsPerCall = RZAssertBenchmarkCountsAllocations() ? (double)allocations / calls : -1.0;
+    return result;
+}
+
+#pragma mark - Output
+
+static void benchmarkPrintResult(const RZAssertBenchmarkResult *result)
+{
+    char allocations[32] = "n/a";
+    if ( result->allocationsPerCall >= 0.0 ) {
+        snprintf(allocations, sizeof(allocations), "%.2f", result->allocationsPerCall);
+    }
+
+    printf("%-8s %-44s %-4s %-8s %2lu %10.3f ns %8s allocs\n",
+           result->mode,
+           result->macro,
+           result->outcome,
+           result->logger,
+           (unsigned long)result->threads,
+           result->nanosecondsPerCall,
+           allocations);
+    fflush(stdout);
+}
+
+// Collects the failures of every failing case in a suite, and compares their wire encoding
+// with the flat messages a logging handler would ship.
+static void benchmarkPrintWireEncoding(RZAssertBenchmarkSuite suite, const char *filter)
+{
+    NSMutableArray *failures = [NSMutableArray array];
+    id target = [[suite.targetClass alloc] init];
+
+    [RZAssert configureWithFailureHandler:^(RZAssertFailure *failure) {
+        [failures addObject:failure];
+    }];
+
+    for ( NSUInteger c = 0; c < suite.caseCount; c++ ) {
+        const RZAssertBenchmarkCase *benchmarkCase = &suite.cases[c];
+        if ( benchmarkCase->fail == NULL || (filter != NULL && strstr(benchmarkCase->name, filter) == NULL) ) {
+            continue;
+        }
+
+        SEL selector = sel_registerName(benchmarkCase->fail);
+        RZAssertBenchmarkBody body = (RZAssertBenchmarkBody)[target methodForSelector:selector];
+        body(target, selector, 16);
+    }
+
+    [RZAssert removeFailureHandler];
+
+    NSUInteger messageBytes = 0;
+    for ( RZAssertFailure *failure in failures ) {
+        messageBytes += [failure.message lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+    }
+    NSUInteger encodedBytes = [[[[RZAssertWireEncoder alloc] init] encodeFailures:failures] length];
+
+    printf("%-8s wire encoding: %lu failures, %lu message bytes, %lu encoded bytes (%.1f%%)\n",
+           suite.mode,
+           (unsigned long)failures.count,
+           (unsigned long)messageBytes,
+           (unsigned long)encodedBytes,
+           100.0 * (double)encodedBytes / (double)MAX(messageBytes, 1ul));
+    fflush(stdout);
+}
+
+static BOOL benchmarkWriteJSON(const char *path, const RZAssertBenchmarkResult *results, NSUInteger count)
+{
+    FILE *file = fopen(path, "w");
+    if ( file == NULL ) {
+        return NO;
+    }
+
+#if defined(__APPLE__)
+    const char *platform = "darwin";
+#else
+    const char *platform = "linux";
+#endif
+
+    fprintf(file, "{\n  \"benchmark\": \"RZAssert\",\n  \"format\": 2,\n  \"platform\": \"%s\",\n  \"results\": [\n", platform);
+
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        const RZAssertBenchmarkResult *result = &results[i];
+
+        fprintf(file, "    {\"mode\": \"%s\", \"macro\": \"%s\", \"outcome\": \"%s\", \"logger\": \"%s\", \"threads\": %lu, \"iterations\": %llu, \"ns_per_call\": %.4f, \"allocations_per_call\": ",
+                result->mode,
+                result->macro,
+                result->outcome,
+                result->logger,
+                (unsigned long)result->threads,
+                (unsigned long long)result->iterations,
+                result->nanosecondsPerCall);
+
+        if ( result->allocationsPerCall >= 0.0 ) {
+            fprintf(file, "%.4f}", result->allocationsPerCall);
+        }
+        else {
+            fprintf(file, "null}");
+        }
+
+        fprintf(file, "%s\n", ( i + 1 < count ) ? "," : "");
+    }
+
+    fprintf(file, "  ]\n}\n");
+
+    return ( fclose(file) == 0 );
+}
+
+#pragma mark - Main
+
+int main(int argc, const char *argv[])
+{
+    @autoreleasepool {
+        const char *outputPath = NULL;
+        const char *filter = NULL;
+        NSUInteger contendedThreads = MIN(MAX([[NSProcessInfo processInfo] activeProcessorCount], 2ul), 8ul);
+        uint64_t targetNanoseconds = 50 * kNanosecondsPerMillisecond;
+
+        for ( int i = 1; i < argc; i++ ) {
+            if ( strcmp(argv[i], "--output") == 0 && i + 1 < argc ) {
+                outputPath = argv[++i];
+            }
+            else if ( strcmp(argv[i], "--threads") == 0 && i + 1 < argc ) {
+                contendedThreads = (NSUInteger)MAX(atoi(argv[++i]), 2);
+            }
+            else if ( strcmp(argv[i], "--time") == 0 && i + 1 < argc ) {
+                targetNanoseconds = (uint64_t)MAX(atoi(argv[++i]), 1) * kNanosecondsPerMillisecond;
+            }
+            else if ( strcmp(argv[i], "--filter") == 0 && i + 1 < argc ) {
+                filter = argv[++i];
+            }
+            else {
+                fprintf(stderr, "usage: %s [--output PATH] [--threads N] [--time MS] [--filter TEXT]\n", argv[0]);
+                return 2;
+            }
+        }
+
+        RZAssertBenchmarkInstallQuietAssertionHandler();
+        [RZAssert disableCategories:RZAssertBenchmarkDisabledCategory];
+
+        void (^loggingHandler)(NSString *) = ^(NSString *message) {
+            __atomic_add_fetch(&s_sink, [message length], __ATOMIC_RELAXED);
+        };
+
+        RZAssertBenchmarkSuite suites[] = { RZAssertBenchmarkSuiteEnabled(), RZAssertBenchmarkSuiteDisabled() };
+        NSUInteger threadCounts[] = { 1, contendedThreads };
+        void (^bufferedLoggingHandler)(const RZAssertMessageBuffer *) = ^(const RZAssertMessageBuffer *buffer) {
+            __atomic_add_fetch(&s_sink, buffer->length, __ATOMIC_RELAXED);
+        };
+
+        const char *loggers[] = { "none", "logging", "buffered" };
+
+        NSMutableData *resultData = [NSMutableData data];
+
+        for ( NSUInteger s = 0; s < sizeof(suites) / sizeof(suites[0]); s++ ) {
+            RZAssertBenchmarkSuite suite = suites[s];
+            id target = [[suite.targetClass alloc] init];
+
+            for ( NSUInteger l = 0; l < sizeof(loggers) / sizeof(loggers[0]); l++ ) {
+                [RZAssert removeLoggingHandler];
+                [RZAssert removeBufferedLoggingHandler];
+
+                if ( strcmp(loggers[l], "logging") == 0 ) {
+                    [RZAssert configureWithLoggingHandler:loggingHandler];
+                }
+                else if ( strcmp(loggers[l], "buffered") == 0 ) {
+                    [RZAssert configureWithBufferedLoggingHandler:bufferedLoggingHandler];
+                }
+
+                for ( NSUInteger t = 0; t < sizeof(threadCounts) / sizeof(threadCounts[0]); t++ ) {
+                    for ( NSUInteger c = 0; c < suite.caseCount; c++ ) {
+                        const RZAssertBenchmarkCase *benchmarkCase = &suite.cases[c];
+                        if ( filter != NULL && strstr(benchmarkCase->name, filter) == NULL ) {
+                            continue;
+                        }
+
+                        const char *selectors[] = { benchmarkCase->pass, benchmarkCase->fail };
+                        for ( NSUInteger o = 0; o < sizeof(selectors) / sizeof(selectors[0]); o++ ) {
+                            if ( selectors[o] == NULL ) {
+                                continue;
+                            }
+
+                            RZAssertBenchmarkResult result = benchmarkMeasure(suite, target, benchmarkCase, selectors[o], loggers[l], threadCounts[t], targetNanoseconds);
+                            benchmarkPrintResult(&result);
+                            [resultData appendBytes:&result length:sizeof(result)];
+                        }
+                    }
+                }
+            }
+        }
+
+        [RZAssert removeLoggingHandler];
+        [RZAssert removeBufferedLoggingHandler];
+
+        // Only blocked assertions report failures to handlers.
+        benchmarkPrintWireEncoding(RZAssertBenchmarkSuiteDisabled(), filter);
+
+        if ( outputPath != NULL ) {
+            NSUInteger count = [resultData length] / sizeof(RZAssertBenchmarkResult);
+            if ( !benchmarkWriteJSON(outputPath, [resultData bytes], count) ) {
+                fprintf(stderr, "could not write %s\n", outputPath);
+                return 1;
+            }
+        }
+    }
+
+    return 0;
+}
@@ -7,12 +7,24 @@
 //
 
 #import "RZAssert.h"
+#import "RZAssertBatchLogger.h"
+#import "RZAssertCrashLogFormat.h"
+
+#import <objc/runtime.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 static NSString* const kNilString = nil;
 static NSString* const kEmptyString = @"";
 static NSString* const kNonEmptyString = @"non-empty string";
 static NSString* const kTestMessage = @"test message";
 
+// Blocks can't capture arrays, so the buffer assertion tests share these.
+static double sSamples[40];
+static float sFloatSamples[40];
+static int sIntSamples[40];
+
 typedef void (^AssertionBlock)(void);
 typedef void (^LoggingAssertionBlock)(NSString *message);
 
@@ -125,6 +137,891 @@ describe(@"+removeLoggingHandler works.", ^{
 
 });
 
+describe(@"rate limiting", ^{
+
+    afterEach(^{
+        [RZAssert removeRateLimit];
+    });
+
+    it(@"logs every failure by default", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        NSUInteger loggedCount = 0;
+
+        for ( NSUInteger i = 0; i < 10; i++ ) {
+            loggedCount += RZAssertSiteShouldLog(&site) ? 1 : 0;
+        }
+
+        expect(loggedCount).to.equal(10);
+    });
+
+    it(@"logs only the first failures at a site in each interval, then a summary", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        NSUInteger loggedCount = 0;
+        __block NSString *summary = nil;
+
+        [RZAssert configureWithLoggingHandler:^(NSString *message) {
+            summary = message;
+        }];
+        [RZAssert configureRateLimitWithMaximumMessages:3 interval:0.2];
+
+        for ( NSUInteger i = 0; i < 10; i++ ) {
+            loggedCount += RZAssertSiteShouldLog(&site) ? 1 : 0;
+        }
+
+        expect(loggedCount).to.equal(3);
+        expect(site.suppressedCount).to.equal(7);
+
+        NSString *expectedSummary = [NSString stringWithFormat:@"**** Assertion failures suppressed **** \nsuppressed 7 repeats of %@:%d in the last 0.2s", [@(site.file) lastPathComponent], site.line];
+        expect(summary).will.equal(expectedSummary);
+        expect(site.suppressedCount).to.equal(0);
+
+        // The next window starts counting afresh.
+        expect(RZAssertSiteShouldLog(&site)).to.beTruthy();
+    });
+
+    it(@"rejects a maximum it can't count to", ^{
+        expect(^{
+            [RZAssert configureRateLimitWithMaximumMessages:NSUIntegerMax interval:1.0];
+        }).to.raise(NSInvalidArgumentException);
+    });
+
+});
+
+describe(@"failure handler", ^{
+
+    afterEach(^{
+        [RZAssert removeFailureHandler];
+    });
+
+    it(@"builds the same message as eager formatting", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        __block RZAssertFailure *reportedFailure = nil;
+        char cString[] = "c string";
+
+        [RZAssert configureWithFailureHandler:^(RZAssertFailure *failure) {
+            reportedFailure = failure;
+        }];
+
+        RZAssertReportFailure(&site, @"%d %5.2f %s %@ %lu %*d %c 100%%", -3, 3.14159, cString, kNonEmptyString, (unsigned long)42, 4, 7, 'x');
+
+        // The C string was copied, so changing it afterward must not change the message.
+        cString[0] = 'X';
+
+        NSString *expected = [NSString stringWithFormat:@"%d %5.2f %s %@ %lu %*d %c 100%%", -3, 3.14159, "c string", kNonEmptyString, (unsigned long)42, 4, 7, 'x'];
+
+        expect(reportedFailure.formattedDetail).to.equal(expected);
+        expect(reportedFailure.site).to.equal(&site);
+        expect(reportedFailure.arguments.count).to.equal(8);
+        expect([reportedFailure.message rangeOfString:expected].location).notTo.equal(NSNotFound);
+    });
+
+#if defined(NS_BLOCK_ASSERTIONS)
+    it(@"describes the failing call site", ^{
+        __block RZAssertFailure *reportedFailure = nil;
+
+        [RZAssert configureWithFailureHandler:^(RZAssertFailure *failure) {
+            reportedFailure = failure;
+        }];
+
+        RZCASSERT_TRUE(NO);
+
+        expect(reportedFailure).notTo.beNil();
+        expect(strcmp(reportedFailure.site->kind, "RZCASSERT_TRUE")).to.equal(0);
+        expect(reportedFailure.site->line).to.beGreaterThan(0);
+    });
+#endif
+
+});
+
+describe(@"sinks", ^{
+
+    it(@"delivers each failure to every sink whose filter accepts it", ^{
+        static RZAssertSite networkingSite = RZASSERT_SITE_INITIALIZER("networking");
+        static RZAssertSite storageSite = RZASSERT_SITE_INITIALIZER("storage");
+        NSMutableArray *allFailures = [NSMutableArray array];
+        NSMutableArray *networkingFailures = [NSMutableArray array];
+
+        id allSink = [RZAssert addSinkWithFilter:nil handler:^(RZAssertFailure *failure) {
+            [allFailures addObject:failure];
+        }];
+        id networkingSink = [RZAssert addSinkWithFilter:^BOOL(RZAssertFailure *failure) {
+            return ( failure.site == &networkingSite );
+        } handler:^(RZAssertFailure *failure) {
+            [networkingFailures addObject:failure];
+        }];
+
+        RZAssertReportFailure(&networkingSite, @"%@", kTestMessage);
+        RZAssertReportFailure(&storageSite, @"%@", kTestMessage);
+
+        [RZAssert removeSink:allSink];
+        [RZAssert removeSink:networkingSink];
+
+        RZAssertReportFailure(&networkingSite, @"%@", kTestMessage);
+
+        expect(allFailures.count).to.equal(2);
+        expect(networkingFailures.count).to.equal(1);
+    });
+
+    it(@"keeps delivering after sinks throw", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        __block BOOL shouldThrow = YES;
+        __block NSUInteger deliveredCount = 0;
+
+        id sink = [RZAssert addSinkWithFilter:nil handler:^(__unused RZAssertFailure *failure) {
+            if ( shouldThrow ) {
+                [NSException raise:NSInternalInconsistencyException format:@"%@", kTestMessage];
+            }
+            deliveredCount++;
+        }];
+
+        // More throws than a thread has hazard slots.
+        NSUInteger thrownCount = 0;
+        for ( NSUInteger i = 0; i < 8; i++ ) {
+            @try {
+                RZAssertReportFailure(&site, @"%@", kTestMessage);
+            }
+            @catch (__unused NSException *e) {
+                thrownCount++;
+            }
+        }
+
+        shouldThrow = NO;
+        RZAssertReportFailure(&site, @"%@", kTestMessage);
+        [RZAssert removeSink:sink];
+
+        expect(thrownCount).to.equal(8);
+        expect(deliveredCount).to.equal(1);
+    });
+
+    it(@"can be replaced while other threads deliver failures", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        __block int32_t deliveredCount = 0;
+        __block int32_t stop = 0;
+
+        id countingSink = [RZAssert addSinkWithFilter:nil handler:^(__unused RZAssertFailure *failure) {
+            __atomic_add_fetch(&deliveredCount, 1, __ATOMIC_RELAXED);
+        }];
+
+        dispatch_group_t group = dispatch_group_create();
+        for ( NSUInteger i = 0; i < 4; i++ ) {
+            dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                while ( !__atomic_load_n(&stop, __ATOMIC_ACQUIRE) ) {
+                    RZAssertReportFailure(&site, @"%@", kTestMessage);
+                }
+            });
+        }
+
+        // Every replacement retires a list that the delivering threads may still hold.
+        for ( NSUInteger i = 0; i < 1000; i++ ) {
+            id sink = [RZAssert addSinkWithFilter:nil handler:^(__unused RZAssertFailure *failure) {
+            }];
+            [RZAssert removeSink:sink];
+        }
+
+        __atomic_store_n(&stop, 1, __ATOMIC_RELEASE);
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+        [RZAssert removeSink:countingSink];
+
+        expect(deliveredCount).to.beGreaterThan(0);
+    });
+
+});
+
+describe(@"call site registry", ^{
+
+    it(@"lists registered call sites", ^{
+        RZASSERT_DECLARE_SITE(registeredSite, "test", "registered expression")
+        __block BOOL found = NO;
+
+        [RZAssert enumerateCallSitesUsingBlock:^(const RZAssertSite *site) {
+            found = found || ( site == &registeredSite );
+        }];
+
+        expect(found).to.beTruthy();
+        expect(strcmp(registeredSite.expression, "registered expression")).to.equal(0);
+        expect(strcmp(registeredSite.file, __FILE__)).to.equal(0);
+    });
+
+});
+
+describe(@"statistics", ^{
+
+    beforeEach(^{
+        [RZAssert enableStatistics];
+    });
+
+    afterEach(^{
+        [RZAssert disableStatistics];
+    });
+
+    RZAssertSiteStatistics *(^statisticsForSite)(const RZAssertSite *) = ^RZAssertSiteStatistics *(const RZAssertSite *site) {
+        for ( RZAssertSiteStatistics *statistics in [RZAssert statisticsSnapshot] ) {
+            if ( statistics.site == site ) {
+                return statistics;
+            }
+        }
+        return nil;
+    };
+
+    RZAssertSiteStatistics *(^statisticsForLine)(NSUInteger) = ^RZAssertSiteStatistics *(NSUInteger line) {
+        for ( RZAssertSiteStatistics *statistics in [RZAssert statisticsSnapshot] ) {
+            if ( statistics.site->line == line && strcmp(statistics.site->file, __FILE__) == 0 ) {
+                return statistics;
+            }
+        }
+        return nil;
+    };
+
+    it(@"counts evaluations and failures from every thread", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+
+        dispatch_apply(8, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t iteration) {
+            for ( NSUInteger i = 0; i < 1000; i++ ) {
+                RZAssertStatisticsRecord(&site, ( i % 10 == 0 ));
+            }
+        });
+
+        RZAssertSiteStatistics *statistics = statisticsForSite(&site);
+        expect(statistics.evaluationCount).to.equal(8000);
+        expect(statistics.failureCount).to.equal(800);
+    });
+
+    it(@"keeps the counts of threads that have exited", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        NSThread *thread = [[NSThread alloc] initWithTarget:[NSBlockOperation blockOperationWithBlock:^{
+            RZAssertStatisticsRecord(&site, YES);
+        }] selector:@selector(start) object:nil];
+
+        [thread start];
+        while ( !thread.isFinished ) {
+            [NSThread sleepForTimeInterval:0.01];
+        }
+
+        RZAssertSiteStatistics *statistics = statisticsForSite(&site);
+        expect(statistics.evaluationCount).to.equal(1);
+        expect(statistics.failureCount).to.equal(1);
+    });
+
+    it(@"counts assertion macros", ^{
+        __block NSUInteger line = 0;
+        for ( NSUInteger i = 0; i < 3; i++ ) {
+            testAssertionWithBlock(^{
+                line = __LINE__; RZASSERT_TRUE(i != 1);
+            });
+        }
+
+        RZAssertSiteStatistics *statistics = statisticsForLine(line);
+        expect(statistics.evaluationCount).to.equal(3);
+        expect(statistics.failureCount).to.equal(1);
+    });
+
+    it(@"counts only the executions a sampled assertion evaluates", ^{
+        __block NSUInteger neverLine = 0;
+        __block NSUInteger alwaysLine = 0;
+        for ( NSUInteger i = 0; i < 10; i++ ) {
+            testAssertionWithBlock(^{
+                neverLine = __LINE__; RZCASSERT_SAMPLED(0.0, YES);
+                alwaysLine = __LINE__; RZCASSERT_SAMPLED(1.0, YES);
+            });
+        }
+
+        expect(statisticsForLine(neverLine)).to.beNil();
+        expect(statisticsForLine(alwaysLine).evaluationCount).to.equal(10);
+    });
+
+    it(@"doesn't count while disabled", ^{
+        __block NSUInteger line = 0;
+        [RZAssert disableStatistics];
+
+        testAssertionWithBlock(^{
+            line = __LINE__; RZASSERT_TRUE(NO);
+        });
+
+        expect(statisticsForLine(line)).to.beNil();
+    });
+
+});
+
+describe(@"profiling", ^{
+
+    beforeEach(^{
+        [RZAssert enableProfiling];
+    });
+
+    afterEach(^{
+        [RZAssert disableProfiling];
+    });
+
+    BOOL (^slowCondition)(BOOL) = ^BOOL(BOOL result) {
+        [NSThread sleepForTimeInterval:0.002];
+        return result;
+    };
+
+    it(@"reports the most expensive sites first", ^{
+        __block NSUInteger slowLine = 0;
+        for ( NSUInteger i = 0; i < 4; i++ ) {
+            testAssertionWithBlock(^{
+                RZASSERT_TRUE(i < 4);
+            });
+            testAssertionWithBlock(^{
+                slowLine = __LINE__; RZASSERT_TRUE(slowCondition(i != 3));
+            });
+        }
+
+        RZAssertSiteProfile *profile = [[RZAssert mostExpensiveSitesWithLimit:1] firstObject];
+        expect([RZAssert mostExpensiveSitesWithLimit:1].count).to.equal(1);
+        expect(profile.site->line).to.equal(slowLine);
+        expect(strcmp(profile.site->file, __FILE__)).to.equal(0);
+        expect(profile.conditionCount).to.equal(4);
+        expect(profile.conditionNanoseconds).to.beGreaterThanOrEqualTo(8 * NSEC_PER_MSEC);
+        expect([profile conditionNanosecondsAtPercentile:50]).to.beGreaterThanOrEqualTo(2 * NSEC_PER_MSEC);
+        expect([[profile.conditionHistogram valueForKeyPath:@"@sum.self"] unsignedLongLongValue]).to.equal(4);
+    });
+
+    it(@"doesn't time sites while disabled", ^{
+        __block NSUInteger line = 0;
+        [RZAssert disableProfiling];
+
+        testAssertionWithBlock(^{
+            line = __LINE__; RZASSERT_TRUE(YES);
+        });
+
+        for ( RZAssertSiteProfile *profile in [RZAssert mostExpensiveSitesWithLimit:RZASSERT_PROFILER_CAPACITY] ) {
+            expect(profile.site->line == line && strcmp(profile.site->file, __FILE__) == 0).to.beFalsy();
+        }
+    });
+
+});
+
+describe(@"crash log", ^{
+
+    it(@"writes failures into the mapped file", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        NSString *path = [NSTemporaryDirectory() stringByAppendingPathComponent:[[NSUUID UUID] UUIDString]];
+        NSError *error = nil;
+
+        BOOL enabled = [RZAssert enableCrashLogAtPath:path size:32 * 1024 error:&error];
+        RZAssertReportFailure(&site, @"%@", kTestMessage);
+        [RZAssert disableCrashLog];
+
+        NSData *contents = [NSData dataWithContentsOfFile:path];
+        const RZAssertCrashLogHeader *header = contents.bytes;
+        const RZAssertCrashLogRecord *record = (const RZAssertCrashLogRecord *)((const uint8_t *)contents.bytes + RZASSERT_CRASH_LOG_HEADER_SIZE);
+        NSString *detail = [[NSString alloc] initWithBytes:(const char *)(record + 1) + record->kindLength + record->fileLength + record->functionLength length:record->detailLength encoding:NSUTF8StringEncoding];
+
+        expect(enabled).to.beTruthy();
+        expect(error).to.beNil();
+        expect(header->magic).to.equal(RZASSERT_CRASH_LOG_MAGIC);
+        expect(header->writeOffset).to.equal(record->length);
+        expect(record->magic).to.equal(RZASSERT_CRASH_LOG_RECORD_MAGIC);
+        expect(record->line).to.equal(site.line);
+        expect(detail).to.equal(kTestMessage);
+
+        [[NSFileManager defaultManager] removeItemAtPath:path error:NULL];
+    });
+
+});
+
+describe(@"breadcrumbs", ^{
+
+    NSString *(^readAll)(int) = ^NSString *(int fileDescriptor) {
+        NSMutableData *data = [NSMutableData data];
+        uint8_t bytes[1024];
+        ssize_t length;
+        while ( (length = read(fileDescriptor, bytes, sizeof(bytes))) > 0 ) {
+            [data appendBytes:bytes length:(NSUInteger)length];
+        }
+        close(fileDescriptor);
+        return [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding];
+    };
+
+    afterEach(^{
+        [RZAssert disableBreadcrumbs];
+    });
+
+    it(@"keeps only the most recent failures", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        int fileDescriptors[2];
+        pipe(fileDescriptors);
+
+        [RZAssert enableBreadcrumbsWithCapacity:4];
+        for ( NSUInteger i = 0; i < 6; i++ ) {
+            RZAssertReportFailure(&site, @"breadcrumb %lu", (unsigned long)i);
+        }
+
+        expect([RZAssert writeBreadcrumbsToFileDescriptor:fileDescriptors[1]]).to.equal(4);
+        close(fileDescriptors[1]);
+
+        NSString *dump = readAll(fileDescriptors[0]);
+        expect(dump).notTo.contain(@"breadcrumb 1");
+        expect(dump).to.contain(@"breadcrumb 2");
+        expect(dump).to.contain(@"breadcrumb 5");
+        expect(dump).to.contain([NSString stringWithFormat:@"%s:%d", site.file, site.line]);
+    });
+
+    it(@"dumps the ring when a child process is killed", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        int fileDescriptors[2];
+        pipe(fileDescriptors);
+
+        [RZAssert enableBreadcrumbsWithCapacity:8];
+        RZAssertReportFailure(&site, @"%@", kTestMessage);
+        BOOL installed = [RZAssert dumpBreadcrumbsOnCrashToFileDescriptor:fileDescriptors[1]];
+
+        pid_t child = fork();
+        if ( child == 0 ) {
+            // Only async-signal-safe calls in the child.
+            for ( ;; ) {
+                pause();
+            }
+        }
+
+        [RZAssert removeBreadcrumbCrashHandlers];
+        close(fileDescriptors[1]);
+        kill(child, SIGSEGV);
+
+        NSString *dump = readAll(fileDescriptors[0]);
+        int status = 0;
+        waitpid(child, &status, 0);
+
+        expect(installed).to.beTruthy();
+        expect(WIFSIGNALED(status)).to.beTruthy();
+        expect(WTERMSIG(status)).to.equal(SIGSEGV);
+        expect(dump).to.beginWith(@"RZAssert breadcrumbs:\n");
+        expect(dump).to.contain(kTestMessage);
+    });
+
+});
+
+describe(@"wire encoding", ^{
+
+    __block NSMutableArray *failures = nil;
+
+    beforeEach(^{
+        failures = [NSMutableArray array];
+        [RZAssert configureWithFailureHandler:^(RZAssertFailure *failure) {
+            [failures addObject:failure];
+        }];
+    });
+
+    afterEach(^{
+        [RZAssert removeFailureHandler];
+    });
+
+    it(@"round-trips failures", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        char cString[] = "c string";
+
+        RZAssertReportFailure(&site, @"%d %5.2f %s %@ %lu %*d %c %p %@ 100%%", -3, 3.14159, cString, kNonEmptyString, (unsigned long)42, 4, 7, 'x', (void *)0x1234, nil);
+        RZAssertReportFailure(&site, @"%llu %g", ULLONG_MAX, -0.5);
+        [RZAssert logMessage:@"100% literal %d"];
+
+        RZAssertWireEncoder *encoder = [[RZAssertWireEncoder alloc] init];
+        RZAssertWireDecoder *decoder = [[RZAssertWireDecoder alloc] init];
+        NSError *error = nil;
+
+        // Split across chunks, so the second relies on the first's dictionary.
+        NSArray *decoded = [decoder decodeData:[encoder encodeFailures:[failures subarrayWithRange:NSMakeRange(0, 1)]] error:&error];
+        decoded = [decoded arrayByAddingObjectsFromArray:[decoder decodeData:[encoder encodeFailures:[failures subarrayWithRange:NSMakeRange(1, 2)]] error:&error]];
+
+        expect(error).to.beNil();
+        expect(decoded.count).to.equal(3);
+        for ( NSUInteger i = 0; i < decoded.count; i++ ) {
+            RZAssertFailure *original = failures[i];
+            RZAssertFailure *copy = decoded[i];
+
+            expect(copy.message).to.equal(original.message);
+            expect(copy.threadID).to.equal(original.threadID);
+            expect(copy.timestamp).to.beCloseToWithin(original.timestamp, 0.000001);
+        }
+        expect(strcmp([decoded[0] site]->file, site.file)).to.equal(0);
+        expect([decoded[0] site]).to.equal([decoded[1] site]);
+    });
+
+    it(@"rejects malformed data", ^{
+        NSError *error = nil;
+        NSData *data = [NSData dataWithBytes:RZASSERT_WIRE_MAGIC "\x03\x05" length:6];
+
+        expect([[[RZAssertWireDecoder alloc] init] decodeData:data error:&error]).to.beNil();
+        expect(error.domain).to.equal(RZAssertWireErrorDomain);
+    });
+
+    it(@"is much smaller than the messages", ^{
+        static RZAssertSite sites[4] = {
+            RZASSERT_SITE_INITIALIZER("RZASSERT_EQUAL"),
+            RZASSERT_SITE_INITIALIZER("RZASSERT_NOT_NIL"),
+            RZASSERT_SITE_INITIALIZER("RZASSERT_TRUE"),
+            RZASSERT_SITE_INITIALIZER("RZASSERT_IN_RANGE"),
+        };
+
+        for ( NSUInteger i = 0; i < 1000; i++ ) {
+            RZAssertReportFailure(&sites[i % 4], @"**** Unexpected Value **** \nExpected: %ld \nActual: %ld \nSelf: \"%s\"", (long)i, (long)(i * 7), "-[RZExampleViewController viewDidLoad]");
+        }
+
+        NSUInteger messageBytes = 0;
+        for ( RZAssertFailure *failure in failures ) {
+            messageBytes += [failure.message lengthOfBytesUsingEncoding:NSUTF8StringEncoding];
+        }
+        NSData *encoded = [[[RZAssertWireEncoder alloc] init] encodeFailures:failures];
+
+        expect(encoded.length * 3).to.beLessThan(messageBytes);
+    });
+
+});
+
+describe(@"backtraces", ^{
+
+    __block NSMutableArray *failures = nil;
+
+    beforeEach(^{
+        failures = [NSMutableArray array];
+        [RZAssert configureWithFailureHandler:^(RZAssertFailure *failure) {
+            [failures addObject:failure];
+        }];
+        [RZAssert enableBacktraces];
+    });
+
+    afterEach(^{
+        [RZAssert disableBacktraces];
+        [RZAssert removeFailureHandler];
+    });
+
+    it(@"shares identical stacks", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+
+        for ( NSUInteger i = 0; i < 2; i++ ) {
+            RZAssertReportFailure(&site, @"%@", kTestMessage);
+        }
+        RZAssertReportFailure(&site, @"%@", kTestMessage);
+
+        RZAssertBacktrace *backtrace = [failures[0] backtrace];
+        expect(backtrace).notTo.beNil();
+        expect(backtrace.count).to.beGreaterThan(0);
+        expect([failures[1] backtrace]).to.beIdenticalTo(backtrace);
+        expect([failures[2] backtrace]).notTo.beIdenticalTo(backtrace);
+    });
+
+    it(@"symbolicates later", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        RZAssertReportFailure(&site, @"%@", kTestMessage);
+
+        RZAssertBacktrace *backtrace = [failures[0] backtrace];
+        dispatch_semaphore_t symbolicated = dispatch_semaphore_create(0);
+        __block NSArray *symbols = nil;
+
+        expect(backtrace.symbols).to.beNil();
+        [backtrace symbolicateWithCompletion:^(NSArray *result) {
+            symbols = result;
+            dispatch_semaphore_signal(symbolicated);
+        }];
+        dispatch_semaphore_wait(symbolicated, DISPATCH_TIME_FOREVER);
+
+        expect(symbols.count).to.equal(backtrace.count);
+        expect(backtrace.symbols).to.equal(symbols);
+    });
+
+    it(@"isn't captured while disabled", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        [RZAssert disableBacktraces];
+
+        RZAssertReportFailure(&site, @"%@", kTestMessage);
+
+        expect([failures[0] backtrace]).to.beNil();
+    });
+
+});
+
+describe(@"asynchronous logging", ^{
+
+    afterEach(^{
+        [RZAssert disableAsynchronousLogging];
+    });
+
+    it(@"delivers queued messages in order on another thread", ^{
+        NSMutableArray *loggedMessages = [NSMutableArray array];
+        __block BOOL deliveredOnCallingThread = NO;
+        NSThread *callingThread = [NSThread currentThread];
+
+        [RZAssert configureWithLoggingHandler:^(NSString *message) {
+            [loggedMessages addObject:message];
+            deliveredOnCallingThread = deliveredOnCallingThread || ([NSThread currentThread] == callingThread);
+        }];
+        [RZAssert enableAsynchronousLoggingWithCapacity:16 backpressurePolicy:RZAssertBackpressurePolicyBlock];
+
+        for ( NSUInteger i = 0; i < 100; i++ ) {
+            [RZAssert logMessage:[NSString stringWithFormat:@"%lu", (unsigned long)i]];
+        }
+
+        // Disabling delivers everything still queued.
+        [RZAssert disableAsynchronousLogging];
+
+        expect(loggedMessages.count).to.equal(100);
+        expect(loggedMessages.firstObject).to.equal(@"0");
+        expect(loggedMessages.lastObject).to.equal(@"99");
+        expect(deliveredOnCallingThread).to.beFalsy();
+    });
+
+    it(@"delivers every message from producers blocked when it stops", ^{
+        dispatch_semaphore_t handlerMayReturn = dispatch_semaphore_create(0);
+        __block int32_t loggedCount = 0;
+
+        [RZAssert configureWithLoggingHandler:^(__unused NSString *message) {
+            dispatch_semaphore_wait(handlerMayReturn, DISPATCH_TIME_FOREVER);
+            __atomic_add_fetch(&loggedCount, 1, __ATOMIC_RELAXED);
+        }];
+        [RZAssert enableAsynchronousLoggingWithCapacity:2 backpressurePolicy:RZAssertBackpressurePolicyBlock];
+
+        // More producers than the ring holds, so some are still blocked after the final drain.
+        dispatch_group_t producers = dispatch_group_create();
+        for ( NSUInteger i = 0; i < 8; i++ ) {
+            dispatch_group_async(producers, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [RZAssert logMessage:kTestMessage];
+            });
+        }
+        [NSThread sleepForTimeInterval:0.1];
+
+        dispatch_group_t stopping = dispatch_group_create();
+        dispatch_group_async(stopping, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+            [RZAssert disableAsynchronousLogging];
+        });
+        [NSThread sleepForTimeInterval:0.1];
+
+        for ( NSUInteger i = 0; i < 8; i++ ) {
+            dispatch_semaphore_signal(handlerMayReturn);
+        }
+
+        long producersTimedOut = dispatch_group_wait(producers, dispatch_time(DISPATCH_TIME_NOW, 5 * NSEC_PER_SEC));
+        dispatch_group_wait(stopping, DISPATCH_TIME_FOREVER);
+
+        expect(producersTimedOut).to.equal(0);
+        expect(loggedCount).to.equal(8);
+    });
+
+    it(@"counts messages dropped when the queue is full", ^{
+        dispatch_semaphore_t handlerMayReturn = dispatch_semaphore_create(0);
+        __block NSUInteger loggedCount = 0;
+
+        [RZAssert configureWithLoggingHandler:^(__unused NSString *message) {
+            dispatch_semaphore_wait(handlerMayReturn, DISPATCH_TIME_FOREVER);
+            loggedCount++;
+        }];
+        [RZAssert enableAsynchronousLoggingWithCapacity:4 backpressurePolicy:RZAssertBackpressurePolicyDropNewest];
+
+        for ( NSUInteger i = 0; i < 20; i++ ) {
+            [RZAssert logMessage:kTestMessage];
+        }
+
+        uint64_t droppedCount = [RZAssert droppedMessageCount];
+
+        for ( NSUInteger i = 0; i < 20; i++ ) {
+            dispatch_semaphore_signal(handlerMayReturn);
+        }
+        [RZAssert disableAsynchronousLogging];
+
+        expect(droppedCount).to.beGreaterThan(0);
+        expect(loggedCount + droppedCount).to.equal(20);
+    });
+
+});
+
+describe(@"batch logging", ^{
+
+    afterEach(^{
+        [RZAssert removeBatchLoggingHandler];
+    });
+
+    it(@"delivers a thread's messages in order when its buffer fills", ^{
+        NSMutableArray *batches = [NSMutableArray array];
+        [RZAssert configureWithBatchLoggingHandler:^(NSArray *messages) {
+            [batches addObject:messages];
+        } maximumBatchSize:3 flushInterval:3600];
+
+        for ( NSUInteger i = 0; i < 3; i++ ) {
+            [RZAssert logMessage:[NSString stringWithFormat:@"%lu", (unsigned long)i]];
+        }
+
+        // Waits for the full batch, which is delivered asynchronously.
+        [RZAssert flush];
+
+        expect(batches.count).to.equal(1);
+        expect(batches.firstObject).to.equal(@[@"0", @"1", @"2"]);
+    });
+
+    it(@"delivers partial buffers from every thread on flush", ^{
+        NSMutableArray *loggedMessages = [NSMutableArray array];
+        [RZAssert configureWithBatchLoggingHandler:^(NSArray *messages) {
+            [loggedMessages addObjectsFromArray:messages];
+        } maximumBatchSize:64 flushInterval:3600];
+
+        [RZAssert logMessage:kTestMessage];
+
+        dispatch_group_t group = dispatch_group_create();
+        for ( NSUInteger i = 0; i < 4; i++ ) {
+            dispatch_group_async(group, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+                [RZAssert logMessage:kNonEmptyString];
+            });
+        }
+        dispatch_group_wait(group, DISPATCH_TIME_FOREVER);
+
+        expect(loggedMessages.count).to.equal(0);
+
+        [RZAssert flush];
+
+        expect(loggedMessages.count).to.equal(5);
+        expect(loggedMessages).to.contain(kTestMessage);
+    });
+
+    it(@"delivers buffered messages on the flush interval", ^{
+        __block NSUInteger loggedCount = 0;
+        [RZAssert configureWithBatchLoggingHandler:^(NSArray *messages) {
+            loggedCount += messages.count;
+        } maximumBatchSize:64 flushInterval:0.05];
+
+        [RZAssert logMessage:kTestMessage];
+
+        expect(loggedCount).will.equal(1);
+    });
+
+    it(@"delivers each message to the handler it was logged through when reconfigured", ^{
+        NSMutableArray *firstMessages = [NSMutableArray array];
+        NSMutableArray *secondMessages = [NSMutableArray array];
+
+        [RZAssert configureWithBatchLoggingHandler:^(NSArray *messages) {
+            [firstMessages addObjectsFromArray:messages];
+        } maximumBatchSize:64 flushInterval:3600];
+
+        [RZAssert logMessage:kTestMessage];
+
+        [RZAssert configureWithBatchLoggingHandler:^(NSArray *messages) {
+            [secondMessages addObjectsFromArray:messages];
+        } maximumBatchSize:64 flushInterval:3600];
+
+        [RZAssert logMessage:kNonEmptyString];
+        [RZAssert flush];
+
+        expect(firstMessages).to.equal(@[kTestMessage]);
+        expect(secondMessages).to.equal(@[kNonEmptyString]);
+    });
+
+    it(@"doesn't take another logger's buffered failures when stopped", ^{
+        NSMutableArray *firstFailures = [NSMutableArray array];
+        NSMutableArray *secondFailures = [NSMutableArray array];
+
+        RZAssertBatchLogger *firstLogger = [[RZAssertBatchLogger alloc] initWithMaximumBatchSize:64 flushInterval:3600 deliveryHandler:^(NSArray *failures) {
+            [firstFailures addObjectsFromArray:failures];
+        }];
+        RZAssertBatchLogger *secondLogger = [[RZAssertBatchLogger alloc] initWithMaximumBatchSize:64 flushInterval:3600 deliveryHandler:^(NSArray *failures) {
+            [secondFailures addObjectsFromArray:failures];
+        }];
+
+        RZAssertFailure *firstFailure = [[RZAssertFailure alloc] initWithMessage:kTestMessage];
+        RZAssertFailure *secondFailure = [[RZAssertFailure alloc] initWithMessage:kNonEmptyString];
+
+        // The order a reconfiguration produces: the replacement is appended to before the old logger stops.
+        [firstLogger appendFailure:firstFailure];
+        [secondLogger appendFailure:secondFailure];
+        [firstLogger stop];
+
+        expect(firstFailures).to.equal(@[firstFailure]);
+        expect(secondFailures.count).to.equal(0);
+
+        [secondLogger stop];
+
+        expect(secondFailures).to.equal(@[secondFailure]);
+    });
+
+    it(@"flushes when the handler is removed", ^{
+        __block NSUInteger loggedCount = 0;
+        [RZAssert configureWithBatchLoggingHandler:^(NSArray *messages) {
+            loggedCount += messages.count;
+        }];
+
+        [RZAssert logMessage:kTestMessage];
+        [RZAssert removeBatchLoggingHandler];
+
+        expect(loggedCount).to.equal(1);
+    });
+
+});
+
+describe(@"buffered logging", ^{
+
+    afterEach(^{
+        [RZAssert removeBufferedLoggingHandler];
+    });
+
+    it(@"formats the same message as the logging handler", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        __block NSString *bufferedMessage = nil;
+        __block NSString *loggedMessage = nil;
+
+        [RZAssert configureWithBufferedLoggingHandler:^(const RZAssertMessageBuffer *buffer) {
+            expect(buffer->site).to.equal(&site);
+            expect(buffer->truncated).to.beFalsy();
+            expect(strlen(buffer->UTF8String)).to.equal(buffer->length);
+            bufferedMessage = RZAssertMessageBufferString(buffer);
+        }];
+        [RZAssert configureWithLoggingHandler:^(NSString *message) {
+            loggedMessage = message;
+        }];
+
+        RZAssertReportFailure(&site, @"%d %5.2f %s %@ %lu %*d %c 100%%", -3, 3.14159, "c string", kNonEmptyString, (unsigned long)42, 4, 7, 'x');
+
+        expect(bufferedMessage).notTo.beNil();
+        expect(bufferedMessage).to.equal(loggedMessage);
+    });
+
+    it(@"writes objects other than strings as their class and address", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        __block NSString *bufferedMessage = nil;
+        NSArray *array = @[kNonEmptyString];
+
+        [RZAssert configureWithBufferedLoggingHandler:^(const RZAssertMessageBuffer *buffer) {
+            bufferedMessage = RZAssertMessageBufferString(buffer);
+        }];
+
+        RZAssertReportFailure(&site, @"%@ %@", array, nil);
+
+        NSString *expected = [NSString stringWithFormat:@"<%@: %p> (null)", NSStringFromClass([array class]), array];
+        expect([bufferedMessage hasSuffix:expected]).to.beTruthy();
+    });
+
+    it(@"truncates long messages at a character boundary", ^{
+        static RZAssertSite site = RZASSERT_SITE_INITIALIZER("test");
+        __block NSString *bufferedMessage = nil;
+        __block BOOL truncated = NO;
+        __block size_t length = 0;
+        NSString *longString = [@"" stringByPaddingToLength:RZASSERT_MESSAGE_BUFFER_SIZE withString:@"\u00e9" startingAtIndex:0];
+
+        [RZAssert configureWithBufferedLoggingHandler:^(const RZAssertMessageBuffer *buffer) {
+            truncated = buffer->truncated;
+            length = buffer->length;
+            bufferedMessage = RZAssertMessageBufferString(buffer);
+        }];
+
+        RZAssertReportFailure(&site, @"%@ %s", longString, "tail");
+
+        expect(truncated).to.beTruthy();
+        expect(length).to.beLessThan(RZASSERT_MESSAGE_BUFFER_SIZE);
+        expect(bufferedMessage).notTo.beNil();
+        expect([bufferedMessage lengthOfBytesUsingEncoding:NSUTF8StringEncoding]).to.equal(length);
+    });
+
+    it(@"delivers logged messages", ^{
+        __block NSString *bufferedMessage = nil;
+
+        [RZAssert configureWithBufferedLoggingHandler:^(const RZAssertMessageBuffer *buffer) {
+            expect(buffer->site == NULL).to.beTruthy();
+            bufferedMessage = RZAssertMessageBufferString(buffer);
+        }];
+
+        [RZAssert logMessage:kTestMessage];
+
+        expect(bufferedMessage).to.equal(kTestMessage);
+    });
+
+});
+
 describe(@"RZCASSERT_NIL works", ^{
 
     it(@"handles nil correctly", ^{
@@ -471,6 +1368,184 @@ describe(@"RZCASSERT_TRUE_LOG works", ^{
 
 });
 
+describe(@"levels and categories", ^{
+
+    afterEach(^{
+        [RZAssert setEnabledLevel:RZAssertLevelNormal];
+    });
+
+    it(@"checks cheap and normal assertions by default", ^{
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_CHEAP(NO);
+        })).to.beTruthy();
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_TRUE(NO);
+        })).to.beTruthy();
+    });
+
+    it(@"skips expensive assertions by default without evaluating them", ^{
+        __block NSUInteger evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_EXPENSIVE(evaluations++ > 0);
+        })).to.beFalsy();
+        expect(evaluations).to.equal(0);
+    });
+
+    it(@"checks expensive assertions once enabled", ^{
+        [RZAssert setEnabledLevel:RZAssertLevelExpensive];
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_EXPENSIVE(NO);
+        })).to.beTruthy();
+    });
+
+    it(@"enables levels per category", ^{
+        [RZAssert setEnabledLevel:RZAssertLevelExpensive forCategories:RZASSERT_CATEGORY(2)];
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_LEVEL(RZAssertLevelExpensive, RZASSERT_CATEGORY(2), NO);
+        })).to.beTruthy();
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_LEVEL(RZAssertLevelExpensive, RZASSERT_CATEGORY(3), NO);
+        })).to.beFalsy();
+    });
+
+    it(@"disables categories", ^{
+        [RZAssert disableCategories:RZASSERT_CATEGORY(4)];
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_LEVEL(RZAssertLevelCheap, RZASSERT_CATEGORY(4), NO);
+        })).to.beFalsy();
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_LEVEL(RZAssertLevelCheap, RZASSERT_CATEGORY(5), NO);
+        })).to.beTruthy();
+    });
+
+    it(@"lowers the level", ^{
+        [RZAssert setEnabledLevel:RZAssertLevelCheap];
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_TRUE(NO);
+        })).to.beFalsy();
+    });
+
+    it(@"rejects invalid levels", ^{
+        expect(^{
+            [RZAssert setEnabledLevel:(RZAssertLevel)7];
+        }).to.raise(NSInvalidArgumentException);
+    });
+
+});
+
+describe(@"RZASSERT_SAMPLED works", ^{
+
+    it(@"always evaluates at a rate of 1", ^{
+        expect(testAssertionWithBlock(^{
+            RZASSERT_SAMPLED(1.0, NO);
+        })).to.beTruthy();
+    });
+
+    it(@"never evaluates at a rate of 0", ^{
+        expect(testAssertionWithBlock(^{
+            RZASSERT_SAMPLED(0.0, NO);
+        })).to.beFalsy();
+    });
+
+});
+
+describe(@"RZCASSERT_SAMPLED works", ^{
+
+    it(@"always evaluates at a rate of 1", ^{
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_SAMPLED(1.0, NO);
+        })).to.beTruthy();
+    });
+
+    it(@"never evaluates at a rate of 0", ^{
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_SAMPLED(0.0, NO);
+        })).to.beFalsy();
+    });
+
+    it(@"samples at roughly the requested rate", ^{
+        NSUInteger sampled = 0;
+        for ( NSUInteger i = 0; i < 10000; i++ ) {
+            if ( RZAssertShouldSample(0.25) ) {
+                sampled++;
+            }
+        }
+
+        expect(sampled).to.beGreaterThan(2000);
+        expect(sampled).to.beLessThan(3000);
+    });
+
+});
+
+describe(@"operand evaluation", ^{
+
+    __block NSUInteger evaluations = 0;
+
+    beforeEach(^{
+        evaluations = 0;
+    });
+
+    afterEach(^{
+        [RZAssert setEnabledLevel:RZAssertLevelNormal];
+    });
+
+    it(@"evaluates each operand once when an assertion fails", ^{
+        expect(testAssertionWithBlock(^{
+            RZASSERT_EQUAL_OBJECTS((evaluations++, kNonEmptyString), (evaluations++, kEmptyString));
+        })).to.beTruthy();
+        expect(evaluations).to.equal(2);
+
+        evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_EQUAL_STRINGS((evaluations++, kNonEmptyString), (evaluations++, kEmptyString));
+        })).to.beTruthy();
+        expect(evaluations).to.equal(2);
+
+        evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZASSERT_KINDOF((evaluations++, kNonEmptyString), NSArray);
+        })).to.beTruthy();
+        expect(evaluations).to.equal(1);
+
+        evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_CONFORMS_PROTOCOL((evaluations++, kNonEmptyString), (evaluations++, @protocol(NSFastEnumeration)));
+        })).to.beTruthy();
+        expect(evaluations).to.equal(2);
+
+        evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_NONEMPTY_STRING((evaluations++, kEmptyString));
+        })).to.beTruthy();
+        expect(evaluations).to.equal(1);
+
+        evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_SAMPLED((evaluations++, 1.0), NO);
+        })).to.beTruthy();
+        expect(evaluations).to.equal(1);
+    });
+
+    it(@"evaluates each operand once when an assertion passes", ^{
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_EQUAL_OBJECT_POINTERS((evaluations++, kNonEmptyString), (evaluations++, kNonEmptyString));
+            RZCASSERT_KINDOF_OR_NIL((evaluations++, kNonEmptyString), NSString);
+        })).to.beFalsy();
+        expect(evaluations).to.equal(3);
+    });
+
+    it(@"does not evaluate operands of disabled assertions", ^{
+        [RZAssert disableCategories:RZAssertCategoryDefault];
+        expect(testAssertionWithBlock(^{
+            RZASSERT_EQUAL_OBJECTS((evaluations++, kNonEmptyString), (evaluations++, kEmptyString));
+            RZCASSERT_KINDOF((evaluations++, kNonEmptyString), NSArray);
+            RZCASSERT_SAMPLED((evaluations++, 1.0), NO);
+        })).to.beFalsy();
+        expect(evaluations).to.equal(0);
+    });
+
+});
+
 describe(@"RZASSERT_EQUAL_OBJECT_POINTERS works", ^{
 
     it(@"handles nil correcty", ^{
@@ -557,6 +1632,173 @@ describe(@"RZCASSERT_EQUAL_OBJECTS works", ^{
 
 });
 
+describe(@"numeric comparisons work", ^{
+
+    it(@"pass and fail like the operators they are named for", ^{
+        NSInteger one = 1;
+        NSUInteger two = 2;
+
+        expect(testAssertionWithBlock(^{ RZASSERT_EQ(one, 1); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_EQ(one, two); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZASSERT_NE(one, two); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_NE(one, one); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZASSERT_LT(one, 2); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_LT(one, one); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZASSERT_LE(one, one); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_LE(2, one); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZASSERT_GT(2.5, one); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_GT(one, one); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZASSERT_GE(one, one); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_GE(one, 2.5); })).to.beTruthy();
+    });
+
+    it(@"have C variants", ^{
+        expect(testAssertionWithBlock(^{ RZCASSERT_EQ('a', 97); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_NE(0.1f, 0.1); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_LT(-1LL, 0); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_LE(1u, 0u); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_EQ(kNilString, kEmptyString); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_GE(3, 4); })).to.beTruthy();
+    });
+
+    it(@"checks ranges inclusively", ^{
+        expect(testAssertionWithBlock(^{ RZASSERT_IN_RANGE(5, 5, 10); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_IN_RANGE(10.0, 5, 10); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_IN_RANGE(11, 5, 10); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_IN_RANGE(4u, 5u, 10u); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_IN_RANGE(NAN, 0.0, INFINITY); })).to.beTruthy();
+    });
+
+    it(@"checks approximate equality in either order", ^{
+        expect(testAssertionWithBlock(^{ RZASSERT_APPROX_EQUAL(M_PI, 3.14, 0.01); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_APPROX_EQUAL(3.14, M_PI, 0.01); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_APPROX_EQUAL(M_PI, 3.0, 0.01); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_APPROX_EQUAL(3u, 5u, 2u); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_APPROX_EQUAL(5u, 3u, 1u); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_APPROX_EQUAL(NAN, NAN, INFINITY); })).to.beTruthy();
+    });
+
+    it(@"formats each value with a conversion that matches its type", ^{
+        expect(@(RZASSERT_DESCRIBE_VALUE((unsigned char)200))).to.equal(@"200");
+        expect(@(RZASSERT_DESCRIBE_VALUE((short)-3))).to.equal(@"-3");
+        expect(@(RZASSERT_DESCRIBE_VALUE(UINT64_MAX))).to.equal(@"18446744073709551615");
+        expect(@(RZASSERT_DESCRIBE_VALUE(0.1f))).to.equal(@"0.100000001");
+        expect(@(RZASSERT_DESCRIBE_VALUE(0.1))).to.equal(@"0.10000000000000001");
+
+        int value = 0;
+        NSString *expectedPointer = [NSString stringWithFormat:@"%p", (void *)&value];
+        expect(@(RZASSERT_DESCRIBE_VALUE(&value))).to.equal(expectedPointer);
+    });
+
+    it(@"evaluates each operand once", ^{
+        __block NSUInteger evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_LT(evaluations++, evaluations++);
+        })).to.beFalsy();
+        expect(evaluations).to.equal(2);
+    });
+
+});
+
+describe(@"buffer assertions work", ^{
+
+    // Odd lengths and offsets exercise the unaligned head and scalar tail around the vector loop.
+    static const size_t kSampleCount = 37;
+
+    beforeEach(^{
+        for ( size_t i = 0; i < 40; i++ ) {
+            sSamples[i] = i;
+            sFloatSamples[i] = i;
+            sIntSamples[i] = (int)i;
+        }
+    });
+
+    it(@"pass for good buffers", ^{
+        double *values = sSamples + 1;
+        expect(testAssertionWithBlock(^{ RZASSERT_ALL_FINITE(values, kSampleCount); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_FINITE(sFloatSamples, kSampleCount); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_ALL_IN_RANGE(values, kSampleCount, 1, kSampleCount); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_IN_RANGE(sIntSamples, kSampleCount, 0, 36); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZASSERT_SORTED(values, kSampleCount); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_SORTED(sIntSamples, kSampleCount); })).to.beFalsy();
+    });
+
+    it(@"pass for empty buffers", ^{
+        const float *empty = NULL;
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_FINITE(empty, 0); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_IN_RANGE(empty, 0, 0, 1); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_SORTED(empty, 0); })).to.beFalsy();
+    });
+
+    it(@"fail for bad buffers", ^{
+        sSamples[20] = INFINITY;
+        sFloatSamples[35] = NAN;
+        sIntSamples[36] = 34;
+
+        expect(testAssertionWithBlock(^{ RZASSERT_ALL_FINITE(sSamples, kSampleCount); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_FINITE(sFloatSamples, kSampleCount); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZASSERT_ALL_IN_RANGE(sFloatSamples, kSampleCount, 0, 100); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_IN_RANGE(sIntSamples, kSampleCount, 0, 35); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_IN_RANGE(sIntSamples, kSampleCount, 1, 35); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZASSERT_SORTED(sFloatSamples, kSampleCount); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_SORTED(sIntSamples, kSampleCount); })).to.beTruthy();
+    });
+
+    it(@"find the first failing element", ^{
+        sSamples[9] = NAN;
+        sSamples[30] = -INFINITY;
+        sFloatSamples[3] = 50;
+
+        expect(RZASSERT_FIRST_NON_FINITE(sSamples, kSampleCount)).to.equal(9);
+        expect(RZASSERT_FIRST_NON_FINITE(sSamples + 10, kSampleCount - 10)).to.equal(20);
+        expect(RZASSERT_FIRST_OUT_OF_RANGE(sFloatSamples, kSampleCount, 0.0f, 36.0f)).to.equal(3);
+        expect(RZASSERT_FIRST_UNSORTED(sFloatSamples, kSampleCount)).to.equal(4);
+        expect(RZASSERT_FIRST_UNSORTED(sSamples, kSampleCount)).to.equal(9);
+        expect(RZASSERT_FIRST_UNSORTED(sIntSamples, kSampleCount)).to.equal(kSampleCount);
+    });
+
+});
+
+describe(@"string comparisons", ^{
+
+    it(@"find the first difference", ^{
+        NSMutableString *long1 = [NSMutableString string];
+        for ( NSUInteger i = 0; i < 10000; i++ ) {
+            [long1 appendFormat:@"%lu,", (unsigned long)(i % 10)];
+        }
+        NSMutableString *long2 = [long1 mutableCopy];
+        [long2 replaceCharactersInRange:NSMakeRange(12345, 1) withString:@"x"];
+
+        expect(RZAssertFirstStringDifference(long1, [long1 copy])).to.equal(NSNotFound);
+        expect(RZAssertFirstStringDifference(long1, long2)).to.equal(12345);
+        expect(RZAssertFirstStringDifference(@"abc", @"abcd")).to.equal(3);
+        expect(RZAssertFirstStringDifference(@"", @"a")).to.equal(0);
+        expect(RZAssertFirstStringDifference(kNilString, kNilString)).to.equal(NSNotFound);
+        expect(RZAssertFirstStringDifference(kNilString, kEmptyString)).to.equal(0);
+
+        // UTF-16 storage on one side and ASCII on the other.
+        expect(RZAssertFirstStringDifference(@"café au lait", @"cafe au lait")).to.equal(3);
+        expect(RZAssertStringsEqual(@"café", [NSString stringWithFormat:@"caf%C", (unichar)0xe9])).to.beTruthy();
+    });
+
+    it(@"describe only a window around the difference", ^{
+        NSString *left = [@"" stringByPaddingToLength:100000 withString:@"a" startingAtIndex:0];
+        NSString *right = [[left substringToIndex:50000] stringByAppendingString:[@"" stringByPaddingToLength:50000 withString:@"b" startingAtIndex:0]];
+
+        NSString *description = RZAssertDescribeStringDifference(left, right);
+        expect(description).to.contain(@"offset: 50000");
+        expect(description.length).to.beLessThan(4 * RZASSERT_STRING_CONTEXT_LENGTH + 100);
+    });
+
+    it(@"keep RZASSERT_EQUAL_STRINGS semantics", ^{
+        expect(testAssertionWithBlock(^{ RZCASSERT_EQUAL_STRINGS(kNilString, kNilString); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_EQUAL_STRINGS(kNilString, kEmptyString); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_EQUAL_STRINGS(kNonEmptyString, [kNonEmptyString mutableCopy]); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_EQUAL_STRINGS(@"line\none", @"line\ntwo"); })).to.beTruthy();
+    });
+
+});
+
 describe(@"RZASSERT_EQUAL_STRINGS works", ^{
 
     it(@"handles equal strings correctly", ^{
@@ -733,6 +1975,146 @@ describe(@"RZCASSERT_KINDOF_OR_NIL works", ^{
 
 });
 
+describe(@"class caches", ^{
+
+    it(@"give the same answers as -isKindOfClass:", ^{
+        static RZAssertClassCache cache = RZASSERT_CLASS_CACHE_INITIALIZER;
+        NSArray *objects = @[ kNonEmptyString, [kNonEmptyString mutableCopy], @1, @[], [NSObject new], [NSString stringWithFormat:@"%d", 2] ];
+
+        for ( NSUInteger pass = 0; pass < 3; pass++ ) {
+            for ( id object in objects ) {
+                expect(RZAssertIsKindOfClassCached(&cache, object, [NSString class])).to.equal([object isKindOfClass:[NSString class]]);
+            }
+        }
+        expect(RZAssertIsKindOfClassCached(&cache, nil, [NSString class])).to.beFalsy();
+    });
+
+    it(@"check other classes uncached at a site whose class varies", ^{
+        static RZAssertClassCache cache = RZASSERT_CLASS_CACHE_INITIALIZER;
+        expect(RZAssertIsKindOfClassCached(&cache, kNonEmptyString, [NSString class])).to.beTruthy();
+        expect(RZAssertIsKindOfClassCached(&cache, kNonEmptyString, [NSNumber class])).to.beFalsy();
+        expect(RZAssertIsKindOfClassCached(&cache, @1, [NSNumber class])).to.beTruthy();
+        expect(RZAssertIsKindOfClassCached(&cache, kNonEmptyString, [NSNumber class])).to.beFalsy();
+    });
+
+    it(@"handle classes registered at runtime", ^{
+        static RZAssertClassCache cache = RZASSERT_CLASS_CACHE_INITIALIZER;
+        Class parentClass = objc_allocateClassPair([NSObject class], "RZAssertCacheTestParent", 0);
+        objc_registerClassPair(parentClass);
+        Class childClass = objc_allocateClassPair(parentClass, "RZAssertCacheTestChild", 0);
+        objc_registerClassPair(childClass);
+
+        @autoreleasepool {
+            id child = [childClass new];
+            expect(RZAssertIsKindOfClassCached(&cache, child, parentClass)).to.beTruthy();
+            expect(RZAssertIsKindOfClassCached(&cache, child, parentClass)).to.beTruthy();
+            expect(RZAssertIsKindOfClassCached(&cache, [NSObject new], parentClass)).to.beFalsy();
+        }
+
+        objc_disposeClassPair(childClass);
+        RZAssertInvalidateClassCaches();
+
+        Class otherClass = objc_allocateClassPair([NSObject class], "RZAssertCacheTestOther", 0);
+        objc_registerClassPair(otherClass);
+        expect(RZAssertIsKindOfClassCached(&cache, [otherClass new], parentClass)).to.beFalsy();
+    });
+
+    it(@"give the same conformance answers as -conformsToProtocol:", ^{
+        NSArray *objects = @[ kNonEmptyString, @1, [NSObject new], @[] ];
+        NSArray *protocols = @[ @protocol(NSCopying), @protocol(NSFastEnumeration), @protocol(NSObject) ];
+
+        for ( NSUInteger pass = 0; pass < 3; pass++ ) {
+            for ( id object in objects ) {
+                for ( Protocol *protocol in protocols ) {
+                    expect(RZAssertConformsToProtocolCached(object, protocol)).to.equal([object conformsToProtocol:protocol]);
+                }
+            }
+        }
+        expect(RZAssertConformsToProtocolCached(nil, @protocol(NSObject))).to.beFalsy();
+    });
+
+    it(@"see protocols added at runtime", ^{
+        Class runtimeClass = objc_allocateClassPair([NSObject class], "RZAssertConformanceTestClass", 0);
+        objc_registerClassPair(runtimeClass);
+        id object = [runtimeClass new];
+
+        expect(testAssertionWithBlock(^{ RZCASSERT_CONFORMS_PROTOCOL(object, @protocol(NSCopying)); })).to.beTruthy();
+
+        class_addProtocol(runtimeClass, @protocol(NSCopying));
+
+        expect(testAssertionWithBlock(^{ RZCASSERT_CONFORMS_PROTOCOL(object, @protocol(NSCopying)); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_CONFORMS_PROTOCOL(object, @protocol(NSCopying)); })).to.beFalsy();
+    });
+
+    it(@"let RZASSERT_KINDOF pass and fail repeatedly", ^{
+        for ( NSUInteger i = 0; i < 3; i++ ) {
+            id object = (i % 2 == 0) ? kNonEmptyString : (id)@(i);
+            BOOL failed = testAssertionWithBlock(^{ RZCASSERT_KINDOF(object, NSString); });
+            expect(failed).to.equal(i % 2 != 0);
+        }
+    });
+
+});
+
+describe(@"collection type checks work", ^{
+
+    it(@"pass for homogeneous collections", ^{
+        // Mixes concrete classes from the NSString cluster.
+        NSArray *strings = @[ kNonEmptyString, [kNonEmptyString mutableCopy], [NSString stringWithFormat:@"%d", 1], @"" ];
+        expect(testAssertionWithBlock(^{ RZASSERT_ALL_KINDOF(strings, NSString); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_KINDOF([NSSet setWithArray:strings], [NSString class]); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_KINDOF(@[], NSNumber); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_KINDOF(nil, NSNumber); })).to.beFalsy();
+    });
+
+    it(@"finds the first element of another class", ^{
+        NSMutableArray *numbers = [NSMutableArray array];
+        for ( NSInteger i = 0; i < 100; i++ ) {
+            [numbers addObject:@(i)];
+        }
+        [numbers insertObject:kNonEmptyString atIndex:70];
+
+        NSUInteger index = NSNotFound;
+        id object = nil;
+        expect(RZAssertAllKindOfClass(numbers, [NSNumber class], &index, &object)).to.beFalsy();
+        expect(index).to.equal(70);
+        expect(object).to.equal(kNonEmptyString);
+
+        expect(testAssertionWithBlock(^{ RZASSERT_ALL_KINDOF(numbers, NSNumber); })).to.beTruthy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_KINDOF(numbers, NSObject); })).to.beFalsy();
+    });
+
+    it(@"checks dictionary keys and values", ^{
+        NSMutableDictionary *dictionary = [NSMutableDictionary dictionary];
+        for ( NSInteger i = 0; i < 100; i++ ) {
+            dictionary[[NSString stringWithFormat:@"%ld", (long)i]] = @(i);
+        }
+
+        expect(testAssertionWithBlock(^{ RZASSERT_ALL_KEYS_VALUES_KINDOF(dictionary, NSString, NSNumber); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_KEYS_VALUES_KINDOF(@{}, NSString, NSNumber); })).to.beFalsy();
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_KEYS_VALUES_KINDOF(dictionary, NSNumber, NSNumber); })).to.beTruthy();
+
+        dictionary[@"bad"] = kNonEmptyString;
+
+        id key = nil;
+        id object = nil;
+        expect(RZAssertAllKeysAndValuesKindOfClasses(dictionary, [NSString class], [NSNumber class], &key, &object)).to.beFalsy();
+        expect(key).to.equal(@"bad");
+        expect(object).to.equal(kNonEmptyString);
+
+        expect(testAssertionWithBlock(^{ RZCASSERT_ALL_KEYS_VALUES_KINDOF(dictionary, NSString, NSNumber); })).to.beTruthy();
+    });
+
+    it(@"evaluates the collection once", ^{
+        __block NSUInteger evaluations = 0;
+        expect(testAssertionWithBlock(^{
+            RZCASSERT_ALL_KINDOF((evaluations++, @[ kNonEmptyString ]), NSNumber);
+        })).to.beTruthy();
+        expect(evaluations).to.equal(1);
+    });
+
+});
+
 describe(@"RZASSERT_CONFORMS_PROTOCOL works", ^{
 
     it(@"handles nil objects correctly", ^{
@@ -845,6 +2227,59 @@ describe(@"RZCASSERT_CLASS_SUBCLASS_OF_CLASS works", ^{
 
 });
 
+describe(@"RZASSERT_ONCE works", ^{
+
+    it(@"evaluates a passing assertion once per call site", ^{
+        __block NSUInteger evaluations = 0;
+        for ( NSUInteger i = 0; i < 5; i++ ) {
+            expect(testAssertionWithBlock(^{
+                RZASSERT_ONCE(RZCASSERT_TRUE((evaluations++, YES)));
+            })).to.beFalsy();
+        }
+        expect(evaluations).to.equal(1);
+
+        for ( NSUInteger i = 0; i < 5; i++ ) {
+            expect(testAssertionWithBlock(^{
+                RZASSERT_ONCE(RZCASSERT_EQ(evaluations++, evaluations - 1));
+            })).to.beFalsy();
+        }
+        expect(evaluations).to.equal(2);
+    });
+
+    it(@"doesn't count executions while the assertion's level is disabled", ^{
+        __block NSUInteger evaluations = 0;
+        AssertionBlock block = ^{
+            RZASSERT_ONCE(RZCASSERT_EXPENSIVE((evaluations++, YES)));
+        };
+
+        expect(testAssertionWithBlock(block)).to.beFalsy();
+        expect(evaluations).to.equal(0);
+
+        [RZAssert setEnabledLevel:RZAssertLevelExpensive];
+        expect(testAssertionWithBlock(block)).to.beFalsy();
+        expect(testAssertionWithBlock(block)).to.beFalsy();
+        [RZAssert setEnabledLevel:RZAssertLevelNormal];
+
+        expect(evaluations).to.equal(1);
+    });
+
+    it(@"reports a failing assertion", ^{
+        expect(testAssertionWithBlock(^{
+            RZASSERT_ONCE(RZCASSERT_TRUE(NO));
+        })).to.beTruthy();
+    });
+
+    it(@"has an every-time subclass check for classes that vary", ^{
+        NSArray *classes = @[ [NSString class], [NSNumber class] ];
+        for ( Class testClass in classes ) {
+            expect(testAssertionWithBlock(^{
+                RZCASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME(testClass, NSString);
+            })).to.equal(testClass != [NSString class]);
+        }
+    });
+
+});
+
 describe(@"RZASSERT_SUBCLASSES_MUST_OVERRIDE works", ^{
 
     it(@"always throws an exception", ^{
@@ -26,14 +26,192 @@
 //  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //
 
+#if __has_feature(modules)
 @import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+#import "RZAssertFailure.h"
+#import "RZAssertBufferChecks.h"
+#import "RZAssertClassChecks.h"
+#import "RZAssertStringChecks.h"
+#import "RZAssertStatistics.h"
+#import "RZAssertProfiler.h"
+#import "RZAssertWireEncoding.h"
+#import "RZAssertBacktrace.h"
+
+#pragma mark - Fast Path
+
+/**
+ *  Branch prediction hints used by the assertion macros.
+ */
+#define RZASSERT_LIKELY(x)      __builtin_expect(!!(x), 1)
+#define RZASSERT_UNLIKELY(x)    __builtin_expect(!!(x), 0)
+
+/**
+ *  How much an assertion costs to check. Levels are enabled per category at runtime with +[RZAssert setEnabledLevel:forCategories:].
+ */
+typedef NS_ENUM(NSInteger, RZAssertLevel) {
+    /**
+     *  Checks cheap enough to leave on everywhere, such as nil or range checks.
+     */
+    RZAssertLevelCheap = 0,
+    /**
+     *  Ordinary checks. Every assertion without an explicit level is at this level.
+     */
+    RZAssertLevelNormal,
+    /**
+     *  Checks too slow to run by default, such as walking a whole collection. Disabled until enabled at runtime.
+     */
+    RZAssertLevelExpensive,
+};
+
+/**
+ *  A set of assertion categories. Tag assertions with one category, from @c RZASSERT_CATEGORY(1) to @c RZASSERT_CATEGORY(15), to turn subsystems' checks on and off together.
+ */
+typedef uint16_t RZAssertCategories;
+
+#define RZASSERT_CATEGORY(index)    ((RZAssertCategories)(1u << (index)))
+
+/**
+ *  The category of assertions that are not tagged with one.
+ */
+#define RZAssertCategoryDefault     RZASSERT_CATEGORY(0)
+#define RZAssertCategoryAll         ((RZAssertCategories)0xffff)
+
+/**
+ *  Bits of RZAssertControlWord. Each level has 16 bits, one per category. The top bit is set while any logger is configured, the next while one needs RZAssertFailure objects, the next while a buffered logging handler is configured, the next while statistics are enabled, the next while profiling is enabled, and the next while backtraces are enabled. For private use only.
+ */
+#define RZASSERT_CONTROL_BIT(level, category)   ((uint64_t)(RZAssertCategories)(category) << (16 * (level)))
+#define RZASSERT_CONTROL_LOGGER_BIT             (1ull << 63)
+#define RZASSERT_CONTROL_FAILURE_BIT            (1ull << 62)
+#define RZASSERT_CONTROL_MESSAGE_BUFFER_BIT     (1ull << 61)
+#define RZASSERT_CONTROL_STATISTICS_BIT         (1ull << 60)
+#define RZASSERT_CONTROL_PROFILING_BIT          (1ull << 59)
+#define RZASSERT_CONTROL_BACKTRACE_BIT          (1ull << 58)
+
+/**
+ *  The enabled levels and categories, and whether a logging handler, failure handler, sink, batch logging handler, crash log, or breadcrumb ring is configured, in one word so the macros decide whether to check with a single load. Written by RZAssert with release semantics. For private use only; read it with @c RZAssertControlEnabled().
+ */
+FOUNDATION_EXPORT uint64_t RZAssertControlWord;
+
+/**
+ *  Whether all of the given control bits are set. The assertion macros pass a compile-time constant, so this costs a single acquire load and branch, with no message send.
+ *
+ *  @param required The bits that must all be set, built with @c RZASSERT_CONTROL_BIT() and @c RZASSERT_CONTROL_LOGGER_BIT.
+ *
+ *  @return @c YES if every bit in @c required is set.
+ */
+NS_INLINE BOOL RZAssertControlEnabled(uint64_t required)
+{
+    return ( (__atomic_load_n(&RZAssertControlWord, __ATOMIC_ACQUIRE) & required) == required );
+}
+
+/**
+ *  Loads the control word once, for macros that test several of its bits. For private use only.
+ *
+ *  @return The current value of RZAssertControlWord.
+ */
+NS_INLINE uint64_t RZAssertControlLoad(void)
+{
+    return __atomic_load_n(&RZAssertControlWord, __ATOMIC_ACQUIRE);
+}
+
+/**
+ *  Whether a loaded control word has all of the required bits, and at least one of the others. For private use only.
+ *
+ *  @param control  A value returned by @c RZAssertControlLoad().
+ *  @param required The bits that must all be set.
+ *  @param any      Bits of which at least one must be set.
+ *
+ *  @return @c YES if every bit in @c required and some bit in @c any is set.
+ */
+NS_INLINE BOOL RZAssertControlAllows(uint64_t control, uint64_t required, uint64_t any)
+{
+    return ( (control & required) == required && (control & any) != 0 );
+}
+
+/**
+ *  Starts timing part of an assertion, if profiling is enabled. For private use only.
+ *
+ *  @param control A value returned by @c RZAssertControlLoad().
+ *
+ *  @return A nonzero start time to pass to @c RZAssertProfilerRecord(), or 0 if profiling is disabled.
+ */
+NS_INLINE uint64_t RZAssertProfilerStart(uint64_t control)
+{
+    return RZASSERT_UNLIKELY(control & RZASSERT_CONTROL_PROFILING_BIT) ? RZAssertProfilerNow() : 0;
+}
+
+/**
+ *  Inline equivalent of +[RZAssert hasLogger], so assertions stay cheap when no logger is configured.
+ *
+ *  @return @c YES if there is a logging handler, otherwise @c NO.
+ */
+NS_INLINE BOOL RZAssertHasLoggerFast(void)
+{
+    return RZAssertControlEnabled(RZASSERT_CONTROL_LOGGER_BIT);
+}
+
+/**
+ *  Returns the calling thread's sampling generator state, seeded the first time the thread samples. For private use only.
+ */
+FOUNDATION_EXPORT uint64_t *RZAssertSamplingState(void);
+
+/**
+ *  Decides whether a sampled assertion evaluates its condition this time, using a per-thread xorshift generator kept behind a pthread key, so there is no shared state between threads. For private use only.
+ *
+ *  @param rate The fraction of executions to sample, from 0.0 to 1.0.
+ *
+ *  @return @c YES if the condition should be evaluated.
+ */
+NS_INLINE BOOL RZAssertShouldSample(double rate)
+{
+    uint64_t *state = RZAssertSamplingState();
+
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *state = x;
+
+    return ( (double)(uint32_t)(x >> 32) < rate * 4294967296.0 );
+}
+
+/**
+ *  Whether a failure at a call site should be logged, or counted toward the site’s suppressed-repeats summary because it exceeded the rate limit. For private use only.
+ *
+ *  @param site The call site that failed.
+ *
+ *  @return @c YES if the failure should be formatted and logged.
+ */
+FOUNDATION_EXPORT BOOL RZAssertSiteShouldLog(RZAssertSite *site);
+
+/**
+ *  What asynchronous logging does when its queue is full.
+ */
+typedef NS_ENUM(NSInteger, RZAssertBackpressurePolicy) {
+    /**
+     *  Discard the message that could not be queued.
+     */
+    RZAssertBackpressurePolicyDropNewest = 0,
+    /**
+     *  Discard the oldest queued message to make room for the new one.
+     */
+    RZAssertBackpressurePolicyDropOldest,
+    /**
+     *  Wait on the failing thread until the logging thread makes room.
+     */
+    RZAssertBackpressurePolicyBlock,
+};
 
 @interface RZAssert : NSObject
 
 /**
  *  Configures RZAssert to log using a custom handler. This block is run only when @c NS_BLOCK_ASSERTIONS is defined.
  *
- *  @param loggingHandler The block to run when an assertion condition is encountered, but assertions are disabled. The block is called from the same thread that your RZASSERT macro was called from, so you are responsible for making sure your logging code is thread-safe.
+ *  @param loggingHandler The block to run when an assertion condition is encountered, but assertions are disabled. The block is called from the same thread that your RZASSERT macro was called from, unless asynchronous logging is enabled, so you are responsible for making sure your logging code is thread-safe.
  */
 + (void)configureWithLoggingHandler:(void(^)(NSString *message))loggingHandler;
 
@@ -42,6 +220,246 @@
  */
 + (void)removeLoggingHandler;
 
+/**
+ *  Configures RZAssert to log in batches, for handlers such as file writers or compressors that are much cheaper per message when given many at once. Like the logging handler, this block is run only when @c NS_BLOCK_ASSERTIONS is defined, and it may be configured alongside the other handlers.
+ *
+ *  Each thread buffers its messages without taking any lock shared with other threads. A thread’s buffer is delivered when it holds @c maximumBatchSize messages, every @c flushInterval seconds, and on +flush. When the process exits normally, through @c exit() or by returning from @c main(), +flush runs, so every message logged before that is delivered. Messages still buffered when the process crashes are lost; use the crash log for those.
+ *
+ *  @param batchLoggingHandler The block to run with each batch of messages, an array of strings in the order they were logged on their thread. Batches are delivered one at a time, on a background queue.
+ *  @param maximumBatchSize    The number of messages a thread buffers before delivering them. Must be greater than 0.
+ *  @param flushInterval       How often to deliver partially filled buffers, in seconds. Must be greater than 0.
+ */
++ (void)configureWithBatchLoggingHandler:(void(^)(NSArray *messages))batchLoggingHandler maximumBatchSize:(NSUInteger)maximumBatchSize flushInterval:(NSTimeInterval)flushInterval;
+
+/**
+ *  Configures RZAssert to log in batches of up to 64 messages, flushed every second. See +configureWithBatchLoggingHandler:maximumBatchSize:flushInterval:.
+ *
+ *  @param batchLoggingHandler The block to run with each batch of messages.
+ */
++ (void)configureWithBatchLoggingHandler:(void(^)(NSArray *messages))batchLoggingHandler;
+
+/**
+ *  Flushes, then removes the batch logging handler.
+ */
++ (void)removeBatchLoggingHandler;
+
+/**
+ *  Delivers every message buffered for the batch logging handler, on all threads, and returns once the handler has finished with them. Messages still waiting in the asynchronous logging queue are not included.
+ */
++ (void)flush;
+
+/**
+ *  Configures RZAssert to format each failure into a reusable, per-thread UTF-8 buffer and pass it to a handler, without allocating. Like the logging handler, this block is run only when @c NS_BLOCK_ASSERTIONS is defined.
+ *
+ *  Use this where a burst of failures must not add memory pressure, such as on threads without a nearby autorelease pool. If no other handler, sink, batch logging handler, or crash log is configured, failures never create an object. The handler always runs on the failing thread, even if asynchronous logging is enabled, and the buffer is only valid until it returns.
+ *
+ *  This only covers formatting. Macros that build part of their message themselves still allocate those strings on the failing thread: the @c _WITH_MESSAGE variants format @c message eagerly, and the object equality, kind-of, protocol and subclass-override checks name the classes involved with @c NSStringFromClass(). Macros that pass only their operands allocate nothing.
+ *
+ *  @param bufferedLoggingHandler The block to run when an assertion condition is encountered, but assertions are disabled. Call @c RZAssertMessageBufferString() if it needs an NSString.
+ */
++ (void)configureWithBufferedLoggingHandler:(void(^)(const RZAssertMessageBuffer *buffer))bufferedLoggingHandler;
+
+/**
+ *  Removes the buffered logging handler.
+ */
++ (void)removeBufferedLoggingHandler;
+
+/**
+ *  Configures RZAssert to report failures as structured records instead of messages. Like the logging handler, this block is run only when @c NS_BLOCK_ASSERTIONS is defined, and both handlers may be configured at once.
+ *
+ *  The failure’s message is not built unless the handler asks for it, so handlers that only need the call site, such as counters, are much cheaper than a logging handler. The arguments are still evaluated on the failing thread, so the @c _WITH_MESSAGE variants, which format @c message themselves, and the checks that name classes with @c NSStringFromClass() save less.
+ *
+ *  @param failureHandler The block to run when an assertion condition is encountered, but assertions are disabled. Called on the same thread as the logging handler would be.
+ */
++ (void)configureWithFailureHandler:(void(^)(RZAssertFailure *failure))failureHandler;
+
+/**
+ *  Removes the failure handler.
+ */
++ (void)removeFailureHandler;
+
+/**
+ *  Adds a sink, which receives failures alongside the handlers. Any number of sinks can be added, each with its own filter, so failures can go to, say, a crash reporter, the console, and a file at once. Like the handlers, sinks run only when @c NS_BLOCK_ASSERTIONS is defined.
+ *
+ *  Sinks are published as an immutable list, so failing threads read it without taking a lock, and adding or removing a sink never waits for threads that are delivering failures. A sink that has been removed may still receive failures that were already being delivered.
+ *
+ *  @param filter  Returns @c YES for the failures the sink should receive, or nil to receive all of them. Called on the delivering thread, before the message is built.
+ *  @param handler The block to run with each failure the filter accepts. Called on the same thread as the logging handler would be.
+ *
+ *  @return A token that identifies the sink, for +removeSink:.
+ */
++ (id)addSinkWithFilter:(BOOL(^)(RZAssertFailure *failure))filter handler:(void(^)(RZAssertFailure *failure))handler;
+
+/**
+ *  Removes a sink added with +addSinkWithFilter:handler:.
+ *
+ *  @param sink The token returned when the sink was added.
+ */
++ (void)removeSink:(id)sink;
+
+/**
+ *  Records every failure in a fixed-size, memory-mapped circular file, in addition to any handlers. Records are written on the failing thread with no system calls, and survive the process crashing, so they can be read on the next launch with the rzassert-decode-crash-log tool. When the file is full, the oldest records are overwritten.
+ *
+ *  @param path  The path of the file. Records already in a file of the same size are kept.
+ *  @param size  The size of the file, in bytes. Must be at least 16 KB.
+ *  @param error On failure, describes what went wrong.
+ *
+ *  @return @c YES if the file was mapped, otherwise @c NO.
+ */
++ (BOOL)enableCrashLogAtPath:(NSString *)path size:(NSUInteger)size error:(NSError **)error;
+
+/**
+ *  Stops recording failures in the crash log file. The file is left in place.
+ */
++ (void)disableCrashLog;
+
+/**
+ *  Keeps the last @c capacity failures in a preallocated in-memory ring, so they can be written out from a crash handler with @c +dumpBreadcrumbsOnCrashToFileDescriptor:. Appending a failure is lock-free and allocates nothing. Calling this again starts a new, empty ring.
+ *
+ *  @param capacity The number of failures to keep. Rounded up to a power of two. Must be greater than 0.
+ */
++ (void)enableBreadcrumbsWithCapacity:(NSUInteger)capacity;
+
+/**
+ *  Stops keeping failures in the breadcrumb ring.
+ */
++ (void)disableBreadcrumbs;
+
+/**
+ *  Installs SIGSEGV, SIGBUS and SIGABRT handlers that write the breadcrumbs to a file descriptor, one failure per line, using only async-signal-safe calls, then pass the signal on to the handler that was installed before. Calling this again only changes the file descriptor.
+ *
+ *  @param fileDescriptor An open file descriptor, such as a file opened at launch. It must stay open.
+ *
+ *  @return @c YES if the handlers were installed, otherwise @c NO.
+ */
++ (BOOL)dumpBreadcrumbsOnCrashToFileDescriptor:(int)fileDescriptor;
+
+/**
+ *  Restores the signal handlers that were installed before @c +dumpBreadcrumbsOnCrashToFileDescriptor:.
+ */
++ (void)removeBreadcrumbCrashHandlers;
+
+/**
+ *  Writes the breadcrumbs to a file descriptor now, in the same format as the crash handlers.
+ *
+ *  @param fileDescriptor An open file descriptor.
+ *
+ *  @return The number of failures written.
+ */
++ (NSUInteger)writeBreadcrumbsToFileDescriptor:(int)fileDescriptor;
+
+/**
+ *  Limits how often each assertion call site logs. Only the first @c maximumMessages failures at a site in each interval are formatted and logged. The rest are counted, and when the interval ends a single summary message, such as “suppressed 48,211 repeats of Foo.m:123 in the last 10s”, is logged in their place.
+ *
+ *  @param maximumMessages The number of failures per call site logged in each interval. Must be greater than 0, and at most 16,777,214.
+ *  @param interval        The length of the interval, in seconds. Must be greater than 0.
+ */
++ (void)configureRateLimitWithMaximumMessages:(NSUInteger)maximumMessages interval:(NSTimeInterval)interval;
+
+/**
+ *  Removes the rate limit, so every failure is logged. This is the default.
+ */
++ (void)removeRateLimit;
+
+/**
+ *  Enables assertions up to and including a level in every category, and disables the more expensive ones. By default, cheap and normal assertions are enabled everywhere. Disabled assertions do not evaluate their conditions, whether or not @c NS_BLOCK_ASSERTIONS is defined.
+ *
+ *  @param level The most expensive level to check.
+ */
++ (void)setEnabledLevel:(RZAssertLevel)level;
+
+/**
+ *  Enables assertions up to and including a level in some categories, and disables the more expensive ones there. Other categories are unchanged, so, for example, a canary build can turn on expensive checks for a single subsystem.
+ *
+ *  @param level      The most expensive level to check.
+ *  @param categories The categories to change.
+ */
++ (void)setEnabledLevel:(RZAssertLevel)level forCategories:(RZAssertCategories)categories;
+
+/**
+ *  Disables every level of assertions in some categories.
+ *
+ *  @param categories The categories to disable.
+ */
++ (void)disableCategories:(RZAssertCategories)categories;
+
+/**
+ *  Moves calls to the logging handler onto a dedicated background thread. Failing threads push messages into a bounded lock-free queue and return immediately, instead of waiting on your logging code. Messages are delivered in the order they were queued.
+ *
+ *  Calling this again replaces the current queue, after delivering everything already queued.
+ *
+ *  @param capacity The maximum number of queued messages. Rounded up to a power of two.
+ *  @param policy   What to do with a new message when the queue is full.
+ */
++ (void)enableAsynchronousLoggingWithCapacity:(NSUInteger)capacity backpressurePolicy:(RZAssertBackpressurePolicy)policy;
+
+/**
+ *  Delivers any queued messages, stops the background logging thread, and goes back to calling the logging handler on the failing thread.
+ */
++ (void)disableAsynchronousLogging;
+
+/**
+ *  The number of messages discarded by the @c RZAssertBackpressurePolicyDropNewest or @c RZAssertBackpressurePolicyDropOldest policies since asynchronous logging was last enabled.
+ *
+ *  @return The number of dropped messages, or 0 if asynchronous logging is disabled.
+ */
++ (uint64_t)droppedMessageCount;
+
+/**
+ *  Calls a block with every registered assertion call site, whether or not it has ever run. On Apple platforms this covers every loaded image; elsewhere it covers the module RZAssert is linked into.
+ *
+ *  @param block The block to call with each site.
+ */
++ (void)enumerateCallSitesUsingBlock:(void(^)(const RZAssertSite *site))block;
+
+/**
+ *  Starts counting how many times each assertion call site is evaluated and how many times it fails. Each thread counts in its own memory, so hot sites checked on many threads don't contend. Sites are counted even when assertions are blocked and no logger is configured.
+ */
++ (void)enableStatistics;
+
+/**
+ *  Stops counting evaluations and failures. The counts so far are kept.
+ */
++ (void)disableStatistics;
+
+/**
+ *  Merges every thread's counts into totals for export. Counts made on other threads while the snapshot is taken may not be included.
+ *
+ *  @return An array of RZAssertSiteStatistics, one for each site evaluated while statistics were enabled.
+ */
++ (NSArray *)statisticsSnapshot;
+
+/**
+ *  Starts timing each assertion call site's condition and failure path with a monotonic clock, into per-site latency histograms. Recording takes no locks. Use it in canary or internal builds to find checks worth demoting to a higher level or sampling; it adds two clock reads to every evaluated assertion. Like statistics, sites are profiled even when assertions are blocked and no logger is configured.
+ *
+ *  Up to @c RZASSERT_PROFILER_CAPACITY sites are tracked. When assertions are not blocked, the failure path is only timed if the assertion handler returns.
+ */
++ (void)enableProfiling;
+
+/**
+ *  Stops timing assertions. The histograms so far are kept.
+ */
++ (void)disableProfiling;
+
+/**
+ *  The profiled call sites that have spent the most time, in their conditions and failure paths together.
+ *
+ *  @param limit The most sites to return.
+ *
+ *  @return An array of up to @c limit RZAssertSiteProfile objects, most expensive first.
+ */
++ (NSArray *)mostExpensiveSitesWithLimit:(NSUInteger)limit;
+
+/**
+ *  Attaches the return addresses of the failing call to each RZAssertFailure, as its @c backtrace. Capturing is much cheaper than +[NSThread callStackSymbols]: symbols are only looked up when you call -[RZAssertBacktrace symbolicateWithCompletion:], and identical stacks are stored once.
+ */
++ (void)enableBacktraces;
+
+/**
+ *  Stops attaching backtraces to failures.
+ */
++ (void)disableBacktraces;
+
 /**
  *  Logs a message using the RZAssert logging handler. For private use only.
  *
@@ -50,9 +468,16 @@
 + (void)logMessage:(NSString *)message;
 
 /**
- *  Whether or not RZAssert is configured with a logger. Used to short-circuit the assertion macros, so they don’t do (much) extra work when assertions are disabled and a logger is not configured.
+ *  Delivers a failure to the RZAssert failure and logging handlers. For private use only.
  *
- *  @return @c YES if there is a logging handler, otherwise @c NO.
+ *  @param failure The failure to deliver.
+ */
++ (void)reportFailure:(RZAssertFailure *)failure;
+
+/**
+ *  Whether or not RZAssert is configured with a logger. The assertion macros use @c RZAssertHasLoggerFast() instead, so they don’t do (much) extra work when assertions are disabled and a logger is not configured.
+ *
+ *  @return @c YES if there is a logging handler, buffered logging handler, failure handler, sink, batch logging handler, crash log, or breadcrumb ring, otherwise @c NO.
  */
 + (BOOL)hasLogger;
 
@@ -60,40 +485,204 @@
 
 #pragma mark - Helpers
 
+// The _WITH_OPERANDS variants take declarations that bind each operand to a local,
+// once the check is known to be enabled. The test and the message then use the locals,
+// so every operand is evaluated exactly once, and not at all if the check is disabled.
+//
+// The _GATED checks also take a gate, evaluated with its own operands once the check is
+// enabled but before anything is timed or counted. An execution the gate turns away
+// counts as though the check were disabled.
+
+// Where a check records that it ran, for RZASSERT_ONCE. RZASSERT_ONCE shadows this
+// with a pointer to its own flag; everywhere else it is a constant NULL, so the
+// store folds away.
+static BOOL *const rzassert_once_checked __attribute__((unused)) = NULL;
+
 // Objective-C Asserts
 #if defined(NS_BLOCK_ASSERTIONS)
-    #define RZASSERT_BASE(test, format, ...) \
+    #define RZASSERT_BASE_CHECK_GATED(kind, expression, required, gateOperands, gate, operands, test, format, ...) \
     do { \
-        if ( [RZAssert hasLogger] ) { \
-            if ( !(test) ) { \
-                [RZAssert logMessage:[NSString stringWithFormat:@"**** Assertion failure in %s, %s:%d\n%@", __PRETTY_FUNCTION__, __FILE__, __LINE__, ([NSString stringWithFormat:format, ##__VA_ARGS__])]]; \
+        RZASSERT_DECLARE_SITE(rzassert_site, kind, expression) \
+        uint64_t rzassert_control = RZAssertControlLoad(); \
+        if ( RZAssertControlAllows(rzassert_control, (required), RZASSERT_CONTROL_LOGGER_BIT | RZASSERT_CONTROL_STATISTICS_BIT | RZASSERT_CONTROL_PROFILING_BIT) ) { \
+            gateOperands \
+            if ( gate ) { \
+                uint64_t rzassert_start = RZAssertProfilerStart(rzassert_control); \
+                operands \
+                BOOL rzassert_failed = !(test); \
+                if ( RZASSERT_UNLIKELY(rzassert_start) ) { \
+                    RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseCondition, rzassert_start); \
+                } \
+                if ( RZASSERT_UNLIKELY(rzassert_control & RZASSERT_CONTROL_STATISTICS_BIT) ) { \
+                    RZAssertStatisticsRecord(&rzassert_site, rzassert_failed); \
+                } \
+                if ( rzassert_once_checked && (!rzassert_failed || (rzassert_control & RZASSERT_CONTROL_LOGGER_BIT)) ) { \
+                    *rzassert_once_checked = YES; \
+                } \
+                if ( RZASSERT_UNLIKELY(rzassert_failed) && (rzassert_control & RZASSERT_CONTROL_LOGGER_BIT) ) { \
+                    uint64_t rzassert_failureStart = RZAssertProfilerStart(rzassert_control); \
+                    if ( RZAssertSiteShouldLog(&rzassert_site) ) { \
+                        RZAssertReportFailure(&rzassert_site, format, ##__VA_ARGS__); \
+                    } \
+                    if ( RZASSERT_UNLIKELY(rzassert_failureStart) ) { \
+                        RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseFailure, rzassert_failureStart); \
+                    } \
+                } \
             } \
         } \
     } while(0);
 #else
-    #define RZASSERT_BASE(test, format, ...) \
+    #define RZASSERT_BASE_CHECK_GATED(kind, expression, required, gateOperands, gate, operands, test, format, ...) \
         do { \
-            NSAssert( (test), format, ##__VA_ARGS__); \
+            RZASSERT_DECLARE_SITE(rzassert_site, kind, expression) \
+            uint64_t rzassert_control = RZAssertControlLoad(); \
+            if ( (rzassert_control & (required)) == (required) ) { \
+                gateOperands \
+                if ( gate ) { \
+                    uint64_t rzassert_start = RZAssertProfilerStart(rzassert_control); \
+                    operands \
+                    BOOL rzassert_failed = !(test); \
+                    if ( RZASSERT_UNLIKELY(rzassert_start) ) { \
+                        RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseCondition, rzassert_start); \
+                    } \
+                    if ( RZASSERT_UNLIKELY(rzassert_control & RZASSERT_CONTROL_STATISTICS_BIT) ) { \
+                        RZAssertStatisticsRecord(&rzassert_site, rzassert_failed); \
+                    } \
+                    if ( rzassert_once_checked ) { \
+                        *rzassert_once_checked = YES; \
+                    } \
+                    uint64_t rzassert_failureStart = rzassert_failed ? RZAssertProfilerStart(rzassert_control) : 0; \
+                    NSAssert( !rzassert_failed, format, ##__VA_ARGS__); \
+                    if ( RZASSERT_UNLIKELY(rzassert_failureStart) ) { \
+                        RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseFailure, rzassert_failureStart); \
+                    } \
+                } \
+            } \
         } while(0);
 #endif
 
+#define RZASSERT_BASE_CHECK(kind, expression, required, operands, test, format, ...) RZASSERT_BASE_CHECK_GATED(kind, expression, required, , YES, operands, test, format, ##__VA_ARGS__)
+
+#define RZASSERT_BASE_WITH_LEVEL(kind, level, category, test, format, ...) RZASSERT_BASE_CHECK(kind, #test, RZASSERT_CONTROL_BIT(level, category), , test, format, ##__VA_ARGS__)
+#define RZASSERT_BASE_WITH_KIND(kind, test, format, ...) RZASSERT_BASE_CHECK(kind, #test, RZASSERT_CONTROL_BIT(RZAssertLevelNormal, RZAssertCategoryDefault), , test, format, ##__VA_ARGS__)
+#define RZASSERT_BASE_WITH_OPERANDS(kind, expression, operands, test, format, ...) RZASSERT_BASE_CHECK(kind, expression, RZASSERT_CONTROL_BIT(RZAssertLevelNormal, RZAssertCategoryDefault), operands, test, format, ##__VA_ARGS__)
+
+#define RZASSERT_BASE(test, format, ...) RZASSERT_BASE_WITH_KIND("RZASSERT_BASE", test, format, ##__VA_ARGS__)
+
 // C Asserts
 #if defined(NS_BLOCK_ASSERTIONS)
-    #define RZCASSERT_BASE(test, format, ...) \
+    #define RZCASSERT_BASE_CHECK_GATED(kind, expression, required, gateOperands, gate, operands, test, format, ...) \
     do { \
-        if ( [RZAssert hasLogger] ) { \
-            if ( !(test) ) { \
-                [RZAssert logMessage:[NSString stringWithFormat:@"**** Assertion failure in %s, %s:%d\n%@", __PRETTY_FUNCTION__, __FILE__, __LINE__, ([NSString stringWithFormat:format, ##__VA_ARGS__])]]; \
+        RZASSERT_DECLARE_SITE(rzassert_site, kind, expression) \
+        uint64_t rzassert_control = RZAssertControlLoad(); \
+        if ( RZAssertControlAllows(rzassert_control, (required), RZASSERT_CONTROL_LOGGER_BIT | RZASSERT_CONTROL_STATISTICS_BIT | RZASSERT_CONTROL_PROFILING_BIT) ) { \
+            gateOperands \
+            if ( gate ) { \
+                uint64_t rzassert_start = RZAssertProfilerStart(rzassert_control); \
+                operands \
+                BOOL rzassert_failed = !(test); \
+                if ( RZASSERT_UNLIKELY(rzassert_start) ) { \
+                    RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseCondition, rzassert_start); \
+                } \
+                if ( RZASSERT_UNLIKELY(rzassert_control & RZASSERT_CONTROL_STATISTICS_BIT) ) { \
+                    RZAssertStatisticsRecord(&rzassert_site, rzassert_failed); \
+                } \
+                if ( rzassert_once_checked && (!rzassert_failed || (rzassert_control & RZASSERT_CONTROL_LOGGER_BIT)) ) { \
+                    *rzassert_once_checked = YES; \
+                } \
+                if ( RZASSERT_UNLIKELY(rzassert_failed) && (rzassert_control & RZASSERT_CONTROL_LOGGER_BIT) ) { \
+                    uint64_t rzassert_failureStart = RZAssertProfilerStart(rzassert_control); \
+                    if ( RZAssertSiteShouldLog(&rzassert_site) ) { \
+                        RZAssertReportFailure(&rzassert_site, format, ##__VA_ARGS__); \
+                    } \
+                    if ( RZASSERT_UNLIKELY(rzassert_failureStart) ) { \
+                        RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseFailure, rzassert_failureStart); \
+                    } \
+                } \
             } \
         } \
     } while(0);
 #else
-    #define RZCASSERT_BASE(test, format, ...) \
+    #define RZCASSERT_BASE_CHECK_GATED(kind, expression, required, gateOperands, gate, operands, test, format, ...) \
         do { \
-            NSCAssert( (test), format, ##__VA_ARGS__); \
+            RZASSERT_DECLARE_SITE(rzassert_site, kind, expression) \
+            uint64_t rzassert_control = RZAssertControlLoad(); \
+            if ( (rzassert_control & (required)) == (required) ) { \
+                gateOperands \
+                if ( gate ) { \
+                    uint64_t rzassert_start = RZAssertProfilerStart(rzassert_control); \
+                    operands \
+                    BOOL rzassert_failed = !(test); \
+                    if ( RZASSERT_UNLIKELY(rzassert_start) ) { \
+                        RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseCondition, rzassert_start); \
+                    } \
+                    if ( RZASSERT_UNLIKELY(rzassert_control & RZASSERT_CONTROL_STATISTICS_BIT) ) { \
+                        RZAssertStatisticsRecord(&rzassert_site, rzassert_failed); \
+                    } \
+                    if ( rzassert_once_checked ) { \
+                        *rzassert_once_checked = YES; \
+                    } \
+                    uint64_t rzassert_failureStart = rzassert_failed ? RZAssertProfilerStart(rzassert_control) : 0; \
+                    NSCAssert( !rzassert_failed, format, ##__VA_ARGS__); \
+                    if ( RZASSERT_UNLIKELY(rzassert_failureStart) ) { \
+                        RZAssertProfilerRecord(&rzassert_site, RZAssertProfilerPhaseFailure, rzassert_failureStart); \
+                    } \
+                } \
+            } \
         } while(0);
 #endif
 
+#define RZCASSERT_BASE_CHECK(kind, expression, required, operands, test, format, ...) RZCASSERT_BASE_CHECK_GATED(kind, expression, required, , YES, operands, test, format, ##__VA_ARGS__)
+
+#define RZCASSERT_BASE_WITH_LEVEL(kind, level, category, test, format, ...) RZCASSERT_BASE_CHECK(kind, #test, RZASSERT_CONTROL_BIT(level, category), , test, format, ##__VA_ARGS__)
+#define RZCASSERT_BASE_WITH_KIND(kind, test, format, ...) RZCASSERT_BASE_CHECK(kind, #test, RZASSERT_CONTROL_BIT(RZAssertLevelNormal, RZAssertCategoryDefault), , test, format, ##__VA_ARGS__)
+#define RZCASSERT_BASE_WITH_OPERANDS(kind, expression, operands, test, format, ...) RZCASSERT_BASE_CHECK(kind, expression, RZASSERT_CONTROL_BIT(RZAssertLevelNormal, RZAssertCategoryDefault), operands, test, format, ##__VA_ARGS__)
+
+#define RZCASSERT_BASE(test, format, ...) RZCASSERT_BASE_WITH_KIND("RZCASSERT_BASE", test, format, ##__VA_ARGS__)
+
+// Numeric Comparisons
+
+/**
+ *  Formats a value into a buffer with snprintf, for failure messages. For private use only.
+ *
+ *  @param buffer The buffer to format into.
+ *  @param size   The size of @c buffer.
+ *  @param format A format with a single conversion, chosen by @c RZASSERT_VALUE_FORMAT().
+ *
+ *  @return @c buffer.
+ */
+FOUNDATION_EXPORT const char *RZAssertDescribeValue(char *buffer, size_t size, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+#define RZASSERT_VALUE_DESCRIPTION_SIZE 48
+
+// Picks the conversion for a value's type at compile time. Floating-point values get enough digits to round-trip.
+#define RZASSERT_VALUE_FORMAT(value) _Generic((value), \
+    _Bool: "%d", \
+    char: "%d", \
+    signed char: "%hhd", \
+    unsigned char: "%hhu", \
+    short: "%hd", \
+    unsigned short: "%hu", \
+    int: "%d", \
+    unsigned int: "%u", \
+    long: "%ld", \
+    unsigned long: "%lu", \
+    long long: "%lld", \
+    unsigned long long: "%llu", \
+    float: "%.9g", \
+    double: "%.17g", \
+    long double: "%.21Lg", \
+    default: "%p")
+
+// Only expanded in the failure branch, so passing comparisons never format anything.
+#define RZASSERT_DESCRIBE_VALUE(value) RZAssertDescribeValue((char[RZASSERT_VALUE_DESCRIPTION_SIZE]){ 0 }, RZASSERT_VALUE_DESCRIPTION_SIZE, RZASSERT_VALUE_FORMAT(value), (value))
+
+#define RZASSERT_COMPARE(kind, comparison, a, b) \
+    RZASSERT_BASE_WITH_OPERANDS( kind, #a " " #comparison " " #b, __typeof__(a) rzassert_left = (a); __typeof__(b) rzassert_right = (b);, (rzassert_left comparison rzassert_right), @"**** Unexpected Comparison Result **** \nExpected: %s " #comparison " %s \nLeft: %s \nRight: %s \nSelf: \"%@\"", #a, #b, RZASSERT_DESCRIBE_VALUE(rzassert_left), RZASSERT_DESCRIBE_VALUE(rzassert_right), self )
+
+#define RZCASSERT_COMPARE(kind, comparison, a, b) \
+    RZCASSERT_BASE_WITH_OPERANDS( kind, #a " " #comparison " " #b, __typeof__(a) rzassert_left = (a); __typeof__(b) rzassert_right = (b);, (rzassert_left comparison rzassert_right), @"**** Unexpected Comparison Result **** \nExpected: %s " #comparison " %s \nLeft: %s \nRight: %s", #a, #b, RZASSERT_DESCRIBE_VALUE(rzassert_left), RZASSERT_DESCRIBE_VALUE(rzassert_right) )
+
 #pragma mark - Basic Assertions
 
 // General Assertions
@@ -106,12 +695,12 @@
 
 #define RZASSERT_NIL(object) \
     do { \
-        RZASSERT_BASE( (object == nil), @"**** Unexpected Nil Assertion **** \nExpected nil, but " #object @" is not nil \nSelf: \"%@\"", self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_NIL", (object == nil), @"**** Unexpected Nil Assertion **** \nExpected nil, but " #object @" is not nil \nSelf: \"%@\"", self ) \
     } while(0)
 
 #define RZCASSERT_NIL(object) \
     do { \
-        RZCASSERT_BASE( (object == nil), @"**** Unexpected Nil Assertion **** \nExpected nil, but " #object @" is not nil" ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_NIL", (object == nil), @"**** Unexpected Nil Assertion **** \nExpected nil, but " #object @" is not nil" ) \
     } while(0)
 
 /**
@@ -122,12 +711,12 @@
 
 #define RZASSERT_NOT_NIL(object) \
     do { \
-        RZASSERT_BASE( ((object) != nil), @"**** Unexpected Non-Nil Assertion **** \nExpected not nil, but " #object @" is nil \nSelf: \"%@\"", self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_NOT_NIL", ((object) != nil), @"**** Unexpected Non-Nil Assertion **** \nExpected not nil, but " #object @" is nil \nSelf: \"%@\"", self ) \
     } while(0)
 
 #define RZCASSERT_NOT_NIL(object) \
     do { \
-        RZCASSERT_BASE( ((object) != nil), @"**** Unexpected Non-Nil Assertion **** \nExpected not nil, but " #object @" is nil" ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_NOT_NIL", ((object) != nil), @"**** Unexpected Non-Nil Assertion **** \nExpected not nil, but " #object @" is nil" ) \
     } while(0)
 
 /**
@@ -136,12 +725,12 @@
 
 #define RZASSERT_ALWAYS \
     do { \
-        RZASSERT_BASE( NO, @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_ALWAYS", NO, @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
     } while(0)
 
 #define RZCASSERT_ALWAYS \
     do { \
-        RZCASSERT_BASE( NO, @"**** Unexpected Assertion ****" ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_ALWAYS", NO, @"**** Unexpected Assertion ****" ) \
     } while(0)
 
 /**
@@ -152,12 +741,12 @@
 
 #define RZASSERT_TRUE(test) \
     do { \
-        RZASSERT_BASE( (test), @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_TRUE", (test), @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
     } while(0)
 
 #define RZCASSERT_TRUE(test) \
     do { \
-        RZCASSERT_BASE( (test), @"**** Unexpected Assertion ****" ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_TRUE", (test), @"**** Unexpected Assertion ****" ) \
     } while(0)
 
 /**
@@ -168,12 +757,12 @@
 
 #define RZASSERT_FALSE(test) \
     do { \
-        RZASSERT_BASE( !(test), @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_FALSE", !(test), @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
     } while(0)
 
 #define RZCASSERT_FALSE(test) \
     do { \
-        RZCASSERT_BASE( !(test), @"**** Unexpected Assertion ****" ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_FALSE", !(test), @"**** Unexpected Assertion ****" ) \
     } while(0)
 
 /**
@@ -184,12 +773,12 @@
 
 #define RZASSERT_WITH_MESSAGE(message, ...) \
     do { \
-        RZASSERT_BASE( NO, @"**** Unexpected Assertion **** %@ \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_WITH_MESSAGE", NO, @"**** Unexpected Assertion **** %@ \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], self ) \
     } while(0)
 
 #define RZCASSERT_WITH_MESSAGE(message, ...) \
     do { \
-        RZCASSERT_BASE( NO, @"**** Unexpected Assertion **** %@", [NSString stringWithFormat:message, ##__VA_ARGS__] ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_WITH_MESSAGE", NO, @"**** Unexpected Assertion **** %@", [NSString stringWithFormat:message, ##__VA_ARGS__] ) \
     } while(0)
 
 /**
@@ -201,12 +790,12 @@
 
 #define RZASSERT_WITH_MESSAGE_LOG(expression, message, ...) \
     do { \
-        RZASSERT_BASE( NO, @"**** Unexpected Assertion **** %@ \nExpression: \"%@\" \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression), self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_WITH_MESSAGE_LOG", NO, @"**** Unexpected Assertion **** %@ \nExpression: \"%@\" \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression), self ) \
     } while(0)
 
 #define RZCASSERT_WITH_MESSAGE_LOG(expression, message, ...) \
     do { \
-        RZCASSERT_BASE( NO, @"**** Unexpected Assertion **** %@ \nExpression: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression) ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_WITH_MESSAGE_LOG", NO, @"**** Unexpected Assertion **** %@ \nExpression: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression) ) \
     } while(0)
 
 /**
@@ -219,12 +808,12 @@
 
 #define RZASSERT_TRUE_WITH_MESSAGE(test, message, ...) \
     do { \
-        RZASSERT_BASE( (test), @"**** Unexpected Assertion **** %@ \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_TRUE_WITH_MESSAGE", (test), @"**** Unexpected Assertion **** %@ \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], self ) \
     } while(0)
 
 #define RZCASSERT_TRUE_WITH_MESSAGE(test, message, ...) \
     do { \
-        RZCASSERT_BASE( (test), @"**** Unexpected Assertion **** %@", [NSString stringWithFormat:message, ##__VA_ARGS__] ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_TRUE_WITH_MESSAGE", (test), @"**** Unexpected Assertion **** %@", [NSString stringWithFormat:message, ##__VA_ARGS__] ) \
     } while(0)
 
 /**
@@ -237,12 +826,12 @@
 
 #define RZASSERT_TRUE_WITH_MESSAGE_LOG(test, expression, message, ...) \
     do { \
-        RZASSERT_BASE( (test), @"**** Unexpected Assertion **** %@ \nReason: \nExpression:\"%@\", \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression), self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_TRUE_WITH_MESSAGE_LOG", (test), @"**** Unexpected Assertion **** %@ \nReason: \nExpression:\"%@\", \nSelf: \"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression), self ) \
     } while(0)
 
 #define RZCASSERT_TRUE_WITH_MESSAGE_LOG(test, expression, message, ...) \
     do { \
-        RZCASSERT_BASE( (test), @"**** Unexpected Assertion **** %@ \nReason: \nExpression:\"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression) ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_TRUE_WITH_MESSAGE_LOG", (test), @"**** Unexpected Assertion **** %@ \nReason: \nExpression:\"%@\"", [NSString stringWithFormat:message, ##__VA_ARGS__], (expression) ) \
     } while(0)
 
 /**
@@ -254,12 +843,109 @@
 
 #define RZASSERT_TRUE_LOG(test, expression) \
     do { \
-        RZASSERT_BASE( (test), @"**** Unexpected Assertion **** \nExpression \"%@\" \nSelf: \"%@\"", (expression), self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_TRUE_LOG", (test), @"**** Unexpected Assertion **** \nExpression \"%@\" \nSelf: \"%@\"", (expression), self ) \
     } while(0)
 
 #define RZCASSERT_TRUE_LOG(test, expression) \
     do { \
-        RZCASSERT_BASE( (test), @"**** Unexpected Assertion **** \nExpression \"%@\"", (expression) ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_TRUE_LOG", (test), @"**** Unexpected Assertion **** \nExpression \"%@\"", (expression) ) \
+    } while(0)
+
+// Leveled Assertions
+
+/**
+ *  Assert that a value is truthy (i.e. nonzero), at a given level and in a given category. The value is evaluated only if that level is enabled for that category.
+ *
+ *  @param level    An RZAssertLevel. Should be a constant.
+ *  @param category A single category, such as @c RZASSERT_CATEGORY(3). Should be a constant.
+ *  @param test     The value to test.
+ */
+
+#define RZASSERT_LEVEL(level, category, test) \
+    do { \
+        RZASSERT_BASE_WITH_LEVEL( "RZASSERT_LEVEL", level, category, (test), @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
+    } while(0)
+
+#define RZCASSERT_LEVEL(level, category, test) \
+    do { \
+        RZCASSERT_BASE_WITH_LEVEL( "RZCASSERT_LEVEL", level, category, (test), @"**** Unexpected Assertion ****" ) \
+    } while(0)
+
+/**
+ *  Assert that a value is truthy (i.e. nonzero), as a cheap check in the default category.
+ *
+ *  @param test The value to test.
+ */
+
+#define RZASSERT_CHEAP(test) \
+    do { \
+        RZASSERT_BASE_WITH_LEVEL( "RZASSERT_CHEAP", RZAssertLevelCheap, RZAssertCategoryDefault, (test), @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
+    } while(0)
+
+#define RZCASSERT_CHEAP(test) \
+    do { \
+        RZCASSERT_BASE_WITH_LEVEL( "RZCASSERT_CHEAP", RZAssertLevelCheap, RZAssertCategoryDefault, (test), @"**** Unexpected Assertion ****" ) \
+    } while(0)
+
+/**
+ *  Assert that a value is truthy (i.e. nonzero), as an expensive check in the default category. Disabled unless enabled with +[RZAssert setEnabledLevel:].
+ *
+ *  @param test The value to test.
+ */
+
+#define RZASSERT_EXPENSIVE(test) \
+    do { \
+        RZASSERT_BASE_WITH_LEVEL( "RZASSERT_EXPENSIVE", RZAssertLevelExpensive, RZAssertCategoryDefault, (test), @"**** Unexpected Assertion **** \nSelf: \"%@\"", self ) \
+    } while(0)
+
+#define RZCASSERT_EXPENSIVE(test) \
+    do { \
+        RZCASSERT_BASE_WITH_LEVEL( "RZCASSERT_EXPENSIVE", RZAssertLevelExpensive, RZAssertCategoryDefault, (test), @"**** Unexpected Assertion ****" ) \
+    } while(0)
+
+// Sampled Assertions
+
+/**
+ *  Assert that a value is truthy (i.e. nonzero), evaluating it on only a fraction of executions. Use for invariants that are too expensive to check every time. The failure message includes the rate, so failure counts can be scaled back up. Statistics and profiling only see the executions that were sampled.
+ *
+ *  @param rate The fraction of executions on which to evaluate @c test, from 0.0 to 1.0.
+ *  @param test The value to test.
+ */
+
+#define RZASSERT_SAMPLED(rate, test) \
+    do { \
+        RZASSERT_BASE_CHECK_GATED( "RZASSERT_SAMPLED", #test, RZASSERT_CONTROL_BIT(RZAssertLevelNormal, RZAssertCategoryDefault), double rzassert_rate = (rate);, RZAssertShouldSample(rzassert_rate), , (test), @"**** Unexpected Sampled Assertion **** \nSampling rate: %g \nSelf: \"%@\"", rzassert_rate, self ) \
+    } while(0)
+
+#define RZCASSERT_SAMPLED(rate, test) \
+    do { \
+        RZCASSERT_BASE_CHECK_GATED( "RZCASSERT_SAMPLED", #test, RZASSERT_CONTROL_BIT(RZAssertLevelNormal, RZAssertCategoryDefault), double rzassert_rate = (rate);, RZAssertShouldSample(rzassert_rate), , (test), @"**** Unexpected Sampled Assertion **** \nSampling rate: %g", rzassert_rate ) \
+    } while(0)
+
+// Once-per-site Assertions
+
+/**
+ *  Evaluate an assertion only until it has been checked once at this call site, for facts that can't change for the life of the process, such as class relationships or build configuration. Every later execution costs one relaxed load. Wrap any RZAssert assertion, such as @c RZASSERT_ONCE(RZASSERT_TRUE(test)).
+ *
+ *  An execution only counts once the wrapped assertion has actually checked its condition and, if the condition failed, reported it. So a check whose level or category is disabled, or that runs with assertions blocked before a logger is configured, is still made later. Threads that race on the first check may each evaluate the assertion.
+ *
+ *  @param ... An assertion.
+ */
+
+#define RZASSERT_ONCE(...) \
+    do { \
+        static uint8_t rzassert_once_done = 0; \
+        if ( RZASSERT_UNLIKELY(!__atomic_load_n(&rzassert_once_done, __ATOMIC_RELAXED)) ) { \
+            BOOL rzassert_once_ran = NO; \
+            _Pragma("clang diagnostic push") \
+            _Pragma("clang diagnostic ignored \"-Wshadow\"") \
+            BOOL *const rzassert_once_checked = &rzassert_once_ran; \
+            _Pragma("clang diagnostic pop") \
+            __VA_ARGS__; \
+            if ( rzassert_once_ran ) { \
+                __atomic_store_n(&rzassert_once_done, 1, __ATOMIC_RELAXED); \
+            } \
+        } \
     } while(0)
 
 # pragma mark - Higher-Level Assertions
@@ -275,12 +961,12 @@
 
 #define RZASSERT_EQUAL_OBJECT_POINTERS(x, y) \
     do { \
-        RZASSERT_BASE( ((x) == (y)), @"**** Object Pointers Unexpectedly Unequal **** \nReason: Left: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", (x), NSStringFromClass([(x) class]), (y), NSStringFromClass([(y) class]) ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_EQUAL_OBJECT_POINTERS", #x ", " #y, id rzassert_left = (x); id rzassert_right = (y);, (rzassert_left == rzassert_right), @"**** Object Pointers Unexpectedly Unequal **** \nReason: Left: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", rzassert_left, NSStringFromClass([rzassert_left class]), rzassert_right, NSStringFromClass([rzassert_right class]) ) \
     } while(0)
 
 #define RZCASSERT_EQUAL_OBJECT_POINTERS(x, y) \
     do { \
-        RZCASSERT_BASE( ((x) == (y)), @"**** Object Pointers Unexpectedly Unequal **** \nReason: Left: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", (x), NSStringFromClass([(x) class]), (y), NSStringFromClass([(y) class]) ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_EQUAL_OBJECT_POINTERS", #x ", " #y, id rzassert_left = (x); id rzassert_right = (y);, (rzassert_left == rzassert_right), @"**** Object Pointers Unexpectedly Unequal **** \nReason: Left: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", rzassert_left, NSStringFromClass([rzassert_left class]), rzassert_right, NSStringFromClass([rzassert_right class]) ) \
     } while(0)
 
 /**
@@ -292,18 +978,132 @@
 
 #define RZASSERT_EQUAL_OBJECTS(x, y) \
     do { \
-        RZASSERT_BASE( ((!(x) && !(y)) || [(x) isEqual:(y)]), @"**** Objects Unexpectedly Unequal **** \nLeft: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", (x), NSStringFromClass([(x) class]), (y), NSStringFromClass([(y) class]) ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_EQUAL_OBJECTS", #x ", " #y, id rzassert_left = (x); id rzassert_right = (y);, ((!rzassert_left && !rzassert_right) || [rzassert_left isEqual:rzassert_right]), @"**** Objects Unexpectedly Unequal **** \nLeft: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", rzassert_left, NSStringFromClass([rzassert_left class]), rzassert_right, NSStringFromClass([rzassert_right class]) ) \
     } while(0)
 
 #define RZCASSERT_EQUAL_OBJECTS(x, y) \
     do { \
-        RZCASSERT_BASE( ((!(x) && !(y)) || [(x) isEqual:(y)]), @"**** Objects Unexpectedly Unequal **** \nLeft: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", (x), NSStringFromClass([(x) class]), (y), NSStringFromClass([(y) class]) ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_EQUAL_OBJECTS", #x ", " #y, id rzassert_left = (x); id rzassert_right = (y);, ((!rzassert_left && !rzassert_right) || [rzassert_left isEqual:rzassert_right]), @"**** Objects Unexpectedly Unequal **** \nLeft: \"%@\" of class \"%@\", Right: \"%@\" of class \"%@\"", rzassert_left, NSStringFromClass([rzassert_left class]), rzassert_right, NSStringFromClass([rzassert_right class]) ) \
+    } while(0)
+
+// Numeric Comparisons
+
+/**
+ *  Assert that two numbers compare as expected. The operands may be of any integer, floating-point or pointer type, and are compared with the operator as written, so the usual arithmetic conversions apply. A passing comparison costs the same as writing it out; the values are only formatted, with a conversion that matches their type, when it fails.
+ *
+ *  @param a A number.
+ *  @param b A number.
+ */
+
+#define RZASSERT_EQ(a, b)   do { RZASSERT_COMPARE( "RZASSERT_EQ", ==, a, b ) } while(0)
+#define RZASSERT_NE(a, b)   do { RZASSERT_COMPARE( "RZASSERT_NE", !=, a, b ) } while(0)
+#define RZASSERT_LT(a, b)   do { RZASSERT_COMPARE( "RZASSERT_LT", <, a, b ) } while(0)
+#define RZASSERT_LE(a, b)   do { RZASSERT_COMPARE( "RZASSERT_LE", <=, a, b ) } while(0)
+#define RZASSERT_GT(a, b)   do { RZASSERT_COMPARE( "RZASSERT_GT", >, a, b ) } while(0)
+#define RZASSERT_GE(a, b)   do { RZASSERT_COMPARE( "RZASSERT_GE", >=, a, b ) } while(0)
+
+#define RZCASSERT_EQ(a, b)  do { RZCASSERT_COMPARE( "RZCASSERT_EQ", ==, a, b ) } while(0)
+#define RZCASSERT_NE(a, b)  do { RZCASSERT_COMPARE( "RZCASSERT_NE", !=, a, b ) } while(0)
+#define RZCASSERT_LT(a, b)  do { RZCASSERT_COMPARE( "RZCASSERT_LT", <, a, b ) } while(0)
+#define RZCASSERT_LE(a, b)  do { RZCASSERT_COMPARE( "RZCASSERT_LE", <=, a, b ) } while(0)
+#define RZCASSERT_GT(a, b)  do { RZCASSERT_COMPARE( "RZCASSERT_GT", >, a, b ) } while(0)
+#define RZCASSERT_GE(a, b)  do { RZCASSERT_COMPARE( "RZCASSERT_GE", >=, a, b ) } while(0)
+
+/**
+ *  Assert that a number lies in a closed range. NaN is never in range.
+ *
+ *  @param value A number.
+ *  @param low   The smallest allowed value.
+ *  @param high  The largest allowed value.
+ */
+
+#define RZASSERT_IN_RANGE(value, low, high) \
+    do { \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_IN_RANGE", #value ", " #low ", " #high, __typeof__(value) rzassert_value = (value); __typeof__(low) rzassert_low = (low); __typeof__(high) rzassert_high = (high);, (rzassert_low <= rzassert_value && rzassert_value <= rzassert_high), @"**** Value Unexpectedly Out of Range **** \nExpected: %s in [%s, %s] \nValue: %s \nRange: [%s, %s] \nSelf: \"%@\"", #value, #low, #high, RZASSERT_DESCRIBE_VALUE(rzassert_value), RZASSERT_DESCRIBE_VALUE(rzassert_low), RZASSERT_DESCRIBE_VALUE(rzassert_high), self ) \
+    } while(0)
+
+#define RZCASSERT_IN_RANGE(value, low, high) \
+    do { \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_IN_RANGE", #value ", " #low ", " #high, __typeof__(value) rzassert_value = (value); __typeof__(low) rzassert_low = (low); __typeof__(high) rzassert_high = (high);, (rzassert_low <= rzassert_value && rzassert_value <= rzassert_high), @"**** Value Unexpectedly Out of Range **** \nExpected: %s in [%s, %s] \nValue: %s \nRange: [%s, %s]", #value, #low, #high, RZASSERT_DESCRIBE_VALUE(rzassert_value), RZASSERT_DESCRIBE_VALUE(rzassert_low), RZASSERT_DESCRIBE_VALUE(rzassert_high) ) \
+    } while(0)
+
+/**
+ *  Assert that two numbers differ by no more than a tolerance. The difference is taken as larger minus smaller, so unsigned operands work too. NaN is never approximately equal to anything.
+ *
+ *  @param a       A number.
+ *  @param b       A number.
+ *  @param epsilon The largest allowed difference.
+ */
+
+#define RZASSERT_APPROX_EQUAL(a, b, epsilon) \
+    do { \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_APPROX_EQUAL", #a ", " #b ", " #epsilon, __typeof__(a) rzassert_left = (a); __typeof__(b) rzassert_right = (b); __typeof__(epsilon) rzassert_epsilon = (epsilon);, ((rzassert_left > rzassert_right ? rzassert_left - rzassert_right : rzassert_right - rzassert_left) <= rzassert_epsilon), @"**** Values Unexpectedly Far Apart **** \nExpected: %s within %s of %s \nLeft: %s \nRight: %s \nEpsilon: %s \nSelf: \"%@\"", #a, #epsilon, #b, RZASSERT_DESCRIBE_VALUE(rzassert_left), RZASSERT_DESCRIBE_VALUE(rzassert_right), RZASSERT_DESCRIBE_VALUE(rzassert_epsilon), self ) \
+    } while(0)
+
+#define RZCASSERT_APPROX_EQUAL(a, b, epsilon) \
+    do { \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_APPROX_EQUAL", #a ", " #b ", " #epsilon, __typeof__(a) rzassert_left = (a); __typeof__(b) rzassert_right = (b); __typeof__(epsilon) rzassert_epsilon = (epsilon);, ((rzassert_left > rzassert_right ? rzassert_left - rzassert_right : rzassert_right - rzassert_left) <= rzassert_epsilon), @"**** Values Unexpectedly Far Apart **** \nExpected: %s within %s of %s \nLeft: %s \nRight: %s \nEpsilon: %s", #a, #epsilon, #b, RZASSERT_DESCRIBE_VALUE(rzassert_left), RZASSERT_DESCRIBE_VALUE(rzassert_right), RZASSERT_DESCRIBE_VALUE(rzassert_epsilon) ) \
+    } while(0)
+
+// Buffer Assertions
+
+/**
+ *  Assert that every element of a buffer of floats or doubles is finite: neither infinite nor NaN. The buffer is scanned with vector instructions; on failure, the first bad index and its value are reported.
+ *
+ *  @param values A pointer to, or an array of, float or double.
+ *  @param count  The number of elements to check.
+ */
+
+#define RZASSERT_ALL_FINITE(values, count) \
+    do { \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_ALL_FINITE", #values ", " #count, __typeof__(&(values)[0]) rzassert_values = (values); size_t rzassert_count = (count); size_t rzassert_index = RZASSERT_FIRST_NON_FINITE(rzassert_values, rzassert_count);, (rzassert_index == rzassert_count), @"**** Buffer Unexpectedly Not Finite **** \nExpected: all %zu elements of %s finite \nIndex: %zu \nValue: %s \nSelf: \"%@\"", rzassert_count, #values, rzassert_index, RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index]), self ) \
+    } while(0)
+
+#define RZCASSERT_ALL_FINITE(values, count) \
+    do { \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_ALL_FINITE", #values ", " #count, __typeof__(&(values)[0]) rzassert_values = (values); size_t rzassert_count = (count); size_t rzassert_index = RZASSERT_FIRST_NON_FINITE(rzassert_values, rzassert_count);, (rzassert_index == rzassert_count), @"**** Buffer Unexpectedly Not Finite **** \nExpected: all %zu elements of %s finite \nIndex: %zu \nValue: %s", rzassert_count, #values, rzassert_index, RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index]) ) \
+    } while(0)
+
+/**
+ *  Assert that every element of a buffer of floats, doubles or ints lies in a closed range. The bounds are converted to the element type. NaN is never in range.
+ *
+ *  @param values A pointer to, or an array of, float, double or int.
+ *  @param count  The number of elements to check.
+ *  @param low    The smallest allowed value.
+ *  @param high   The largest allowed value.
+ */
+
+#define RZASSERT_ALL_IN_RANGE(values, count, low, high) \
+    do { \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_ALL_IN_RANGE", #values ", " #count ", " #low ", " #high, __typeof__(&(values)[0]) rzassert_values = (values); size_t rzassert_count = (count); __typeof__((values)[0]) rzassert_low = (low); __typeof__((values)[0]) rzassert_high = (high); size_t rzassert_index = RZASSERT_FIRST_OUT_OF_RANGE(rzassert_values, rzassert_count, rzassert_low, rzassert_high);, (rzassert_index == rzassert_count), @"**** Buffer Unexpectedly Out of Range **** \nExpected: all %zu elements of %s in [%s, %s] \nIndex: %zu \nValue: %s \nRange: [%s, %s] \nSelf: \"%@\"", rzassert_count, #values, #low, #high, rzassert_index, RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index]), RZASSERT_DESCRIBE_VALUE(rzassert_low), RZASSERT_DESCRIBE_VALUE(rzassert_high), self ) \
+    } while(0)
+
+#define RZCASSERT_ALL_IN_RANGE(values, count, low, high) \
+    do { \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_ALL_IN_RANGE", #values ", " #count ", " #low ", " #high, __typeof__(&(values)[0]) rzassert_values = (values); size_t rzassert_count = (count); __typeof__((values)[0]) rzassert_low = (low); __typeof__((values)[0]) rzassert_high = (high); size_t rzassert_index = RZASSERT_FIRST_OUT_OF_RANGE(rzassert_values, rzassert_count, rzassert_low, rzassert_high);, (rzassert_index == rzassert_count), @"**** Buffer Unexpectedly Out of Range **** \nExpected: all %zu elements of %s in [%s, %s] \nIndex: %zu \nValue: %s \nRange: [%s, %s]", rzassert_count, #values, #low, #high, rzassert_index, RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index]), RZASSERT_DESCRIBE_VALUE(rzassert_low), RZASSERT_DESCRIBE_VALUE(rzassert_high) ) \
+    } while(0)
+
+/**
+ *  Assert that a buffer of floats, doubles or ints is in ascending order. Repeated values are allowed; NaN is always out of order. On failure, the first element that is smaller than the one before it is reported, along with its predecessor.
+ *
+ *  @param values A pointer to, or an array of, float, double or int.
+ *  @param count  The number of elements to check.
+ */
+
+#define RZASSERT_SORTED(values, count) \
+    do { \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_SORTED", #values ", " #count, __typeof__(&(values)[0]) rzassert_values = (values); size_t rzassert_count = (count); size_t rzassert_index = RZASSERT_FIRST_UNSORTED(rzassert_values, rzassert_count);, (rzassert_index == rzassert_count), @"**** Buffer Unexpectedly Unsorted **** \nExpected: all %zu elements of %s in ascending order \nIndex: %zu \nValue: %s \nPrevious: %s \nSelf: \"%@\"", rzassert_count, #values, rzassert_index, RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index]), RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index - 1]), self ) \
+    } while(0)
+
+#define RZCASSERT_SORTED(values, count) \
+    do { \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_SORTED", #values ", " #count, __typeof__(&(values)[0]) rzassert_values = (values); size_t rzassert_count = (count); size_t rzassert_index = RZASSERT_FIRST_UNSORTED(rzassert_values, rzassert_count);, (rzassert_index == rzassert_count), @"**** Buffer Unexpectedly Unsorted **** \nExpected: all %zu elements of %s in ascending order \nIndex: %zu \nValue: %s \nPrevious: %s", rzassert_count, #values, rzassert_index, RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index]), RZASSERT_DESCRIBE_VALUE(rzassert_values[rzassert_index - 1]) ) \
     } while(0)
 
 // String Assertions
 
 /**
- *  Assert that x and y are equal strings. -isEqualToString: is used to determine equality.
+ *  Assert that x and y are equal strings, or both nil. Equality is the same as -isEqualToString:, but identical pointers and different lengths are decided without reading the strings, and the contents are compared with vector instructions. The failure message shows the offset of the first difference and a short window of each string around it, rather than both whole strings.
  *
  *  @param x     An NSString instance.
  *  @param y     An NSString instance.
@@ -311,12 +1111,12 @@
 
 #define RZASSERT_EQUAL_STRINGS(x, y) \
     do { \
-        RZASSERT_BASE( ((!(x) && !(y)) || [(x) isEqualToString:(y)]), @"**** Strings Unexpectedly Unequal **** \nLeft: \"%@\"\nRight: \"%@\"", (x), (y) ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_EQUAL_STRINGS", #x ", " #y, id rzassert_left = (x); id rzassert_right = (y);, (RZAssertStringsEqual(rzassert_left, rzassert_right)), @"**** Strings Unexpectedly Unequal **** \n%@", RZAssertDescribeStringDifference(rzassert_left, rzassert_right) ) \
     } while(0)
 
 #define RZCASSERT_EQUAL_STRINGS(x, y) \
     do { \
-        RZCASSERT_BASE( ((!(x) && !(y)) || [(x) isEqualToString:(y)]), @"**** Strings Unexpectedly Unequal **** \nLeft: \"%@\"\nRight: \"%@\"", (x), (y) ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_EQUAL_STRINGS", #x ", " #y, id rzassert_left = (x); id rzassert_right = (y);, (RZAssertStringsEqual(rzassert_left, rzassert_right)), @"**** Strings Unexpectedly Unequal **** \n%@", RZAssertDescribeStringDifference(rzassert_left, rzassert_right) ) \
     } while(0)
 
 /**
@@ -327,18 +1127,18 @@
 
 #define RZASSERT_NONEMPTY_STRING(string) \
     do { \
-        RZASSERT_BASE( ((string) != nil && [(string) isKindOfClass:[NSString class]] && [(string) length] > 0), @"**** Unexpected Nil, Wrong Class, or Empty String **** \nReason: Expected non-empty string but got: \"%@\" \nSelf: \"%@\"", (string), self ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_NONEMPTY_STRING", #string, id rzassert_string = (string);, (rzassert_string != nil && [rzassert_string isKindOfClass:[NSString class]] && [rzassert_string length] > 0), @"**** Unexpected Nil, Wrong Class, or Empty String **** \nReason: Expected non-empty string but got: \"%@\" \nSelf: \"%@\"", rzassert_string, self ) \
     } while(0)
 
 #define RZCASSERT_NONEMPTY_STRING(string) \
     do { \
-        RZCASSERT_BASE( ((string) != nil && [(string) isKindOfClass:[NSString class]] && [(string) length] > 0), @"**** Unexpected Nil, Wrong Class, or Empty String **** \nReason: Expected non-empty string but got: \"%@\"", string ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_NONEMPTY_STRING", #string, id rzassert_string = (string);, (rzassert_string != nil && [rzassert_string isKindOfClass:[NSString class]] && [rzassert_string length] > 0), @"**** Unexpected Nil, Wrong Class, or Empty String **** \nReason: Expected non-empty string but got: \"%@\"", rzassert_string ) \
     } while(0)
 
 // Type Checks
 
 /**
- *  Assert that an object is an instance of TestClass.
+ *  Assert that an object is an instance of TestClass. Each expansion remembers the last few classes that passed it, so checking another instance of one of them costs a pointer compare rather than a walk up the superclass chain. See @c RZAssertInvalidateClassCaches() if you dispose of classes at runtime.
  *
  *  @param object        An object.
  *  @param TestClass     A class. May be passed as either TestClass or [TestClass class].
@@ -346,16 +1146,16 @@
 
 #define RZASSERT_KINDOF(object, TestClass) \
     do { \
-        RZASSERT_BASE( ([(object) isKindOfClass:[TestClass class]]), @"**** Object of Unexpected Class **** \nReason: Expected class: \"%@\" but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), (object), NSStringFromClass([(object) class]) ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_KINDOF", #object ", " #TestClass, id rzassert_object = (object); static RZAssertClassCache rzassert_classCache = RZASSERT_CLASS_CACHE_INITIALIZER;, (RZAssertIsKindOfClassCached(&rzassert_classCache, rzassert_object, [TestClass class])), @"**** Object of Unexpected Class **** \nReason: Expected class: \"%@\" but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), rzassert_object, NSStringFromClass([rzassert_object class]) ) \
     } while(0)
 
 #define RZCASSERT_KINDOF(object, TestClass) \
     do { \
-        RZCASSERT_BASE( ([(object) isKindOfClass:[TestClass class]]), @"**** Object of Unexpected Class **** \nReason: Expected class: \"%@\" but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), (object), NSStringFromClass([(object) class]) ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_KINDOF", #object ", " #TestClass, id rzassert_object = (object); static RZAssertClassCache rzassert_classCache = RZASSERT_CLASS_CACHE_INITIALIZER;, (RZAssertIsKindOfClassCached(&rzassert_classCache, rzassert_object, [TestClass class])), @"**** Object of Unexpected Class **** \nReason: Expected class: \"%@\" but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), rzassert_object, NSStringFromClass([rzassert_object class]) ) \
     } while(0)
 
 /**
- *  Assert that an object is either and instance of TestClass, or is nil.
+ *  Assert that an object is either and instance of TestClass, or is nil. Cached like @c RZASSERT_KINDOF.
  *
  *  @param object        An object.
  *  @param TestClass     A class. May be passed as either TestClass or [TestClass class].
@@ -363,16 +1163,51 @@
 
 #define RZASSERT_KINDOF_OR_NIL(object, TestClass) \
     do { \
-        RZASSERT_BASE( ([(object) isKindOfClass:[TestClass class]] || (object) == nil), @"**** Object of Unexpected Class and Not Nil **** \nReason: Expected class: \"%@\" or nil but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), (object), NSStringFromClass([(object) class]) ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_KINDOF_OR_NIL", #object ", " #TestClass, id rzassert_object = (object); static RZAssertClassCache rzassert_classCache = RZASSERT_CLASS_CACHE_INITIALIZER;, (rzassert_object == nil || RZAssertIsKindOfClassCached(&rzassert_classCache, rzassert_object, [TestClass class])), @"**** Object of Unexpected Class and Not Nil **** \nReason: Expected class: \"%@\" or nil but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), rzassert_object, NSStringFromClass([rzassert_object class]) ) \
     } while(0)
 
 #define RZCASSERT_KINDOF_OR_NIL(object, TestClass) \
     do { \
-        RZCASSERT_BASE( ([(object) isKindOfClass:[TestClass class]] || (object) == nil), @"**** Object of Unexpected Class and Not Nil **** \nReason: Expected class: \"%@\" or nil but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), (object), NSStringFromClass([(object) class]) ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_KINDOF_OR_NIL", #object ", " #TestClass, id rzassert_object = (object); static RZAssertClassCache rzassert_classCache = RZASSERT_CLASS_CACHE_INITIALIZER;, (rzassert_object == nil || RZAssertIsKindOfClassCached(&rzassert_classCache, rzassert_object, [TestClass class])), @"**** Object of Unexpected Class and Not Nil **** \nReason: Expected class: \"%@\" or nil but got: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), rzassert_object, NSStringFromClass([rzassert_object class]) ) \
     } while(0)
 
 /**
- *  Assert that an object's class conforms to a protocol.
+ *  Assert that every element of a collection is an instance of TestClass. Elements whose class already passed are checked with a pointer compare, so a homogeneous collection costs one compare per element. A nil or empty collection passes. On failure, the index of the first bad element, in enumeration order, is reported.
+ *
+ *  @param collection    An array, set, or other fast-enumerable collection.
+ *  @param TestClass     A class. May be passed as either TestClass or [TestClass class].
+ */
+
+#define RZASSERT_ALL_KINDOF(collection, TestClass) \
+    do { \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_ALL_KINDOF", #collection ", " #TestClass, id<NSFastEnumeration> rzassert_collection = (collection); NSUInteger rzassert_index = 0; id rzassert_object = nil;, (RZAssertAllKindOfClass(rzassert_collection, [TestClass class], &rzassert_index, &rzassert_object)), @"**** Collection Element of Unexpected Class **** \nReason: Expected class: \"%@\" but element %lu is: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), (unsigned long)rzassert_index, rzassert_object, NSStringFromClass([rzassert_object class]) ) \
+    } while(0)
+
+#define RZCASSERT_ALL_KINDOF(collection, TestClass) \
+    do { \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_ALL_KINDOF", #collection ", " #TestClass, id<NSFastEnumeration> rzassert_collection = (collection); NSUInteger rzassert_index = 0; id rzassert_object = nil;, (RZAssertAllKindOfClass(rzassert_collection, [TestClass class], &rzassert_index, &rzassert_object)), @"**** Collection Element of Unexpected Class **** \nReason: Expected class: \"%@\" but element %lu is: \"%@\" of class \"%@\"", NSStringFromClass([TestClass class]), (unsigned long)rzassert_index, rzassert_object, NSStringFromClass([rzassert_object class]) ) \
+    } while(0)
+
+/**
+ *  Assert that every key of a dictionary is an instance of KeyClass, and every value an instance of ValueClass. Checked the same way as @c RZASSERT_ALL_KINDOF. On failure, the key of the first bad entry is reported.
+ *
+ *  @param dictionary    A dictionary.
+ *  @param KeyClass      A class for the keys. May be passed as either KeyClass or [KeyClass class].
+ *  @param ValueClass    A class for the values. May be passed as either ValueClass or [ValueClass class].
+ */
+
+#define RZASSERT_ALL_KEYS_VALUES_KINDOF(dictionary, KeyClass, ValueClass) \
+    do { \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_ALL_KEYS_VALUES_KINDOF", #dictionary ", " #KeyClass ", " #ValueClass, NSDictionary *rzassert_dictionary = (dictionary); id rzassert_key = nil; id rzassert_object = nil;, (RZAssertAllKeysAndValuesKindOfClasses(rzassert_dictionary, [KeyClass class], [ValueClass class], &rzassert_key, &rzassert_object)), @"**** Dictionary Entry of Unexpected Class **** \nReason: Expected keys of class: \"%@\" and values of class: \"%@\" but at key: \"%@\" got: \"%@\" of class \"%@\"", NSStringFromClass([KeyClass class]), NSStringFromClass([ValueClass class]), rzassert_key, rzassert_object, NSStringFromClass([rzassert_object class]) ) \
+    } while(0)
+
+#define RZCASSERT_ALL_KEYS_VALUES_KINDOF(dictionary, KeyClass, ValueClass) \
+    do { \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_ALL_KEYS_VALUES_KINDOF", #dictionary ", " #KeyClass ", " #ValueClass, NSDictionary *rzassert_dictionary = (dictionary); id rzassert_key = nil; id rzassert_object = nil;, (RZAssertAllKeysAndValuesKindOfClasses(rzassert_dictionary, [KeyClass class], [ValueClass class], &rzassert_key, &rzassert_object)), @"**** Dictionary Entry of Unexpected Class **** \nReason: Expected keys of class: \"%@\" and values of class: \"%@\" but at key: \"%@\" got: \"%@\" of class \"%@\"", NSStringFromClass([KeyClass class]), NSStringFromClass([ValueClass class]), rzassert_key, rzassert_object, NSStringFromClass([rzassert_object class]) ) \
+    } while(0)
+
+/**
+ *  Assert that an object's class conforms to a protocol. Classes that passed are remembered in a process-wide, lock-free cache, so checking another instance of one of them is a hash lookup rather than a walk of the protocol lists of its class hierarchy. See @c RZAssertInvalidateClassCaches() for when the cache must be cleared.
  *
  *  @param object        An object.
  *  @param protocol      A protocol to use to test the object. Pass as @protocol(someProtocol)
@@ -380,29 +1215,46 @@
 
 #define RZASSERT_CONFORMS_PROTOCOL(object, protocol) \
     do { \
-        RZASSERT_BASE( ([(object) conformsToProtocol:protocol]), @"**** Object Unexpectedly Doesn't Conform to Protocol **** \nReason: Expected object: \"%@\" of class \"%@\" to conform to protocol \"%@\", but it does not.", (object), NSStringFromClass([(object) class]), NSStringFromProtocol(protocol) ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_CONFORMS_PROTOCOL", #object ", " #protocol, id rzassert_object = (object); Protocol *rzassert_protocol = (protocol);, (RZAssertConformsToProtocolCached(rzassert_object, rzassert_protocol)), @"**** Object Unexpectedly Doesn't Conform to Protocol **** \nReason: Expected object: \"%@\" of class \"%@\" to conform to protocol \"%@\", but it does not.", rzassert_object, NSStringFromClass([rzassert_object class]), NSStringFromProtocol(rzassert_protocol) ) \
     } while(0)
 
 #define RZCASSERT_CONFORMS_PROTOCOL(object, protocol) \
     do { \
-        RZCASSERT_BASE( ([(object) conformsToProtocol:protocol]), @"**** Object Unexpectedly Doesn't Conform to Protocol **** \nReason: Expected object: \"%@\" of class \"%@\" to conform to protocol \"%@\", but it does not.", (object), NSStringFromClass([(object) class]), NSStringFromProtocol(protocol) ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_CONFORMS_PROTOCOL", #object ", " #protocol, id rzassert_object = (object); Protocol *rzassert_protocol = (protocol);, (RZAssertConformsToProtocolCached(rzassert_object, rzassert_protocol)), @"**** Object Unexpectedly Doesn't Conform to Protocol **** \nReason: Expected object: \"%@\" of class \"%@\" to conform to protocol \"%@\", but it does not.", rzassert_object, NSStringFromClass([rzassert_object class]), NSStringFromProtocol(rzassert_protocol) ) \
     } while(0)
 
 /**
- *  Assert that a class is a subclass of another class.
+ *  Assert that a class is a subclass of another class. Class relationships can't change, so the check is only made the first time each call site runs, as with @c RZASSERT_ONCE. Use @c RZASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME if the classes vary between calls.
  *
  *  @param Subclass        A subclass.
  *  @param Superclass     A superclass.
  */
 
 #define RZASSERT_CLASS_SUBCLASS_OF_CLASS(Subclass, Superclass) \
+    RZASSERT_ONCE( \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_CLASS_SUBCLASS_OF_CLASS", #Subclass ", " #Superclass, Class rzassert_subclass = [Subclass class]; Class rzassert_superclass = [Superclass class];, ([rzassert_subclass isSubclassOfClass:rzassert_superclass]), @"**** Bad Subclass Relationship **** \nReason: Expected class: \"%@\" to be a subclass of class: \"%@\", but it is not.", rzassert_subclass, rzassert_superclass ) \
+    )
+
+#define RZCASSERT_CLASS_SUBCLASS_OF_CLASS(Subclass, Superclass) \
+    RZASSERT_ONCE( \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_CLASS_SUBCLASS_OF_CLASS", #Subclass ", " #Superclass, Class rzassert_subclass = [Subclass class]; Class rzassert_superclass = [Superclass class];, ([rzassert_subclass isSubclassOfClass:rzassert_superclass]), @"**** Bad Subclass Relationship **** \nReason: Expected class: \"%@\" to be a subclass of class: \"%@\", but it is not.", rzassert_subclass, rzassert_superclass ) \
+    )
+
+/**
+ *  Assert that a class is a subclass of another class, checking on every call.
+ *
+ *  @param Subclass        A subclass.
+ *  @param Superclass     A superclass.
+ */
+
+#define RZASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME(Subclass, Superclass) \
     do { \
-        RZASSERT_BASE( ([[Subclass class] isSubclassOfClass:[Superclass class]]), @"**** Bad Subclass Relationship **** \nReason: Expected class: \"%@\" to be a subclass of class: \"%@\", but it is not.", [Subclass class], [Superclass class] ) \
+        RZASSERT_BASE_WITH_OPERANDS( "RZASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME", #Subclass ", " #Superclass, Class rzassert_subclass = [Subclass class]; Class rzassert_superclass = [Superclass class];, ([rzassert_subclass isSubclassOfClass:rzassert_superclass]), @"**** Bad Subclass Relationship **** \nReason: Expected class: \"%@\" to be a subclass of class: \"%@\", but it is not.", rzassert_subclass, rzassert_superclass ) \
     } while(0)
 
-#define RZCASSERT_CLASS_SUBCLASS_OF_CLASS(Subclass, Superclass) \
+#define RZCASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME(Subclass, Superclass) \
     do { \
-        RZCASSERT_BASE( ([[Subclass class] isSubclassOfClass:[Superclass class]]), @"**** Bad Subclass Relationship **** \nReason: Expected class: \"%@\" to be a subclass of class: \"%@\", but it is not.", [Subclass class], [Superclass class] ) \
+        RZCASSERT_BASE_WITH_OPERANDS( "RZCASSERT_CLASS_SUBCLASS_OF_CLASS_EVERY_TIME", #Subclass ", " #Superclass, Class rzassert_subclass = [Subclass class]; Class rzassert_superclass = [Superclass class];, ([rzassert_subclass isSubclassOfClass:rzassert_superclass]), @"**** Bad Subclass Relationship **** \nReason: Expected class: \"%@\" to be a subclass of class: \"%@\", but it is not.", rzassert_subclass, rzassert_superclass ) \
     } while(0)
 
 // Overrides
@@ -416,7 +1268,7 @@
 
 #define RZASSERT_SUBCLASSES_MUST_OVERRIDE \
     do { \
-        RZASSERT_BASE( NO, @"**** Subclass Responsibility Assertion **** \nReason: Subclasses of %@ MUST override this method: %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd) ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_SUBCLASSES_MUST_OVERRIDE", NO, @"**** Subclass Responsibility Assertion **** \nReason: Subclasses of %@ MUST override this method: %@", NSStringFromClass([self class]), NSStringFromSelector(_cmd) ) \
     } while(0)
 
 // No RZCASSERT_SUBCLASSES_MUST_OVERRIDE variant. It wouldn't make sense.
@@ -429,10 +1281,10 @@
 
 #define RZASSERT_SHOULD_NEVER_GET_HERE \
     do { \
-        RZASSERT_BASE( NO, @"**** Assertion: Should Never Get Here **** \nSelf: \"%@\"", self ) \
+        RZASSERT_BASE_WITH_KIND( "RZASSERT_SHOULD_NEVER_GET_HERE", NO, @"**** Assertion: Should Never Get Here **** \nSelf: \"%@\"", self ) \
     } while(0)
 
 #define RZCASSERT_SHOULD_NEVER_GET_HERE \
     do { \
-        RZCASSERT_BASE( NO, @"**** Assertion: Should Never Get Here ****" ) \
+        RZCASSERT_BASE_WITH_KIND( "RZCASSERT_SHOULD_NEVER_GET_HERE", NO, @"**** Assertion: Should Never Get Here ****" ) \
     } while(0)
@@ -27,13 +27,255 @@
 //
 
 #import "RZAssert.h"
+#import "RZAssertAsyncLogger.h"
+#import "RZAssertBatchLogger.h"
+#import "RZAssertBreadcrumbs.h"
+#import "RZAssertCrashLog.h"
+#import "RZAssertSinkRegistry.h"
+
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#include <mach-o/dyld.h>
+#include <mach-o/getsect.h>
+#else
+#include <time.h>
+#endif
+
+#include <pthread.h>
 
 @interface RZAssert ()
 
-@property (copy, nonatomic) void (^loggingHandler)(NSString *message);
+// Only touched under @synchronized(sharedInstance). Failing threads read the published sink list instead.
+@property (strong, nonatomic) RZAssertSink *failureSink;
+@property (strong, nonatomic) RZAssertSink *loggingSink;
+@property (strong, nonatomic) RZAssertSink *bufferedLoggingSink;
+@property (strong, nonatomic) NSMutableArray *sinks;
+
+// Atomic, because failing threads read it while +enableAsynchronousLogging… swaps it.
+@property (strong, atomic) RZAssertAsyncLogger *asyncLogger;
+@property (strong, atomic) RZAssertCrashLog *crashLog;
+@property (strong, atomic) RZAssertBatchLogger *batchLogger;
 
 @end
 
+// Cheap and normal assertions are enabled in every category, and no logger is configured.
+#define RZASSERT_CONTROL_DEFAULT (RZASSERT_CONTROL_BIT(RZAssertLevelCheap, RZAssertCategoryAll) | RZASSERT_CONTROL_BIT(RZAssertLevelNormal, RZAssertCategoryAll))
+
+uint64_t RZAssertControlWord = RZASSERT_CONTROL_DEFAULT;
+
+static const NSUInteger kRZAssertDefaultMaximumBatchSize = 64;
+static const NSTimeInterval kRZAssertDefaultFlushInterval = 1.0;
+
+static void RZAssertFlushAtExit(void)
+{
+    [RZAssert flush];
+}
+
+// 0 means no rate limit.
+static uint64_t s_rateLimitMaximumMessages = 0;
+static uint64_t s_rateLimitInterval = 0;
+
+// A site's window word holds the window's start, in milliseconds, above a count of
+// the failures in it, which saturates so it can never carry into the start.
+static const unsigned int kRZAssertWindowCountBits = 24;
+static const uint64_t kRZAssertWindowCountMask = (1ull << kRZAssertWindowCountBits) - 1;
+static const uint64_t kRZAssertWindowStartMask = (1ull << (64 - kRZAssertWindowCountBits)) - 1;
+static const NSUInteger kRZAssertRateLimitMaximumMessages = (NSUInteger)kRZAssertWindowCountMask - 1;
+
+#pragma mark - Time
+
+static uint64_t RZAssertCurrentTime(void)
+{
+#if defined(__APPLE__)
+    static mach_timebase_info_data_t s_timebase;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        mach_timebase_info(&s_timebase);
+    });
+
+    return mach_absolute_time() * s_timebase.numer / s_timebase.denom;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return ((uint64_t)now.tv_sec * NSEC_PER_SEC) + (uint64_t)now.tv_nsec;
+#endif
+}
+
+#pragma mark - Call Sites
+
+#if defined(__APPLE__)
+
+#if defined(__LP64__)
+typedef struct mach_header_64 RZAssertMachHeader;
+#else
+typedef struct mach_header RZAssertMachHeader;
+#endif
+
+static void RZAssertEnumerateSiteEntries(void (^block)(RZAssertSite *const *entries, size_t count))
+{
+    uint32_t imageCount = _dyld_image_count();
+
+    for ( uint32_t i = 0; i < imageCount; i++ ) {
+        const RZAssertMachHeader *header = (const RZAssertMachHeader *)_dyld_get_image_header(i);
+        unsigned long size = 0;
+        uint8_t *entries = getsectiondata(header, "__DATA", "__rzassert_sites", &size);
+
+        if ( entries && size > 0 ) {
+            block((RZAssertSite *const *)entries, size / sizeof(RZAssertSite *));
+        }
+    }
+}
+
+#else
+
+// The linker defines these for any section whose name is a valid C identifier.
+extern RZAssertSite *__start_rzassert_sites[] __attribute__((weak, visibility("hidden")));
+extern RZAssertSite *__stop_rzassert_sites[] __attribute__((weak, visibility("hidden")));
+
+static void RZAssertEnumerateSiteEntries(void (^block)(RZAssertSite *const *entries, size_t count))
+{
+    if ( __start_rzassert_sites && __stop_rzassert_sites ) {
+        block(__start_rzassert_sites, (size_t)(__stop_rzassert_sites - __start_rzassert_sites));
+    }
+}
+
+#endif
+
+#pragma mark - Control Word
+
+static void RZAssertUpdateControlWord(uint64_t clearBits, uint64_t setBits)
+{
+    uint64_t expected = __atomic_load_n(&RZAssertControlWord, __ATOMIC_RELAXED);
+    uint64_t desired;
+
+    do {
+        desired = (expected & ~clearBits) | setBits;
+    } while ( !__atomic_compare_exchange_n(&RZAssertControlWord, &expected, desired, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED) );
+}
+
+#pragma mark - Sampling
+
+static pthread_key_t s_samplingKey;
+static pthread_once_t s_samplingKeyOnce = PTHREAD_ONCE_INIT;
+
+static uint64_t RZAssertSamplingSeed(void)
+{
+    static uint64_t s_seedCounter = 0;
+
+    // splitmix64 over a process-wide counter mixed with the time, so every thread gets a distinct, well-spread seed.
+    uint64_t seed = __atomic_add_fetch(&s_seedCounter, 0x9e3779b97f4a7c15ull, __ATOMIC_RELAXED) ^ RZAssertCurrentTime();
+    seed = (seed ^ (seed >> 30)) * 0xbf58476d1ce4e5b9ull;
+    seed = (seed ^ (seed >> 27)) * 0x94d049bb133111ebull;
+    seed ^= seed >> 31;
+
+    return seed ?: 1;
+}
+
+static void RZAssertSamplingKeyCreate(void)
+{
+    pthread_key_create(&s_samplingKey, free);
+}
+
+uint64_t *RZAssertSamplingState(void)
+{
+    pthread_once(&s_samplingKeyOnce, RZAssertSamplingKeyCreate);
+
+    uint64_t *state = pthread_getspecific(s_samplingKey);
+    if ( RZASSERT_UNLIKELY(state == NULL) ) {
+        state = malloc(sizeof(uint64_t));
+        *state = RZAssertSamplingSeed();
+        pthread_setspecific(s_samplingKey, state);
+    }
+
+    return state;
+}
+
+#pragma mark - Comparisons
+
+const char *RZAssertDescribeValue(char *buffer, size_t size, const char *format, ...)
+{
+    va_list arguments;
+    va_start(arguments, format);
+    vsnprintf(buffer, size, format, arguments);
+    va_end(arguments);
+
+    return buffer;
+}
+
+#pragma mark - Rate Limiting
+
+static void RZAssertSiteLogSuppressedSummary(RZAssertSite *site, uint64_t interval)
+{
+    uint64_t suppressedCount = __atomic_exchange_n(&site->suppressedCount, 0, __ATOMIC_ACQ_REL);
+
+    if ( suppressedCount > 0 ) {
+        NSString *fileName = [@(site->file) lastPathComponent];
+        NSString *count = [NSNumberFormatter localizedStringFromNumber:@(suppressedCount) numberStyle:NSNumberFormatterDecimalStyle];
+
+        [RZAssert logMessage:[NSString stringWithFormat:@"**** Assertion failures suppressed **** \nsuppressed %@ repeats of %@:%d in the last %gs", count, fileName, site->line, (double)interval / NSEC_PER_SEC]];
+    }
+}
+
+BOOL RZAssertSiteShouldLog(RZAssertSite *site)
+{
+    uint64_t maximumMessages = __atomic_load_n(&s_rateLimitMaximumMessages, __ATOMIC_RELAXED);
+    if ( maximumMessages == 0 ) {
+        return YES;
+    }
+
+    // A fixed window rather than a token bucket: the summary covers exactly the failures of
+    // one window, and the whole state fits in a single compare-and-swap.
+    uint64_t interval = __atomic_load_n(&s_rateLimitInterval, __ATOMIC_RELAXED);
+    uint64_t intervalMilliseconds = MAX(interval / NSEC_PER_MSEC, 1);
+    uint64_t now = RZAssertCurrentTime();
+    uint64_t nowMilliseconds = (now / NSEC_PER_MSEC) & kRZAssertWindowStartMask;
+
+    uint64_t window = __atomic_load_n(&site->window, __ATOMIC_ACQUIRE);
+    uint64_t windowStart;
+    uint64_t windowCount;
+
+    for ( ;; ) {
+        windowStart = window >> kRZAssertWindowCountBits;
+        windowCount = window & kRZAssertWindowCountMask;
+
+        if ( windowStart == 0 || ((nowMilliseconds - windowStart) & kRZAssertWindowStartMask) >= intervalMilliseconds ) {
+            // Opening a new window resets the count in the same store, so no increment made in it is lost.
+            windowStart = nowMilliseconds;
+            windowCount = 1;
+        }
+        else if ( windowCount < kRZAssertWindowCountMask ) {
+            windowCount++;
+        }
+
+        uint64_t desired = (windowStart << kRZAssertWindowCountBits) | windowCount;
+        if ( desired == window ) {
+            // Saturated, and already suppressing.
+            break;
+        }
+
+        if ( __atomic_compare_exchange_n(&site->window, &window, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE) ) {
+            break;
+        }
+    }
+
+    if ( windowCount <= maximumMessages ) {
+        return YES;
+    }
+
+    // The first suppressed failure in a window schedules the summary for when the window closes.
+    if ( __atomic_fetch_add(&site->suppressedCount, 1, __ATOMIC_RELAXED) == 0 ) {
+        uint64_t elapsed = ((nowMilliseconds - windowStart) & kRZAssertWindowStartMask) * NSEC_PER_MSEC;
+        int64_t delay = ( interval > elapsed ) ? (int64_t)(interval - elapsed) : 0;
+
+        dispatch_after(dispatch_time(DISPATCH_TIME_NOW, delay), dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0), ^{
+            RZAssertSiteLogSuppressedSummary(site, interval);
+        });
+    }
+
+    return NO;
+}
+
 @implementation RZAssert
 
 + (instancetype)sharedInstance
@@ -48,6 +290,16 @@
     return s_sharedInstance;
 }
 
+- (instancetype)init
+{
+    self = [super init];
+    if ( self ) {
+        _sinks = [NSMutableArray array];
+    }
+
+    return self;
+}
+
 #pragma mark - Public
 
 + (void)configureWithLoggingHandler:(void(^)(NSString *message))loggingHandler
@@ -57,12 +309,382 @@
         [NSException raise:NSInvalidArgumentException format:@"%s: loggingHandler must not be nil. If you want to remove the logging handler, use +removeLoggingHandler instead.", __PRETTY_FUNCTION__];
     }
 
-    [[self sharedInstance] setLoggingHandler:loggingHandler];
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        sharedInstance.loggingSink = [[RZAssertSink alloc] initWithFilter:nil handler:^(RZAssertFailure *failure) {
+            // Only the logging handler forces the message to be built.
+            loggingHandler(failure.message);
+        }];
+        [sharedInstance publishHandlerConfiguration];
+    }
 }
 
 + (void)removeLoggingHandler
 {
-    [[self sharedInstance] setLoggingHandler:nil];
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        sharedInstance.loggingSink = nil;
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (void)configureWithBatchLoggingHandler:(void(^)(NSArray *messages))batchLoggingHandler
+{
+    [self configureWithBatchLoggingHandler:batchLoggingHandler maximumBatchSize:kRZAssertDefaultMaximumBatchSize flushInterval:kRZAssertDefaultFlushInterval];
+}
+
++ (void)configureWithBatchLoggingHandler:(void(^)(NSArray *messages))batchLoggingHandler maximumBatchSize:(NSUInteger)maximumBatchSize flushInterval:(NSTimeInterval)flushInterval
+{
+    if ( !batchLoggingHandler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: batchLoggingHandler must not be nil. If you want to remove the batch logging handler, use +removeBatchLoggingHandler instead.", __PRETTY_FUNCTION__];
+    }
+
+    if ( maximumBatchSize == 0 || flushInterval <= 0.0 ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: maximumBatchSize and flushInterval must be greater than 0", __PRETTY_FUNCTION__];
+    }
+
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        atexit(RZAssertFlushAtExit);
+    });
+
+    RZAssertBatchLogger *batchLogger = [[RZAssertBatchLogger alloc] initWithMaximumBatchSize:maximumBatchSize flushInterval:flushInterval deliveryHandler:^(NSArray *failures) {
+        batchLoggingHandler([failures valueForKey:NSStringFromSelector(@selector(message))]);
+    }];
+
+    RZAssert *sharedInstance = [self sharedInstance];
+    RZAssertBatchLogger *previousBatchLogger = nil;
+
+    @synchronized(sharedInstance) {
+        previousBatchLogger = sharedInstance.batchLogger;
+        sharedInstance.batchLogger = batchLogger;
+        [sharedInstance publishHandlerConfiguration];
+    }
+
+    [previousBatchLogger stop];
+}
+
++ (void)removeBatchLoggingHandler
+{
+    RZAssert *sharedInstance = [self sharedInstance];
+    RZAssertBatchLogger *previousBatchLogger = nil;
+
+    @synchronized(sharedInstance) {
+        previousBatchLogger = sharedInstance.batchLogger;
+        sharedInstance.batchLogger = nil;
+        [sharedInstance publishHandlerConfiguration];
+    }
+
+    [previousBatchLogger stop];
+}
+
++ (void)flush
+{
+    [[[self sharedInstance] batchLogger] flush];
+}
+
++ (void)configureWithBufferedLoggingHandler:(void(^)(const RZAssertMessageBuffer *buffer))bufferedLoggingHandler
+{
+    if ( !bufferedLoggingHandler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: bufferedLoggingHandler must not be nil. If you want to remove the buffered logging handler, use +removeBufferedLoggingHandler instead.", __PRETTY_FUNCTION__];
+    }
+
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        sharedInstance.bufferedLoggingSink = [[RZAssertSink alloc] initWithMessageBufferHandler:bufferedLoggingHandler];
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (void)removeBufferedLoggingHandler
+{
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        sharedInstance.bufferedLoggingSink = nil;
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (void)configureWithFailureHandler:(void(^)(RZAssertFailure *failure))failureHandler
+{
+    if ( !failureHandler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: failureHandler must not be nil. If you want to remove the failure handler, use +removeFailureHandler instead.", __PRETTY_FUNCTION__];
+    }
+
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        sharedInstance.failureSink = [[RZAssertSink alloc] initWithFilter:nil handler:failureHandler];
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (void)removeFailureHandler
+{
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        sharedInstance.failureSink = nil;
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (id)addSinkWithFilter:(BOOL(^)(RZAssertFailure *failure))filter handler:(void(^)(RZAssertFailure *failure))handler
+{
+    if ( !handler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: handler must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    RZAssertSink *sink = [[RZAssertSink alloc] initWithFilter:filter handler:handler];
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        [sharedInstance.sinks addObject:sink];
+        [sharedInstance publishHandlerConfiguration];
+    }
+
+    return sink;
+}
+
++ (void)removeSink:(id)sink
+{
+    if ( !sink ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: sink must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        [sharedInstance.sinks removeObjectIdenticalTo:sink];
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (BOOL)enableCrashLogAtPath:(NSString *)path size:(NSUInteger)size error:(NSError **)error
+{
+    RZAssertCrashLog *crashLog = [[RZAssertCrashLog alloc] initWithPath:path size:size error:error];
+
+    if ( crashLog ) {
+        RZAssert *sharedInstance = [self sharedInstance];
+
+        @synchronized(sharedInstance) {
+            sharedInstance.crashLog = crashLog;
+            [sharedInstance publishHandlerConfiguration];
+        }
+    }
+
+    return ( crashLog != nil );
+}
+
++ (void)disableCrashLog
+{
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        sharedInstance.crashLog = nil;
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (void)enableBreadcrumbsWithCapacity:(NSUInteger)capacity
+{
+    if ( capacity == 0 ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: capacity must be greater than 0", __PRETTY_FUNCTION__];
+    }
+
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        if ( RZAssertBreadcrumbsEnable(capacity) != 0 ) {
+            [NSException raise:NSMallocException format:@"%s: could not allocate %lu breadcrumbs", __PRETTY_FUNCTION__, (unsigned long)capacity];
+        }
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (void)disableBreadcrumbs
+{
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    @synchronized(sharedInstance) {
+        RZAssertBreadcrumbsDisable();
+        [sharedInstance publishHandlerConfiguration];
+    }
+}
+
++ (BOOL)dumpBreadcrumbsOnCrashToFileDescriptor:(int)fileDescriptor
+{
+    if ( fileDescriptor < 0 ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: fileDescriptor must be open", __PRETTY_FUNCTION__];
+    }
+
+    @synchronized([self sharedInstance]) {
+        return ( RZAssertBreadcrumbsInstallSignalHandlers(fileDescriptor) == 0 );
+    }
+}
+
++ (void)removeBreadcrumbCrashHandlers
+{
+    @synchronized([self sharedInstance]) {
+        RZAssertBreadcrumbsRemoveSignalHandlers();
+    }
+}
+
++ (NSUInteger)writeBreadcrumbsToFileDescriptor:(int)fileDescriptor
+{
+    return RZAssertBreadcrumbsDump(fileDescriptor);
+}
+
++ (void)configureRateLimitWithMaximumMessages:(NSUInteger)maximumMessages interval:(NSTimeInterval)interval
+{
+    if ( maximumMessages == 0 || interval <= 0.0 ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: maximumMessages and interval must be greater than 0. If you want to remove the rate limit, use +removeRateLimit instead.", __PRETTY_FUNCTION__];
+    }
+
+    if ( maximumMessages > kRZAssertRateLimitMaximumMessages ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: maximumMessages must be at most %lu", __PRETTY_FUNCTION__, (unsigned long)kRZAssertRateLimitMaximumMessages];
+    }
+
+    __atomic_store_n(&s_rateLimitInterval, (uint64_t)(interval * NSEC_PER_SEC), __ATOMIC_RELAXED);
+    __atomic_store_n(&s_rateLimitMaximumMessages, (uint64_t)maximumMessages, __ATOMIC_RELAXED);
+}
+
++ (void)removeRateLimit
+{
+    __atomic_store_n(&s_rateLimitMaximumMessages, 0, __ATOMIC_RELAXED);
+}
+
++ (void)setEnabledLevel:(RZAssertLevel)level
+{
+    [self setEnabledLevel:level forCategories:RZAssertCategoryAll];
+}
+
++ (void)setEnabledLevel:(RZAssertLevel)level forCategories:(RZAssertCategories)categories
+{
+    if ( level < RZAssertLevelCheap || level > RZAssertLevelExpensive ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: %ld is not a valid RZAssertLevel. If you want to disable assertions, use +disableCategories: instead.", __PRETTY_FUNCTION__, (long)level];
+    }
+
+    uint64_t allLevels = 0;
+    uint64_t enabledLevels = 0;
+    for ( RZAssertLevel l = RZAssertLevelCheap; l <= RZAssertLevelExpensive; l++ ) {
+        allLevels |= RZASSERT_CONTROL_BIT(l, categories);
+        if ( l <= level ) {
+            enabledLevels |= RZASSERT_CONTROL_BIT(l, categories);
+        }
+    }
+
+    RZAssertUpdateControlWord(allLevels, enabledLevels);
+}
+
++ (void)disableCategories:(RZAssertCategories)categories
+{
+    uint64_t allLevels = 0;
+    for ( RZAssertLevel l = RZAssertLevelCheap; l <= RZAssertLevelExpensive; l++ ) {
+        allLevels |= RZASSERT_CONTROL_BIT(l, categories);
+    }
+
+    RZAssertUpdateControlWord(allLevels, 0);
+}
+
++ (void)enableAsynchronousLoggingWithCapacity:(NSUInteger)capacity backpressurePolicy:(RZAssertBackpressurePolicy)policy
+{
+    if ( capacity == 0 ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: capacity must be greater than 0", __PRETTY_FUNCTION__];
+    }
+
+    RZAssertAsyncLogger *asyncLogger = [[RZAssertAsyncLogger alloc] initWithCapacity:capacity backpressurePolicy:policy deliveryHandler:^(RZAssertFailure *failure) {
+        [self deliverFailure:failure];
+    }];
+
+    RZAssert *sharedInstance = [self sharedInstance];
+    RZAssertAsyncLogger *previousAsyncLogger = nil;
+
+    @synchronized(sharedInstance) {
+        previousAsyncLogger = sharedInstance.asyncLogger;
+        sharedInstance.asyncLogger = asyncLogger;
+    }
+
+    [previousAsyncLogger stop];
+}
+
++ (void)disableAsynchronousLogging
+{
+    RZAssert *sharedInstance = [self sharedInstance];
+    RZAssertAsyncLogger *previousAsyncLogger = nil;
+
+    @synchronized(sharedInstance) {
+        previousAsyncLogger = sharedInstance.asyncLogger;
+        sharedInstance.asyncLogger = nil;
+    }
+
+    [previousAsyncLogger stop];
+}
+
++ (uint64_t)droppedMessageCount
+{
+    return [[[self sharedInstance] asyncLogger] droppedMessageCount];
+}
+
++ (void)enumerateCallSitesUsingBlock:(void(^)(const RZAssertSite *site))block
+{
+    if ( !block ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: block must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    RZAssertEnumerateSiteEntries(^(RZAssertSite *const *entries, size_t count) {
+        for ( size_t i = 0; i < count; i++ ) {
+            // The linker may leave zero padding between entries from different object files.
+            if ( entries[i] ) {
+                block(entries[i]);
+            }
+        }
+    });
+}
+
++ (void)enableStatistics
+{
+    RZAssertUpdateControlWord(0, RZASSERT_CONTROL_STATISTICS_BIT);
+}
+
++ (void)disableStatistics
+{
+    RZAssertUpdateControlWord(RZASSERT_CONTROL_STATISTICS_BIT, 0);
+}
+
++ (NSArray *)statisticsSnapshot
+{
+    return RZAssertStatisticsSnapshot();
+}
+
++ (void)enableProfiling
+{
+    RZAssertProfilerPrepare();
+    RZAssertUpdateControlWord(0, RZASSERT_CONTROL_PROFILING_BIT);
+}
+
++ (void)disableProfiling
+{
+    RZAssertUpdateControlWord(RZASSERT_CONTROL_PROFILING_BIT, 0);
+}
+
++ (NSArray *)mostExpensiveSitesWithLimit:(NSUInteger)limit
+{
+    return RZAssertProfilerMostExpensiveSites(limit);
+}
+
++ (void)enableBacktraces
+{
+    RZAssertUpdateControlWord(0, RZASSERT_CONTROL_BACKTRACE_BIT);
+}
+
++ (void)disableBacktraces
+{
+    RZAssertUpdateControlWord(RZASSERT_CONTROL_BACKTRACE_BIT, 0);
 }
 
 + (void)logMessage:(NSString *)message
@@ -72,16 +694,93 @@
         [NSException raise:NSInvalidArgumentException format:@"%s: message must not be nil", __PRETTY_FUNCTION__];
     }
 
-    void(^loggingHandler)(NSString *) = [[self sharedInstance] loggingHandler];
-    
-    if ( loggingHandler ) {
-        loggingHandler(message);
+    uint64_t control = __atomic_load_n(&RZAssertControlWord, __ATOMIC_ACQUIRE);
+
+    if ( control & RZASSERT_CONTROL_MESSAGE_BUFFER_BIT ) {
+        // The message already exists, so there's nothing to gain by copying it into the thread's buffer.
+        const char *UTF8String = [message UTF8String];
+        RZAssertMessageBuffer buffer = { NULL, UTF8String, strlen(UTF8String), NO };
+        RZAssertSinkRegistryDeliverMessageBuffer(&buffer);
+    }
+
+    if ( control & RZASSERT_CONTROL_FAILURE_BIT ) {
+        [self reportFailure:[[RZAssertFailure alloc] initWithMessage:message]];
+    }
+}
+
++ (void)reportFailure:(RZAssertFailure *)failure
+{
+    RZAssert *sharedInstance = [self sharedInstance];
+
+    // Always recorded on the failing thread, so a crash can't lose it in the asynchronous queue.
+    [sharedInstance.crashLog appendFailure:failure];
+
+    if ( RZAssertBreadcrumbsEnabled() ) {
+        const RZAssertSite *site = failure.site;
+        const char *detail = [failure.formattedDetail UTF8String] ?: "";
+        RZAssertBreadcrumbsAppend(site ? site->kind : NULL, site ? site->file : NULL, site ? (uint32_t)site->line : 0, site ? site->function : NULL, failure.timestamp, failure.threadID, detail, strlen(detail));
+    }
+
+    RZAssertAsyncLogger *asyncLogger = sharedInstance.asyncLogger;
+
+    if ( asyncLogger ) {
+        [asyncLogger enqueueFailure:failure];
+    }
+    else {
+        [self deliverFailure:failure];
     }
 }
 
 + (BOOL)hasLogger
 {
-    return ([[self sharedInstance] loggingHandler] != nil);
+    return RZAssertHasLoggerFast();
+}
+
+#pragma mark - Private
+
++ (void)deliverFailure:(RZAssertFailure *)failure
+{
+    RZAssertSinkRegistryDeliver(failure);
+
+    // Buffered on the delivering thread, which is the logging thread if asynchronous logging is enabled.
+    [[[self sharedInstance] batchLogger] appendFailure:failure];
+}
+
+- (void)publishHandlerConfiguration
+{
+    // The failure handler runs before the logging handler, then sinks in the order they were added.
+    // The buffered logging handler gets its message before any of them.
+    NSMutableArray *sinks = [NSMutableArray array];
+    if ( self.failureSink ) {
+        [sinks addObject:self.failureSink];
+    }
+    if ( self.loggingSink ) {
+        [sinks addObject:self.loggingSink];
+    }
+    [sinks addObjectsFromArray:self.sinks];
+
+    BOOL needsFailures = ( sinks.count > 0 || self.batchLogger != nil || self.crashLog != nil || RZAssertBreadcrumbsEnabled() );
+    BOOL needsMessageBuffers = ( self.bufferedLoggingSink != nil );
+
+    if ( self.bufferedLoggingSink ) {
+        [sinks addObject:self.bufferedLoggingSink];
+    }
+
+    RZAssertSinkRegistryPublish(sinks);
+
+    // Called after the sinks are published, so a macro that sees a flag also sees the sinks.
+    uint64_t configuredBits = 0;
+    if ( needsFailures ) {
+        configuredBits |= RZASSERT_CONTROL_FAILURE_BIT;
+    }
+    if ( needsMessageBuffers ) {
+        configuredBits |= RZASSERT_CONTROL_MESSAGE_BUFFER_BIT;
+    }
+    if ( configuredBits ) {
+        configuredBits |= RZASSERT_CONTROL_LOGGER_BIT;
+    }
+
+    RZAssertUpdateControlWord(RZASSERT_CONTROL_LOGGER_BIT | RZASSERT_CONTROL_FAILURE_BIT | RZASSERT_CONTROL_MESSAGE_BUFFER_BIT, configuredBits);
 }
 
 @end
@@ -0,0 +1,61 @@
+//
+//  RZAssertAsyncLogger.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssert.h"
+
+/**
+ *  Delivers failures to a handler on a dedicated background thread. Producers push into a bounded lock-free multi-producer/single-consumer ring, so a failing thread never waits on the handler unless the ring is full and the policy is @c RZAssertBackpressurePolicyBlock. For private use only.
+ */
+@interface RZAssertAsyncLogger : NSObject
+
+/**
+ *  Creates the ring and starts the logging thread.
+ *
+ *  @param capacity        The maximum number of queued failures. Rounded up to a power of two.
+ *  @param policy          What to do with a new failure when the ring is full.
+ *  @param deliveryHandler The block the logging thread calls with each failure.
+ */
+- (instancetype)initWithCapacity:(NSUInteger)capacity backpressurePolicy:(RZAssertBackpressurePolicy)policy deliveryHandler:(void(^)(RZAssertFailure *failure))deliveryHandler;
+
+/**
+ *  Queues a failure for delivery. Safe to call from any thread.
+ *
+ *  @param failure The failure to deliver.
+ */
+- (void)enqueueFailure:(RZAssertFailure *)failure;
+
+/**
+ *  Delivers everything already queued, then stops the logging thread. Blocks until the thread exits. Failures enqueued after this call are delivered synchronously.
+ */
+- (void)stop;
+
+/**
+ *  The number of failures discarded because the ring was full.
+ */
+@property (assign, nonatomic, readonly) uint64_t droppedMessageCount;
+
+@end
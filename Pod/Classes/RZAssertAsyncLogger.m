@@ -0,0 +1,285 @@
+//
+//  RZAssertAsyncLogger.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertAsyncLogger.h"
+
+static NSString* const kRZAssertLoggingThreadName = @"com.raizlabs.RZAssert.logging";
+
+// How long a blocked producer sleeps before checking the ring again, in case it missed a wakeup.
+static const int64_t kRZAssertBlockedProducerTimeout = NSEC_PER_MSEC;
+
+#pragma mark - Ring
+
+// A bounded queue after Dmitry Vyukov's design: each cell carries a sequence number
+// that tells producers and consumers whose turn it is, so neither side takes a lock.
+// The logging thread is the only regular consumer, but producers also dequeue when
+// evicting under RZAssertBackpressurePolicyDropOldest, so both ends are multi-threaded.
+
+typedef struct {
+    size_t sequence;
+    void *item;
+} RZAssertRingCell;
+
+typedef struct {
+    RZAssertRingCell *cells;
+    size_t mask;
+    char padding0[64];
+    size_t enqueuePosition;
+    char padding1[64];
+    size_t dequeuePosition;
+    char padding2[64];
+} RZAssertRing;
+
+static RZAssertRing *RZAssertRingCreate(size_t capacity)
+{
+    size_t roundedCapacity = 2;
+    while ( roundedCapacity < capacity ) {
+        roundedCapacity <<= 1;
+    }
+
+    RZAssertRing *ring = calloc(1, sizeof(RZAssertRing));
+    ring->cells = calloc(roundedCapacity, sizeof(RZAssertRingCell));
+    ring->mask = roundedCapacity - 1;
+
+    for ( size_t i = 0; i < roundedCapacity; i++ ) {
+        ring->cells[i].sequence = i;
+    }
+
+    return ring;
+}
+
+static void RZAssertRingDestroy(RZAssertRing *ring)
+{
+    free(ring->cells);
+    free(ring);
+}
+
+static BOOL RZAssertRingPush(RZAssertRing *ring, void *item)
+{
+    size_t position = __atomic_load_n(&ring->enqueuePosition, __ATOMIC_RELAXED);
+
+    for ( ;; ) {
+        RZAssertRingCell *cell = &ring->cells[position & ring->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
+
+        if ( difference == 0 ) {
+            if ( __atomic_compare_exchange_n(&ring->enqueuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+                cell->item = item;
+                __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+                return YES;
+            }
+        }
+        else if ( difference < 0 ) {
+            // Full.
+            return NO;
+        }
+        else {
+            position = __atomic_load_n(&ring->enqueuePosition, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+static BOOL RZAssertRingPop(RZAssertRing *ring, void **item)
+{
+    size_t position = __atomic_load_n(&ring->dequeuePosition, __ATOMIC_RELAXED);
+
+    for ( ;; ) {
+        RZAssertRingCell *cell = &ring->cells[position & ring->mask];
+        size_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
+
+        if ( difference == 0 ) {
+            if ( __atomic_compare_exchange_n(&ring->dequeuePosition, &position, position + 1, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+                *item = cell->item;
+                __atomic_store_n(&cell->sequence, position + ring->mask + 1, __ATOMIC_RELEASE);
+                return YES;
+            }
+        }
+        else if ( difference < 0 ) {
+            // Empty.
+            return NO;
+        }
+        else {
+            position = __atomic_load_n(&ring->dequeuePosition, __ATOMIC_RELAXED);
+        }
+    }
+}
+
+#pragma mark - RZAssertAsyncLogger
+
+@interface RZAssertAsyncLogger () {
+    RZAssertRing *_ring;
+    uint64_t _droppedMessageCount;
+    int32_t _stopping;
+    int32_t _waitingProducers;
+}
+
+@property (assign, nonatomic) RZAssertBackpressurePolicy policy;
+@property (copy, nonatomic) void (^deliveryHandler)(RZAssertFailure *failure);
+@property (strong, nonatomic) NSThread *thread;
+@property (strong, nonatomic) dispatch_semaphore_t failuresAvailable;
+@property (strong, nonatomic) dispatch_semaphore_t spaceAvailable;
+@property (strong, nonatomic) dispatch_semaphore_t threadExited;
+
+@end
+
+@implementation RZAssertAsyncLogger
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity backpressurePolicy:(RZAssertBackpressurePolicy)policy deliveryHandler:(void(^)(RZAssertFailure *failure))deliveryHandler
+{
+    if ( !deliveryHandler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: deliveryHandler must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    self = [super init];
+    if ( self ) {
+        _ring = RZAssertRingCreate(capacity);
+        _policy = policy;
+        _deliveryHandler = [deliveryHandler copy];
+        _failuresAvailable = dispatch_semaphore_create(0);
+        _spaceAvailable = dispatch_semaphore_create(0);
+        _threadExited = dispatch_semaphore_create(0);
+
+        // The thread retains its target until it exits, which happens in -stop.
+        _thread = [[NSThread alloc] initWithTarget:self selector:@selector(threadMain) object:nil];
+        _thread.name = kRZAssertLoggingThreadName;
+        [_thread start];
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    // Anything that raced with -stop is still in the ring; deliver it rather than lose it.
+    [self drain];
+    RZAssertRingDestroy(_ring);
+}
+
+#pragma mark - Public
+
+- (void)enqueueFailure:(RZAssertFailure *)failure
+{
+    // Once stopping, or if the handler itself fails an assertion, there is no thread to hand off to.
+    if ( __atomic_load_n(&_stopping, __ATOMIC_ACQUIRE) || [NSThread currentThread] == self.thread ) {
+        self.deliveryHandler(failure);
+        return;
+    }
+
+    void *item = (__bridge_retained void *)failure;
+
+    while ( !RZAssertRingPush(_ring, item) ) {
+        switch ( self.policy ) {
+            case RZAssertBackpressurePolicyDropNewest: {
+                CFBridgingRelease(item);
+                __atomic_fetch_add(&_droppedMessageCount, 1, __ATOMIC_RELAXED);
+                return;
+            }
+            case RZAssertBackpressurePolicyDropOldest: {
+                void *oldest = NULL;
+                if ( RZAssertRingPop(_ring, &oldest) ) {
+                    CFBridgingRelease(oldest);
+                    __atomic_fetch_add(&_droppedMessageCount, 1, __ATOMIC_RELAXED);
+                }
+                break;
+            }
+            case RZAssertBackpressurePolicyBlock: {
+                // The logging thread's final drain may free space that other producers fill
+                // before it exits, and nothing frees space after that.
+                if ( __atomic_load_n(&_stopping, __ATOMIC_ACQUIRE) ) {
+                    self.deliveryHandler(CFBridgingRelease(item));
+                    return;
+                }
+
+                __atomic_fetch_add(&_waitingProducers, 1, __ATOMIC_SEQ_CST);
+                dispatch_semaphore_signal(self.failuresAvailable);
+                dispatch_semaphore_wait(self.spaceAvailable, dispatch_time(DISPATCH_TIME_NOW, kRZAssertBlockedProducerTimeout));
+                __atomic_fetch_sub(&_waitingProducers, 1, __ATOMIC_SEQ_CST);
+                break;
+            }
+        }
+    }
+
+    // Only makes a syscall if the logging thread is actually waiting.
+    dispatch_semaphore_signal(self.failuresAvailable);
+}
+
+- (void)stop
+{
+    if ( __atomic_exchange_n(&_stopping, 1, __ATOMIC_ACQ_REL) ) {
+        return;
+    }
+
+    dispatch_semaphore_signal(self.failuresAvailable);
+
+    if ( [NSThread currentThread] != self.thread ) {
+        dispatch_semaphore_wait(self.threadExited, DISPATCH_TIME_FOREVER);
+    }
+}
+
+- (uint64_t)droppedMessageCount
+{
+    return __atomic_load_n(&_droppedMessageCount, __ATOMIC_RELAXED);
+}
+
+#pragma mark - Private
+
+- (void)threadMain
+{
+    for ( ;; ) {
+        dispatch_semaphore_wait(self.failuresAvailable, DISPATCH_TIME_FOREVER);
+
+        [self drain];
+
+        if ( __atomic_load_n(&_stopping, __ATOMIC_ACQUIRE) ) {
+            // Pick up anything pushed between the last drain and the stop flag.
+            [self drain];
+            break;
+        }
+    }
+
+    dispatch_semaphore_signal(self.threadExited);
+}
+
+- (void)drain
+{
+    void *item = NULL;
+
+    while ( RZAssertRingPop(_ring, &item) ) {
+        @autoreleasepool {
+            RZAssertFailure *failure = CFBridgingRelease(item);
+            self.deliveryHandler(failure);
+        }
+
+        if ( __atomic_load_n(&_waitingProducers, __ATOMIC_SEQ_CST) > 0 ) {
+            dispatch_semaphore_signal(self.spaceAvailable);
+        }
+    }
+}
+
+@end
@@ -0,0 +1,85 @@
+//
+//  RZAssertBacktrace.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+/**
+ *  The most return addresses captured for a failure.
+ */
+#define RZASSERT_BACKTRACE_MAXIMUM_DEPTH 32
+
+/**
+ *  The most distinct stacks kept for sharing. Stacks captured after the table is full are still returned, but not shared.
+ */
+#define RZASSERT_BACKTRACE_TABLE_CAPACITY 4096
+
+/**
+ *  The raw return addresses of a failing call, as attached to an RZAssertFailure while backtraces are enabled. Identical stacks are stored once and shared between failures. Symbol names are only looked up when asked for, on a background queue, and each address is only looked up once.
+ */
+@interface RZAssertBacktrace : NSObject
+
+/**
+ *  The return addresses, innermost first, starting with the function that failed.
+ */
+@property (assign, nonatomic, readonly) const uintptr_t *addresses;
+
+/**
+ *  The number of return addresses.
+ */
+@property (assign, nonatomic, readonly) NSUInteger count;
+
+/**
+ *  A hash of the return addresses, identifying the stack.
+ */
+@property (assign, nonatomic, readonly) uint64_t stackHash;
+
+/**
+ *  One string per address, formatted like +[NSThread callStackSymbols], or nil until the backtrace has been symbolicated.
+ */
+@property (copy, atomic, readonly) NSArray *symbols;
+
+/**
+ *  Looks up the symbol for each address on a background queue, unless that was already done, and calls a block with them.
+ *
+ *  @param completion The block to call with the symbols, on the background queue.
+ */
+- (void)symbolicateWithCompletion:(void(^)(NSArray *symbols))completion;
+
+@end
+
+/**
+ *  Captures the calling thread's return addresses, returning the shared backtrace if the same stack was captured before. For private use only.
+ *
+ *  @param skippedFrames The number of frames to leave out, above the caller of this function.
+ *
+ *  @return The backtrace, or nil if no frames could be captured.
+ */
+FOUNDATION_EXPORT RZAssertBacktrace *RZAssertBacktraceCapture(NSUInteger skippedFrames);
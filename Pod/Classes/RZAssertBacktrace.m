@@ -0,0 +1,199 @@
+//
+//  RZAssertBacktrace.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#if !defined(__APPLE__)
+#define _GNU_SOURCE     // For dladdr()
+#endif
+
+#import "RZAssertBacktrace.h"
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <pthread.h>
+
+// Distinct stacks, by hash. Guarded by s_backtraceMutex.
+static pthread_mutex_t s_backtraceMutex = PTHREAD_MUTEX_INITIALIZER;
+static NSMutableDictionary *s_backtraces = nil;
+
+#pragma mark - Symbolication
+
+// Symbolication runs on one serial queue, which also owns the symbol cache.
+static dispatch_queue_t RZAssertBacktraceSymbolicationQueue(void)
+{
+    static dispatch_queue_t s_queue;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        s_queue = dispatch_queue_create("com.raizlabs.rzassert.symbolication", DISPATCH_QUEUE_SERIAL);
+        dispatch_set_target_queue(s_queue, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0));
+    });
+    return s_queue;
+}
+
+// Call on the symbolication queue only.
+static NSString *RZAssertBacktraceSymbolForAddress(uintptr_t address)
+{
+    static NSMutableDictionary *s_symbols = nil;
+    if ( !s_symbols ) {
+        s_symbols = [NSMutableDictionary dictionary];
+    }
+
+    NSNumber *key = @(address);
+    NSString *symbol = s_symbols[key];
+
+    if ( !symbol ) {
+        Dl_info info;
+        memset(&info, 0, sizeof(info));
+
+        if ( dladdr((const void *)address, &info) != 0 ) {
+            const char *image = info.dli_fname ? [[@(info.dli_fname) lastPathComponent] UTF8String] : "???";
+            if ( info.dli_sname ) {
+                symbol = [NSString stringWithFormat:@"%-35s 0x%016llx %s + %llu", image, (unsigned long long)address, info.dli_sname, (unsigned long long)(address - (uintptr_t)info.dli_saddr)];
+            }
+            else {
+                symbol = [NSString stringWithFormat:@"%-35s 0x%016llx 0x%llx + %llu", image, (unsigned long long)address, (unsigned long long)(uintptr_t)info.dli_fbase, (unsigned long long)(address - (uintptr_t)info.dli_fbase)];
+            }
+        }
+        else {
+            symbol = [NSString stringWithFormat:@"%-35s 0x%016llx", "???", (unsigned long long)address];
+        }
+
+        s_symbols[key] = symbol;
+    }
+
+    return symbol;
+}
+
+#pragma mark - RZAssertBacktrace
+
+@interface RZAssertBacktrace () {
+    uintptr_t _storage[RZASSERT_BACKTRACE_MAXIMUM_DEPTH];
+}
+
+@property (copy, atomic, readwrite) NSArray *symbols;
+
+@end
+
+@implementation RZAssertBacktrace
+
+- (instancetype)initWithAddresses:(const uintptr_t *)addresses count:(NSUInteger)count stackHash:(uint64_t)stackHash
+{
+    self = [super init];
+    if ( self ) {
+        _count = MIN(count, (NSUInteger)RZASSERT_BACKTRACE_MAXIMUM_DEPTH);
+        memcpy(_storage, addresses, _count * sizeof(uintptr_t));
+        _stackHash = stackHash;
+    }
+    return self;
+}
+
+- (const uintptr_t *)addresses
+{
+    return _storage;
+}
+
+- (BOOL)hasAddresses:(const uintptr_t *)addresses count:(NSUInteger)count
+{
+    return ( count == _count && memcmp(addresses, _storage, count * sizeof(uintptr_t)) == 0 );
+}
+
+- (void)symbolicateWithCompletion:(void(^)(NSArray *symbols))completion
+{
+    if ( !completion ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: completion must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    dispatch_async(RZAssertBacktraceSymbolicationQueue(), ^{
+        NSArray *symbols = self.symbols;
+
+        if ( !symbols ) {
+            NSMutableArray *lines = [NSMutableArray arrayWithCapacity:self.count];
+            for ( NSUInteger i = 0; i < self.count; i++ ) {
+                [lines addObject:[NSString stringWithFormat:@"%-3lu %@", (unsigned long)i, RZAssertBacktraceSymbolForAddress(self->_storage[i])]];
+            }
+            symbols = [lines copy];
+            self.symbols = symbols;
+        }
+
+        completion(symbols);
+    });
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; %lu frames; hash: %016llx>", NSStringFromClass([self class]), (void *)self, (unsigned long)self.count, (unsigned long long)self.stackHash];
+}
+
+@end
+
+#pragma mark - Capture
+
+__attribute__((noinline))
+RZAssertBacktrace *RZAssertBacktraceCapture(NSUInteger skippedFrames)
+{
+    // One more, for this function.
+    skippedFrames += 1;
+
+    void *frames[RZASSERT_BACKTRACE_MAXIMUM_DEPTH + 8];
+    int frameCount = backtrace(frames, (int)MIN(skippedFrames + RZASSERT_BACKTRACE_MAXIMUM_DEPTH, sizeof(frames) / sizeof(frames[0])));
+    if ( frameCount <= (int)skippedFrames ) {
+        return nil;
+    }
+
+    const uintptr_t *addresses = (const uintptr_t *)(frames + skippedFrames);
+    NSUInteger count = MIN((NSUInteger)frameCount - skippedFrames, (NSUInteger)RZASSERT_BACKTRACE_MAXIMUM_DEPTH);
+
+    // FNV-1a over the addresses.
+    uint64_t stackHash = 0xcbf29ce484222325ull;
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        stackHash = (stackHash ^ addresses[i]) * 0x100000001b3ull;
+    }
+
+    NSNumber *key = @(stackHash);
+    RZAssertBacktrace *result = nil;
+
+    pthread_mutex_lock(&s_backtraceMutex);
+
+    if ( !s_backtraces ) {
+        s_backtraces = [NSMutableDictionary dictionary];
+    }
+
+    RZAssertBacktrace *existing = s_backtraces[key];
+    if ( [existing hasAddresses:addresses count:count] ) {
+        result = existing;
+    }
+    else {
+        result = [[RZAssertBacktrace alloc] initWithAddresses:addresses count:count stackHash:stackHash];
+        // On a hash collision, the first stack keeps the slot.
+        if ( !existing && s_backtraces.count < RZASSERT_BACKTRACE_TABLE_CAPACITY ) {
+            s_backtraces[key] = result;
+        }
+    }
+
+    pthread_mutex_unlock(&s_backtraceMutex);
+
+    return result;
+}
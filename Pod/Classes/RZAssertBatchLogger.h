@@ -0,0 +1,65 @@
+//
+//  RZAssertBatchLogger.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssert.h"
+
+/**
+ *  Collects failures in per-thread buffers and delivers them to a handler in batches. Appending takes no lock shared with other threads: a thread only ever writes to its own buffer, and a flush swaps the buffer out from under it. For private use only.
+ *
+ *  Each logger has its own buffers, so stopping a logger never takes failures appended through another one.
+ *
+ *  A buffer is delivered when it fills, when the flush interval elapses, on -flush, and when its thread exits (with the next flush). Batches are delivered one at a time on a serial queue, and each batch is in the order its thread appended the failures.
+ */
+@interface RZAssertBatchLogger : NSObject
+
+/**
+ *  Starts the flush timer.
+ *
+ *  @param maximumBatchSize The number of failures a thread buffers before delivering them. Must be greater than 0.
+ *  @param flushInterval    How often to deliver partially filled buffers, in seconds. Must be greater than 0.
+ *  @param deliveryHandler  The block to call with each batch of failures.
+ */
+- (instancetype)initWithMaximumBatchSize:(NSUInteger)maximumBatchSize flushInterval:(NSTimeInterval)flushInterval deliveryHandler:(void(^)(NSArray *failures))deliveryHandler;
+
+/**
+ *  Appends a failure to the calling thread's buffer, delivering the buffer if that fills it.
+ *
+ *  @param failure The failure to deliver.
+ */
+- (void)appendFailure:(RZAssertFailure *)failure;
+
+/**
+ *  Delivers every buffered failure, on all threads, and waits until the handler has returned for all of them.
+ */
+- (void)flush;
+
+/**
+ *  Stops the flush timer and flushes. Failures appended after this call are delivered immediately, one per batch.
+ */
+- (void)stop;
+
+@end
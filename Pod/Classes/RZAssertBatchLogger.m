@@ -0,0 +1,415 @@
+//
+//  RZAssertBatchLogger.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertBatchLogger.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+static const char *const kRZAssertBatchDeliveryQueueLabel = "com.raizlabs.RZAssert.batch-delivery";
+
+static void *const kRZAssertBatchDeliveryQueueKey = (void *)&kRZAssertBatchDeliveryQueueKey;
+
+#pragma mark - Thread Buffers
+
+// Each logger owns a buffer set, and each thread has one buffer in every set it has
+// appended to. A thread appends to the segment its buffer points to. A flush exchanges
+// that pointer for an empty segment, then waits for any append that may have loaded the
+// old pointer to finish, which the owner announces through the appending flag.
+// So the owner never waits on a flush, a flush only waits for one append, and a logger
+// only ever flushes failures that were appended through it.
+
+typedef struct RZAssertBatchSegment {
+    struct RZAssertBatchSegment *next;
+    NSUInteger capacity;
+    NSUInteger count;
+    void *failures[];
+} RZAssertBatchSegment;
+
+struct RZAssertBatchBufferSet;
+
+typedef struct RZAssertBatchBuffer {
+    // The next buffer in the set, guarded by the set's lock.
+    struct RZAssertBatchBuffer *next;
+    // The next buffer of the owning thread, only touched by that thread.
+    struct RZAssertBatchBuffer *threadNext;
+    struct RZAssertBatchBufferSet *set;
+    RZAssertBatchSegment *segment;
+    int32_t appending;
+    int32_t dirty;
+} RZAssertBatchBuffer;
+
+// The buffers of live threads, and the segments left behind by exited threads.
+// Guarded by lock, which is taken when a thread first appends, when it exits, and
+// to flush, but never to append. The logger and each buffer hold a reference, so
+// threads can outlive the logger and still find their buffer's set on exit.
+typedef struct RZAssertBatchBufferSet {
+    pthread_mutex_t lock;
+    RZAssertBatchBuffer *buffers;
+    RZAssertBatchSegment *orphanedSegments;
+    NSUInteger segmentCapacity;
+    int32_t referenceCount;
+    int32_t retired;
+} RZAssertBatchBufferSet;
+
+static pthread_key_t s_bufferKey;
+static pthread_once_t s_bufferKeyOnce = PTHREAD_ONCE_INIT;
+
+static RZAssertBatchSegment *RZAssertBatchSegmentCreate(NSUInteger capacity)
+{
+    RZAssertBatchSegment *segment = calloc(1, sizeof(RZAssertBatchSegment) + capacity * sizeof(void *));
+    segment->capacity = capacity;
+    return segment;
+}
+
+static RZAssertBatchBufferSet *RZAssertBatchBufferSetCreate(NSUInteger segmentCapacity)
+{
+    RZAssertBatchBufferSet *set = calloc(1, sizeof(RZAssertBatchBufferSet));
+    pthread_mutex_init(&set->lock, NULL);
+    set->segmentCapacity = segmentCapacity;
+    set->referenceCount = 1;
+    return set;
+}
+
+static void RZAssertBatchBufferSetRelease(RZAssertBatchBufferSet *set)
+{
+    if ( __atomic_sub_fetch(&set->referenceCount, 1, __ATOMIC_ACQ_REL) > 0 ) {
+        return;
+    }
+
+    // Nothing appends to a retired set, so this only happens if a failure raced the logger's
+    // final flush. There is no one left to deliver it to.
+    RZAssertBatchSegment *segment = set->orphanedSegments;
+    while ( segment != NULL ) {
+        for ( NSUInteger i = 0; i < segment->count; i++ ) {
+            CFRelease(segment->failures[i]);
+        }
+
+        RZAssertBatchSegment *next = segment->next;
+        free(segment);
+        segment = next;
+    }
+
+    pthread_mutex_destroy(&set->lock);
+    free(set);
+}
+
+// Removes the buffer from its set, keeping its failures for the set's next flush.
+static void RZAssertBatchBufferDetach(RZAssertBatchBuffer *buffer)
+{
+    RZAssertBatchBufferSet *set = buffer->set;
+
+    pthread_mutex_lock(&set->lock);
+
+    for ( RZAssertBatchBuffer **link = &set->buffers; *link != NULL; link = &(*link)->next ) {
+        if ( *link == buffer ) {
+            *link = buffer->next;
+            break;
+        }
+    }
+
+    // Only the owning thread detaches, and flushes hold the lock, so nothing else touches the segment.
+    RZAssertBatchSegment *segment = buffer->segment;
+    if ( segment->count > 0 ) {
+        segment->next = set->orphanedSegments;
+        set->orphanedSegments = segment;
+    }
+    else {
+        free(segment);
+    }
+
+    pthread_mutex_unlock(&set->lock);
+
+    RZAssertBatchBufferSetRelease(set);
+    free(buffer);
+}
+
+static void RZAssertBatchThreadBuffersDestroy(void *context)
+{
+    RZAssertBatchBuffer *buffer = context;
+
+    while ( buffer != NULL ) {
+        RZAssertBatchBuffer *threadNext = buffer->threadNext;
+        RZAssertBatchBufferDetach(buffer);
+        buffer = threadNext;
+    }
+}
+
+static void RZAssertBatchBufferKeyCreate(void)
+{
+    pthread_key_create(&s_bufferKey, RZAssertBatchThreadBuffersDestroy);
+}
+
+static RZAssertBatchBuffer *RZAssertBatchBufferForCurrentThread(RZAssertBatchBufferSet *set)
+{
+    pthread_once(&s_bufferKeyOnce, RZAssertBatchBufferKeyCreate);
+
+    RZAssertBatchBuffer *threadBuffers = pthread_getspecific(s_bufferKey);
+
+    // Usually the first buffer, since new buffers go in front. Buffers of loggers that have gone away are
+    // dropped on the way, so a thread keeps at most one of them until it next creates a buffer or exits.
+    RZAssertBatchBuffer *buffer = NULL;
+    for ( RZAssertBatchBuffer **link = &threadBuffers; *link != NULL; ) {
+        RZAssertBatchBuffer *candidate = *link;
+
+        if ( candidate->set == set ) {
+            buffer = candidate;
+            break;
+        }
+
+        if ( __atomic_load_n(&candidate->set->retired, __ATOMIC_ACQUIRE) ) {
+            *link = candidate->threadNext;
+            RZAssertBatchBufferDetach(candidate);
+        }
+        else {
+            link = &candidate->threadNext;
+        }
+    }
+
+    if ( RZASSERT_UNLIKELY(buffer == NULL) ) {
+        buffer = calloc(1, sizeof(RZAssertBatchBuffer));
+        buffer->set = set;
+        buffer->segment = RZAssertBatchSegmentCreate(set->segmentCapacity);
+        __atomic_add_fetch(&set->referenceCount, 1, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&set->lock);
+        buffer->next = set->buffers;
+        set->buffers = buffer;
+        pthread_mutex_unlock(&set->lock);
+
+        buffer->threadNext = threadBuffers;
+        threadBuffers = buffer;
+    }
+
+    if ( threadBuffers != pthread_getspecific(s_bufferKey) ) {
+        pthread_setspecific(s_bufferKey, threadBuffers);
+    }
+
+    return buffer;
+}
+
+// Returns the segment if this append filled it and the owner took it back, otherwise NULL.
+static RZAssertBatchSegment *RZAssertBatchBufferAppend(RZAssertBatchBuffer *buffer, RZAssertFailure *failure)
+{
+    __atomic_store_n(&buffer->appending, 1, __ATOMIC_SEQ_CST);
+
+    // While appending is set, a flush that takes the segment waits before delivering
+    // it, so the segment can't be freed, or its address reused, until it's cleared.
+    RZAssertBatchSegment *segment = __atomic_load_n(&buffer->segment, __ATOMIC_SEQ_CST);
+    NSUInteger count = segment->count;
+    BOOL full = ( count + 1 >= segment->capacity );
+    segment->failures[count] = (__bridge_retained void *)failure;
+    __atomic_store_n(&segment->count, count + 1, __ATOMIC_RELEASE);
+    __atomic_store_n(&buffer->dirty, 1, __ATOMIC_RELEASE);
+
+    RZAssertBatchSegment *fullSegment = NULL;
+
+    if ( full ) {
+        // If a flush already took the segment, it delivers it instead.
+        RZAssertBatchSegment *emptySegment = RZAssertBatchSegmentCreate(buffer->set->segmentCapacity);
+        if ( __atomic_compare_exchange_n(&buffer->segment, &segment, emptySegment, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED) ) {
+            fullSegment = segment;
+        }
+        else {
+            free(emptySegment);
+        }
+    }
+
+    __atomic_store_n(&buffer->appending, 0, __ATOMIC_RELEASE);
+
+    return fullSegment;
+}
+
+// Takes every nonempty segment in the set, from live and exited threads, as a list.
+static RZAssertBatchSegment *RZAssertBatchBuffersCollect(RZAssertBatchBufferSet *set)
+{
+    pthread_mutex_lock(&set->lock);
+
+    RZAssertBatchSegment *collected = set->orphanedSegments;
+    set->orphanedSegments = NULL;
+
+    for ( RZAssertBatchBuffer *buffer = set->buffers; buffer != NULL; buffer = buffer->next ) {
+        if ( !__atomic_exchange_n(&buffer->dirty, 0, __ATOMIC_ACQ_REL) ) {
+            continue;
+        }
+
+        RZAssertBatchSegment *segment = __atomic_exchange_n(&buffer->segment, RZAssertBatchSegmentCreate(set->segmentCapacity), __ATOMIC_SEQ_CST);
+
+        while ( __atomic_load_n(&buffer->appending, __ATOMIC_SEQ_CST) ) {
+            sched_yield();
+        }
+
+        if ( __atomic_load_n(&segment->count, __ATOMIC_ACQUIRE) > 0 ) {
+            segment->next = collected;
+            collected = segment;
+        }
+        else {
+            free(segment);
+        }
+    }
+
+    pthread_mutex_unlock(&set->lock);
+
+    return collected;
+}
+
+// Delivers each segment as a batch, freeing the segments.
+static void RZAssertBatchSegmentsDeliver(RZAssertBatchSegment *segments, void (^deliveryHandler)(NSArray *failures))
+{
+    RZAssertBatchSegment *segment = segments;
+
+    while ( segment != NULL ) {
+        NSMutableArray *failures = [NSMutableArray arrayWithCapacity:segment->count];
+        for ( NSUInteger i = 0; i < segment->count; i++ ) {
+            [failures addObject:CFBridgingRelease(segment->failures[i])];
+        }
+
+        RZAssertBatchSegment *next = segment->next;
+        free(segment);
+        segment = next;
+
+        deliveryHandler(failures);
+    }
+}
+
+#pragma mark - RZAssertBatchLogger
+
+@interface RZAssertBatchLogger () {
+    RZAssertBatchBufferSet *_bufferSet;
+    int32_t _stopping;
+}
+
+@property (copy, nonatomic) void (^deliveryHandler)(NSArray *failures);
+@property (strong, nonatomic) dispatch_queue_t deliveryQueue;
+@property (strong, nonatomic) dispatch_source_t flushTimer;
+
+@end
+
+@implementation RZAssertBatchLogger
+
+- (instancetype)initWithMaximumBatchSize:(NSUInteger)maximumBatchSize flushInterval:(NSTimeInterval)flushInterval deliveryHandler:(void(^)(NSArray *failures))deliveryHandler
+{
+    if ( !deliveryHandler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: deliveryHandler must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    self = [super init];
+    if ( self ) {
+        _bufferSet = RZAssertBatchBufferSetCreate(maximumBatchSize);
+
+        _deliveryHandler = [deliveryHandler copy];
+        _deliveryQueue = dispatch_queue_create(kRZAssertBatchDeliveryQueueLabel, DISPATCH_QUEUE_SERIAL);
+        dispatch_queue_set_specific(_deliveryQueue, kRZAssertBatchDeliveryQueueKey, kRZAssertBatchDeliveryQueueKey, NULL);
+
+        uint64_t interval = (uint64_t)(flushInterval * NSEC_PER_SEC);
+        _flushTimer = dispatch_source_create(DISPATCH_SOURCE_TYPE_TIMER, 0, 0, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_LOW, 0));
+        dispatch_source_set_timer(_flushTimer, dispatch_time(DISPATCH_TIME_NOW, (int64_t)interval), interval, interval / 10);
+
+        __weak typeof(self) weakSelf = self;
+        dispatch_source_set_event_handler(_flushTimer, ^{
+            typeof(self) strongSelf = weakSelf;
+            if ( strongSelf ) {
+                [strongSelf deliverSegments:RZAssertBatchBuffersCollect(strongSelf->_bufferSet) waitUntilDone:NO];
+            }
+        });
+
+        dispatch_resume(_flushTimer);
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    dispatch_source_cancel(_flushTimer);
+
+    // An append that raced -stop may have left failures behind. Nothing can append once
+    // the logger is gone, so these are the last, and threads drop their buffers lazily.
+    RZAssertBatchSegmentsDeliver(RZAssertBatchBuffersCollect(_bufferSet), _deliveryHandler);
+
+    __atomic_store_n(&_bufferSet->retired, 1, __ATOMIC_RELEASE);
+    RZAssertBatchBufferSetRelease(_bufferSet);
+}
+
+#pragma mark - Public
+
+- (void)appendFailure:(RZAssertFailure *)failure
+{
+    if ( __atomic_load_n(&_stopping, __ATOMIC_ACQUIRE) ) {
+        self.deliveryHandler(@[failure]);
+        return;
+    }
+
+    RZAssertBatchSegment *fullSegment = RZAssertBatchBufferAppend(RZAssertBatchBufferForCurrentThread(_bufferSet), failure);
+
+    if ( fullSegment ) {
+        fullSegment->next = NULL;
+        [self deliverSegments:fullSegment waitUntilDone:NO];
+    }
+}
+
+- (void)flush
+{
+    [self deliverSegments:RZAssertBatchBuffersCollect(_bufferSet) waitUntilDone:YES];
+}
+
+- (void)stop
+{
+    if ( __atomic_exchange_n(&_stopping, 1, __ATOMIC_ACQ_REL) ) {
+        return;
+    }
+
+    dispatch_source_cancel(self.flushTimer);
+    [self flush];
+}
+
+#pragma mark - Private
+
+- (void)deliverSegments:(RZAssertBatchSegment *)segments waitUntilDone:(BOOL)waitUntilDone
+{
+    void (^deliveryHandler)(NSArray *) = self.deliveryHandler;
+
+    dispatch_block_t deliver = ^{
+        RZAssertBatchSegmentsDeliver(segments, deliveryHandler);
+    };
+
+    if ( !waitUntilDone ) {
+        if ( segments ) {
+            dispatch_async(self.deliveryQueue, deliver);
+        }
+    }
+    else if ( dispatch_get_specific(kRZAssertBatchDeliveryQueueKey) ) {
+        // Flushing from the handler itself. Everything queued before is already delivered.
+        deliver();
+    }
+    else {
+        // Also waits for batches queued before this flush.
+        dispatch_sync(self.deliveryQueue, deliver);
+    }
+}
+
+@end
@@ -0,0 +1,334 @@
+//
+//  RZAssertBreadcrumbs.c
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "RZAssertBreadcrumbs.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// Each slot's sequence is 0 while it is being written, and its ring index + 1 once it is
+// complete. A reader copies a slot out and only trusts the copy if the sequence it expects
+// was there both before and after. A copy can only be torn if more writers than slots are
+// writing at once.
+typedef struct {
+    uint64_t sequence;
+    double timestamp;
+    uint64_t threadID;
+    const char *kind;
+    const char *file;
+    const char *function;
+    uint32_t line;
+    uint32_t detailLength;
+    char detail[RZASSERT_BREADCRUMB_DETAIL_SIZE];
+} RZAssertBreadcrumb;
+
+typedef struct {
+    uint64_t writeIndex;
+    uint64_t mask;
+    RZAssertBreadcrumb slots[];
+} RZAssertBreadcrumbRing;
+
+static RZAssertBreadcrumbRing *s_ring = NULL;
+
+static const int s_fatalSignals[] = { SIGSEGV, SIGBUS, SIGABRT };
+#define RZASSERT_FATAL_SIGNAL_COUNT (sizeof(s_fatalSignals) / sizeof(s_fatalSignals[0]))
+
+static struct sigaction s_previousActions[RZASSERT_FATAL_SIGNAL_COUNT];
+static int s_handlersInstalled = 0;
+static int s_dumpFileDescriptor = -1;
+static int s_dumped = 0;
+
+#pragma mark - Ring
+
+int RZAssertBreadcrumbsEnable(size_t capacity)
+{
+    size_t slotCount = 1;
+    while ( slotCount < capacity ) {
+        slotCount *= 2;
+    }
+
+    RZAssertBreadcrumbRing *ring = calloc(1, sizeof(RZAssertBreadcrumbRing) + slotCount * sizeof(RZAssertBreadcrumb));
+    if ( ring == NULL ) {
+        return -1;
+    }
+    ring->mask = slotCount - 1;
+
+    __atomic_store_n(&s_ring, ring, __ATOMIC_RELEASE);
+    return 0;
+}
+
+void RZAssertBreadcrumbsDisable(void)
+{
+    __atomic_store_n(&s_ring, NULL, __ATOMIC_RELEASE);
+}
+
+int RZAssertBreadcrumbsEnabled(void)
+{
+    return ( __atomic_load_n(&s_ring, __ATOMIC_ACQUIRE) != NULL );
+}
+
+void RZAssertBreadcrumbsAppend(const char *kind, const char *file, uint32_t line, const char *function, double timestamp, uint64_t threadID, const char *detail, size_t detailLength)
+{
+    RZAssertBreadcrumbRing *ring = __atomic_load_n(&s_ring, __ATOMIC_ACQUIRE);
+    if ( ring == NULL ) {
+        return;
+    }
+
+    uint64_t index = __atomic_fetch_add(&ring->writeIndex, 1, __ATOMIC_RELAXED);
+    RZAssertBreadcrumb *slot = &ring->slots[index & ring->mask];
+
+    __atomic_store_n(&slot->sequence, 0, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    if ( detailLength > RZASSERT_BREADCRUMB_DETAIL_SIZE ) {
+        detailLength = RZASSERT_BREADCRUMB_DETAIL_SIZE;
+    }
+
+    slot->timestamp = timestamp;
+    slot->threadID = threadID;
+    slot->kind = kind;
+    slot->file = file;
+    slot->function = function;
+    slot->line = line;
+    slot->detailLength = (uint32_t)detailLength;
+    memcpy(slot->detail, detail, detailLength);
+
+    __atomic_store_n(&slot->sequence, index + 1, __ATOMIC_RELEASE);
+}
+
+#pragma mark - Dumping
+
+// Formats into a stack buffer and writes it out with write(2), so dumping never allocates.
+typedef struct {
+    int fileDescriptor;
+    size_t length;
+    char bytes[512];
+} RZAssertBreadcrumbWriter;
+
+static void RZAssertBreadcrumbWriterFlush(RZAssertBreadcrumbWriter *writer)
+{
+    size_t written = 0;
+
+    while ( written < writer->length ) {
+        ssize_t result = write(writer->fileDescriptor, writer->bytes + written, writer->length - written);
+        if ( result < 0 && errno == EINTR ) {
+            continue;
+        }
+        if ( result <= 0 ) {
+            break;
+        }
+        written += (size_t)result;
+    }
+
+    writer->length = 0;
+}
+
+static void RZAssertBreadcrumbWriterAppendByte(RZAssertBreadcrumbWriter *writer, char byte)
+{
+    if ( writer->length == sizeof(writer->bytes) ) {
+        RZAssertBreadcrumbWriterFlush(writer);
+    }
+    writer->bytes[writer->length++] = byte;
+}
+
+static void RZAssertBreadcrumbWriterAppend(RZAssertBreadcrumbWriter *writer, const char *bytes, size_t length)
+{
+    for ( size_t i = 0; i < length; i++ ) {
+        // Keep each breadcrumb on one line.
+        RZAssertBreadcrumbWriterAppendByte(writer, ( bytes[i] == '\n' || bytes[i] == '\r' ) ? ' ' : bytes[i]);
+    }
+}
+
+static void RZAssertBreadcrumbWriterAppendString(RZAssertBreadcrumbWriter *writer, const char *string)
+{
+    if ( string ) {
+        RZAssertBreadcrumbWriterAppend(writer, string, strlen(string));
+    }
+}
+
+static void RZAssertBreadcrumbWriterAppendNumber(RZAssertBreadcrumbWriter *writer, uint64_t number, int minimumDigits)
+{
+    char digits[20];
+    int count = 0;
+
+    do {
+        digits[sizeof(digits) - 1 - count++] = (char)('0' + number % 10);
+        number /= 10;
+    } while ( number > 0 || count < minimumDigits );
+
+    RZAssertBreadcrumbWriterAppend(writer, digits + sizeof(digits) - count, (size_t)count);
+}
+
+size_t RZAssertBreadcrumbsDump(int fileDescriptor)
+{
+    RZAssertBreadcrumbRing *ring = __atomic_load_n(&s_ring, __ATOMIC_ACQUIRE);
+    if ( ring == NULL ) {
+        return 0;
+    }
+
+    RZAssertBreadcrumbWriter writer;
+    writer.fileDescriptor = fileDescriptor;
+    writer.length = 0;
+
+    uint64_t end = __atomic_load_n(&ring->writeIndex, __ATOMIC_ACQUIRE);
+    uint64_t start = ( end > ring->mask + 1 ) ? end - (ring->mask + 1) : 0;
+    size_t dumped = 0;
+
+    RZAssertBreadcrumbWriterAppendString(&writer, "RZAssert breadcrumbs:");
+    RZAssertBreadcrumbWriterAppendByte(&writer, '\n');
+
+    for ( uint64_t index = start; index < end; index++ ) {
+        RZAssertBreadcrumb *slot = &ring->slots[index & ring->mask];
+        RZAssertBreadcrumb breadcrumb;
+
+        if ( __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE) != index + 1 ) {
+            continue;
+        }
+        memcpy(&breadcrumb, slot, sizeof(breadcrumb));
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if ( __atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != index + 1 ) {
+            continue;
+        }
+
+        // #<index> <seconds since 2001>.<milliseconds> thread <id> <kind> <file>:<line> <function>: <detail>
+        uint64_t milliseconds = ( breadcrumb.timestamp > 0.0 ) ? (uint64_t)(breadcrumb.timestamp * 1000.0) : 0;
+        RZAssertBreadcrumbWriterAppendString(&writer, "#");
+        RZAssertBreadcrumbWriterAppendNumber(&writer, index, 1);
+        RZAssertBreadcrumbWriterAppendString(&writer, " ");
+        RZAssertBreadcrumbWriterAppendNumber(&writer, milliseconds / 1000, 1);
+        RZAssertBreadcrumbWriterAppendString(&writer, ".");
+        RZAssertBreadcrumbWriterAppendNumber(&writer, milliseconds % 1000, 3);
+        RZAssertBreadcrumbWriterAppendString(&writer, " thread ");
+        RZAssertBreadcrumbWriterAppendNumber(&writer, breadcrumb.threadID, 1);
+        if ( breadcrumb.kind ) {
+            RZAssertBreadcrumbWriterAppendString(&writer, " ");
+            RZAssertBreadcrumbWriterAppendString(&writer, breadcrumb.kind);
+        }
+        if ( breadcrumb.file ) {
+            RZAssertBreadcrumbWriterAppendString(&writer, " ");
+            RZAssertBreadcrumbWriterAppendString(&writer, breadcrumb.file);
+            RZAssertBreadcrumbWriterAppendString(&writer, ":");
+            RZAssertBreadcrumbWriterAppendNumber(&writer, breadcrumb.line, 1);
+        }
+        if ( breadcrumb.function ) {
+            RZAssertBreadcrumbWriterAppendString(&writer, " ");
+            RZAssertBreadcrumbWriterAppendString(&writer, breadcrumb.function);
+        }
+        RZAssertBreadcrumbWriterAppendString(&writer, ": ");
+        RZAssertBreadcrumbWriterAppend(&writer, breadcrumb.detail, breadcrumb.detailLength);
+        RZAssertBreadcrumbWriterAppendByte(&writer, '\n');
+
+        dumped++;
+    }
+
+    RZAssertBreadcrumbWriterFlush(&writer);
+
+    return dumped;
+}
+
+#pragma mark - Signal Handlers
+
+static void RZAssertBreadcrumbsHandleSignal(int signalNumber, siginfo_t *info, void *context)
+{
+    int fileDescriptor = __atomic_load_n(&s_dumpFileDescriptor, __ATOMIC_ACQUIRE);
+
+    // Only the first crashing thread dumps.
+    if ( fileDescriptor >= 0 && !__atomic_exchange_n(&s_dumped, 1, __ATOMIC_ACQ_REL) ) {
+        RZAssertBreadcrumbsDump(fileDescriptor);
+    }
+
+    for ( size_t i = 0; i < RZASSERT_FATAL_SIGNAL_COUNT; i++ ) {
+        if ( s_fatalSignals[i] != signalNumber ) {
+            continue;
+        }
+
+        const struct sigaction *previous = &s_previousActions[i];
+
+        if ( (previous->sa_flags & SA_SIGINFO) && previous->sa_sigaction ) {
+            previous->sa_sigaction(signalNumber, info, context);
+        }
+        else if ( previous->sa_handler == SIG_DFL || previous->sa_handler == SIG_IGN ) {
+            // Put the previous disposition back and re-raise. The signal is blocked while this
+            // handler runs, so it is delivered as soon as the handler returns.
+            sigaction(signalNumber, previous, NULL);
+            raise(signalNumber);
+        }
+        else {
+            previous->sa_handler(signalNumber);
+        }
+    }
+}
+
+int RZAssertBreadcrumbsInstallSignalHandlers(int fileDescriptor)
+{
+    __atomic_store_n(&s_dumpFileDescriptor, fileDescriptor, __ATOMIC_RELEASE);
+    __atomic_store_n(&s_dumped, 0, __ATOMIC_RELEASE);
+
+    if ( s_handlersInstalled ) {
+        return 0;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = RZAssertBreadcrumbsHandleSignal;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    for ( size_t i = 0; i < RZASSERT_FATAL_SIGNAL_COUNT; i++ ) {
+        sigaddset(&action.sa_mask, s_fatalSignals[i]);
+    }
+
+    for ( size_t i = 0; i < RZASSERT_FATAL_SIGNAL_COUNT; i++ ) {
+        if ( sigaction(s_fatalSignals[i], &action, &s_previousActions[i]) != 0 ) {
+            // Undo the ones already installed.
+            while ( i-- > 0 ) {
+                sigaction(s_fatalSignals[i], &s_previousActions[i], NULL);
+            }
+            __atomic_store_n(&s_dumpFileDescriptor, -1, __ATOMIC_RELEASE);
+            return -1;
+        }
+    }
+
+    s_handlersInstalled = 1;
+    return 0;
+}
+
+void RZAssertBreadcrumbsRemoveSignalHandlers(void)
+{
+    if ( !s_handlersInstalled ) {
+        return;
+    }
+
+    for ( size_t i = 0; i < RZASSERT_FATAL_SIGNAL_COUNT; i++ ) {
+        sigaction(s_fatalSignals[i], &s_previousActions[i], NULL);
+    }
+
+    s_handlersInstalled = 0;
+    __atomic_store_n(&s_dumpFileDescriptor, -1, __ATOMIC_RELEASE);
+}
@@ -0,0 +1,107 @@
+//
+//  RZAssertBreadcrumbs.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// A preallocated ring of the most recent failures, that a fatal signal handler can write out.
+// Plain C, and async-signal-safe on the reading side, so it can be dumped while the process
+// is crashing. For private use only; see +[RZAssert enableBreadcrumbsWithCapacity:].
+
+#ifndef RZAssertBreadcrumbs_h
+#define RZAssertBreadcrumbs_h
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if !defined(RZASSERT_C_EXPORT)
+    #if defined(__cplusplus)
+        #define RZASSERT_C_EXPORT extern "C"
+    #else
+        #define RZASSERT_C_EXPORT extern
+    #endif
+#endif
+
+/**
+ *  The longest failure detail kept in a breadcrumb, in bytes. Longer details are truncated.
+ */
+#define RZASSERT_BREADCRUMB_DETAIL_SIZE 256
+
+/**
+ *  Allocates a ring for the last @c capacity failures and makes it current, replacing any current ring. Nothing is allocated when failures are appended or dumped. A replaced ring is never freed, because a crashing thread may still be reading it.
+ *
+ *  @param capacity The number of breadcrumbs to keep. Rounded up to a power of two.
+ *
+ *  @return 0 on success, or -1 if the ring could not be allocated.
+ */
+RZASSERT_C_EXPORT int RZAssertBreadcrumbsEnable(size_t capacity);
+
+/**
+ *  Stops appending breadcrumbs. A dump writes nothing until breadcrumbs are enabled again.
+ */
+RZASSERT_C_EXPORT void RZAssertBreadcrumbsDisable(void);
+
+/**
+ *  Whether a ring is current.
+ */
+RZASSERT_C_EXPORT int RZAssertBreadcrumbsEnabled(void);
+
+/**
+ *  Copies a failure into the next slot of the current ring, overwriting the oldest. Lock-free, and does nothing if breadcrumbs are disabled. The strings other than @c detail must live for the life of the process, as call site strings do.
+ *
+ *  @param kind         The assertion macro, or NULL.
+ *  @param file         The file, or NULL.
+ *  @param line         The line.
+ *  @param function     The function, or NULL.
+ *  @param timestamp    Seconds since 00:00:00 UTC on 1 January 2001.
+ *  @param threadID     The failing thread.
+ *  @param detail       The failure detail, in UTF-8. Copied, and truncated to @c RZASSERT_BREADCRUMB_DETAIL_SIZE bytes.
+ *  @param detailLength The length of @c detail, in bytes.
+ */
+RZASSERT_C_EXPORT void RZAssertBreadcrumbsAppend(const char *kind, const char *file, uint32_t line, const char *function, double timestamp, uint64_t threadID, const char *detail, size_t detailLength);
+
+/**
+ *  Writes the breadcrumbs in the current ring to a file descriptor as text, oldest first, one per line. Uses only async-signal-safe calls, so it may be called from a signal handler. Slots being written at the time are skipped.
+ *
+ *  @param fileDescriptor The file descriptor to write to.
+ *
+ *  @return The number of breadcrumbs written.
+ */
+RZASSERT_C_EXPORT size_t RZAssertBreadcrumbsDump(int fileDescriptor);
+
+/**
+ *  Installs handlers for SIGSEGV, SIGBUS and SIGABRT that dump the breadcrumbs to a file descriptor, then pass the signal on to whatever handler was installed before. Calling this again only changes the file descriptor.
+ *
+ *  @param fileDescriptor The file descriptor to dump to. It must stay open.
+ *
+ *  @return 0 on success, or -1 if a handler could not be installed.
+ */
+RZASSERT_C_EXPORT int RZAssertBreadcrumbsInstallSignalHandlers(int fileDescriptor);
+
+/**
+ *  Restores the handlers that were installed before @c RZAssertBreadcrumbsInstallSignalHandlers().
+ */
+RZASSERT_C_EXPORT void RZAssertBreadcrumbsRemoveSignalHandlers(void);
+
+#endif
@@ -0,0 +1,255 @@
+//
+//  RZAssertBufferChecks.c
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#include "RZAssertBufferChecks.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// The kernels are written once with GCC/Clang vector extensions, and compiled for each
+// vector width. Whole vectors are tested until one has a failing lane; the scalar loop
+// then finds the failing element in that vector, and handles the tail.
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define RZASSERT_VECTOR_BYTES   16      // SSE2
+    #define RZASSERT_HAS_AVX2       1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define RZASSERT_VECTOR_BYTES   16      // NEON
+#endif
+
+#define RZASSERT_KERNEL_NAME_(name, suffix) name##suffix
+#define RZASSERT_KERNEL_NAME(name, suffix)  RZASSERT_KERNEL_NAME_(name, suffix)
+
+// Defines a kernel that returns the index of the first element at or after start for
+// which scalarFails is true, or count. Inside the tests, v is the vector at i, p the
+// vector one element earlier, and x the scalar at i.
+#define RZASSERT_DEFINE_VECTOR_KERNEL(name, attributes, type, vectorBytes, start, parameters, setup, vectorFails, scalarFails) \
+    static attributes size_t name(const type *values, size_t count parameters) \
+    { \
+        typedef type RZAssertVector __attribute__((vector_size(vectorBytes))); \
+        typedef uint64_t RZAssertWords __attribute__((vector_size(vectorBytes))); \
+        enum { lanes = (vectorBytes) / sizeof(type) }; \
+        setup \
+        size_t i = (start); \
+        for ( ; i + lanes <= count; i += lanes ) { \
+            RZAssertVector v; \
+            RZAssertVector p; \
+            memcpy(&v, values + i, sizeof(v)); \
+            memcpy(&p, values + i - (start), sizeof(p)); \
+            (void)p; \
+            RZAssertWords failures = (RZAssertWords)(vectorFails); \
+            uint64_t anyFailed = 0; \
+            for ( size_t w = 0; w < (vectorBytes) / sizeof(uint64_t); w++ ) { \
+                anyFailed |= failures[w]; \
+            } \
+            if ( anyFailed ) { \
+                break; \
+            } \
+        } \
+        for ( ; i < count; i++ ) { \
+            type x = values[i]; \
+            if ( scalarFails ) { \
+                return i; \
+            } \
+        } \
+        return count; \
+    }
+
+#define RZASSERT_DEFINE_SCALAR_KERNEL(name, type, start, parameters, scalarFails) \
+    static size_t name(const type *values, size_t count parameters) \
+    { \
+        for ( size_t i = (start); i < count; i++ ) { \
+            type x = values[i]; \
+            if ( scalarFails ) { \
+                return i; \
+            } \
+        } \
+        return count; \
+    }
+
+// Splats the range bounds into vectors.
+#define RZASSERT_RANGE_SETUP \
+    RZAssertVector lowVector; \
+    RZAssertVector highVector; \
+    for ( size_t k = 0; k < lanes; k++ ) { \
+        lowVector[k] = low; \
+        highVector[k] = high; \
+    }
+
+// x - x is 0 for finite values, and NaN for infinities and NaN, so one self-comparison tests both.
+#define RZASSERT_NON_FINITE_VECTOR      ((v - v) != (v - v))
+#define RZASSERT_NON_FINITE_SCALAR      (!isfinite(x))
+#define RZASSERT_OUT_OF_RANGE_VECTOR    (~((v >= lowVector) & (v <= highVector)))
+#define RZASSERT_OUT_OF_RANGE_SCALAR    (!(x >= low && x <= high))
+#define RZASSERT_UNSORTED_VECTOR        (~(p <= v))
+#define RZASSERT_UNSORTED_SCALAR        (!(values[i - 1] <= x))
+
+#define RZASSERT_RANGE_PARAMETERS(type) , type low, type high
+
+// Defines every kernel for one vector width, or one element at a time if vectorBytes is 0.
+#define RZASSERT_DEFINE_KERNELS(suffix, attributes, vectorBytes) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertNonFiniteFloat, suffix), attributes, float, vectorBytes, 0, , , RZASSERT_NON_FINITE_VECTOR, RZASSERT_NON_FINITE_SCALAR) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertNonFiniteDouble, suffix), attributes, double, vectorBytes, 0, , , RZASSERT_NON_FINITE_VECTOR, RZASSERT_NON_FINITE_SCALAR) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertOutOfRangeFloat, suffix), attributes, float, vectorBytes, 0, RZASSERT_RANGE_PARAMETERS(float), RZASSERT_RANGE_SETUP, RZASSERT_OUT_OF_RANGE_VECTOR, RZASSERT_OUT_OF_RANGE_SCALAR) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertOutOfRangeDouble, suffix), attributes, double, vectorBytes, 0, RZASSERT_RANGE_PARAMETERS(double), RZASSERT_RANGE_SETUP, RZASSERT_OUT_OF_RANGE_VECTOR, RZASSERT_OUT_OF_RANGE_SCALAR) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertOutOfRangeInt, suffix), attributes, int, vectorBytes, 0, RZASSERT_RANGE_PARAMETERS(int), RZASSERT_RANGE_SETUP, RZASSERT_OUT_OF_RANGE_VECTOR, RZASSERT_OUT_OF_RANGE_SCALAR) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertUnsortedFloat, suffix), attributes, float, vectorBytes, 1, , , RZASSERT_UNSORTED_VECTOR, RZASSERT_UNSORTED_SCALAR) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertUnsortedDouble, suffix), attributes, double, vectorBytes, 1, , , RZASSERT_UNSORTED_VECTOR, RZASSERT_UNSORTED_SCALAR) \
+    RZASSERT_DEFINE_VECTOR_KERNEL(RZASSERT_KERNEL_NAME(RZAssertUnsortedInt, suffix), attributes, int, vectorBytes, 1, , , RZASSERT_UNSORTED_VECTOR, RZASSERT_UNSORTED_SCALAR)
+
+// Defines a kernel that returns the offset of the first byte at which two buffers differ,
+// or count. Tested a whole vector at a time, then byte by byte as above.
+#define RZASSERT_DEFINE_DIFFERENCE_KERNEL(name, attributes, vectorBytes) \
+    static attributes size_t name(const unsigned char *left, const unsigned char *right, size_t count) \
+    { \
+        typedef unsigned char RZAssertVector __attribute__((vector_size(vectorBytes))); \
+        typedef uint64_t RZAssertWords __attribute__((vector_size(vectorBytes))); \
+        size_t i = 0; \
+        for ( ; i + (vectorBytes) <= count; i += (vectorBytes) ) { \
+            RZAssertVector l; \
+            RZAssertVector r; \
+            memcpy(&l, left + i, sizeof(l)); \
+            memcpy(&r, right + i, sizeof(r)); \
+            RZAssertWords differences = (RZAssertWords)(l != r); \
+            uint64_t anyDifferent = 0; \
+            for ( size_t w = 0; w < (vectorBytes) / sizeof(uint64_t); w++ ) { \
+                anyDifferent |= differences[w]; \
+            } \
+            if ( anyDifferent ) { \
+                break; \
+            } \
+        } \
+        for ( ; i < count; i++ ) { \
+            if ( left[i] != right[i] ) { \
+                return i; \
+            } \
+        } \
+        return count; \
+    }
+
+#pragma mark - Kernels
+
+#if !defined(RZASSERT_VECTOR_BYTES)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertNonFiniteFloatScalar, float, 0, , RZASSERT_NON_FINITE_SCALAR)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertNonFiniteDoubleScalar, double, 0, , RZASSERT_NON_FINITE_SCALAR)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertOutOfRangeFloatScalar, float, 0, RZASSERT_RANGE_PARAMETERS(float), RZASSERT_OUT_OF_RANGE_SCALAR)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertOutOfRangeDoubleScalar, double, 0, RZASSERT_RANGE_PARAMETERS(double), RZASSERT_OUT_OF_RANGE_SCALAR)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertOutOfRangeIntScalar, int, 0, RZASSERT_RANGE_PARAMETERS(int), RZASSERT_OUT_OF_RANGE_SCALAR)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertUnsortedFloatScalar, float, 1, , RZASSERT_UNSORTED_SCALAR)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertUnsortedDoubleScalar, double, 1, , RZASSERT_UNSORTED_SCALAR)
+RZASSERT_DEFINE_SCALAR_KERNEL(RZAssertUnsortedIntScalar, int, 1, , RZASSERT_UNSORTED_SCALAR)
+
+static size_t RZAssertDifferentByteScalar(const unsigned char *left, const unsigned char *right, size_t count)
+{
+    for ( size_t i = 0; i < count; i++ ) {
+        if ( left[i] != right[i] ) {
+            return i;
+        }
+    }
+    return count;
+}
+#else
+RZASSERT_DEFINE_KERNELS(Vector, , RZASSERT_VECTOR_BYTES)
+RZASSERT_DEFINE_DIFFERENCE_KERNEL(RZAssertDifferentByteVector, , RZASSERT_VECTOR_BYTES)
+#endif
+
+#if defined(RZASSERT_HAS_AVX2)
+RZASSERT_DEFINE_KERNELS(AVX2, __attribute__((target("avx2"))), 32)
+RZASSERT_DEFINE_DIFFERENCE_KERNEL(RZAssertDifferentByteAVX2, __attribute__((target("avx2"))), 32)
+
+static int RZAssertCPUHasAVX2(void)
+{
+    static int s_hasAVX2 = -1;
+
+    int hasAVX2 = __atomic_load_n(&s_hasAVX2, __ATOMIC_RELAXED);
+    if ( hasAVX2 < 0 ) {
+        __builtin_cpu_init();
+        hasAVX2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+        __atomic_store_n(&s_hasAVX2, hasAVX2, __ATOMIC_RELAXED);
+    }
+
+    return hasAVX2;
+}
+#endif
+
+#pragma mark - Dispatch
+
+// Calls the widest kernel available on this CPU.
+#if defined(RZASSERT_HAS_AVX2)
+    #define RZASSERT_DISPATCH(name, ...) \
+        return RZAssertCPUHasAVX2() ? name##AVX2(__VA_ARGS__) : name##Vector(__VA_ARGS__)
+#elif defined(RZASSERT_VECTOR_BYTES)
+    #define RZASSERT_DISPATCH(name, ...)    return name##Vector(__VA_ARGS__)
+#else
+    #define RZASSERT_DISPATCH(name, ...)    return name##Scalar(__VA_ARGS__)
+#endif
+
+size_t RZAssertFirstNonFiniteFloat(const float *values, size_t count)
+{
+    RZASSERT_DISPATCH(RZAssertNonFiniteFloat, values, count);
+}
+
+size_t RZAssertFirstNonFiniteDouble(const double *values, size_t count)
+{
+    RZASSERT_DISPATCH(RZAssertNonFiniteDouble, values, count);
+}
+
+size_t RZAssertFirstOutOfRangeFloat(const float *values, size_t count, float low, float high)
+{
+    RZASSERT_DISPATCH(RZAssertOutOfRangeFloat, values, count, low, high);
+}
+
+size_t RZAssertFirstOutOfRangeDouble(const double *values, size_t count, double low, double high)
+{
+    RZASSERT_DISPATCH(RZAssertOutOfRangeDouble, values, count, low, high);
+}
+
+size_t RZAssertFirstOutOfRangeInt(const int *values, size_t count, int low, int high)
+{
+    RZASSERT_DISPATCH(RZAssertOutOfRangeInt, values, count, low, high);
+}
+
+size_t RZAssertFirstUnsortedFloat(const float *values, size_t count)
+{
+    RZASSERT_DISPATCH(RZAssertUnsortedFloat, values, count);
+}
+
+size_t RZAssertFirstUnsortedDouble(const double *values, size_t count)
+{
+    RZASSERT_DISPATCH(RZAssertUnsortedDouble, values, count);
+}
+
+size_t RZAssertFirstUnsortedInt(const int *values, size_t count)
+{
+    RZASSERT_DISPATCH(RZAssertUnsortedInt, values, count);
+}
+
+size_t RZAssertFirstDifferentByte(const void *left, const void *right, size_t count)
+{
+    RZASSERT_DISPATCH(RZAssertDifferentByte, (const unsigned char *)left, (const unsigned char *)right, count);
+}
@@ -0,0 +1,95 @@
+//
+//  RZAssertBufferChecks.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Vectorized scans behind the buffer assertions, such as RZCASSERT_ALL_FINITE, and the string comparisons.
+// Plain C, so the kernels can be built and tested without Foundation.
+
+#ifndef RZAssertBufferChecks_h
+#define RZAssertBufferChecks_h
+
+#include <stddef.h>
+
+#if defined(__cplusplus)
+    #define RZASSERT_C_EXPORT extern "C"
+#else
+    #define RZASSERT_C_EXPORT extern
+#endif
+
+/**
+ *  Each function scans a buffer with the widest vectors the CPU supports (AVX2 or SSE2 on x86, NEON on ARM), or one element at a time elsewhere.
+ *
+ *  @return The index of the first element that fails the check, or @c count if they all pass.
+ */
+RZASSERT_C_EXPORT size_t RZAssertFirstNonFiniteFloat(const float *values, size_t count);
+RZASSERT_C_EXPORT size_t RZAssertFirstNonFiniteDouble(const double *values, size_t count);
+
+/**
+ *  Checks a closed range. NaN is never in range.
+ */
+RZASSERT_C_EXPORT size_t RZAssertFirstOutOfRangeFloat(const float *values, size_t count, float low, float high);
+RZASSERT_C_EXPORT size_t RZAssertFirstOutOfRangeDouble(const double *values, size_t count, double low, double high);
+RZASSERT_C_EXPORT size_t RZAssertFirstOutOfRangeInt(const int *values, size_t count, int low, int high);
+
+/**
+ *  Checks for ascending order, allowing repeats. An element is out of order if it is not greater than or equal to the one before it, so NaN is always out of order.
+ */
+RZASSERT_C_EXPORT size_t RZAssertFirstUnsortedFloat(const float *values, size_t count);
+RZASSERT_C_EXPORT size_t RZAssertFirstUnsortedDouble(const double *values, size_t count);
+RZASSERT_C_EXPORT size_t RZAssertFirstUnsortedInt(const int *values, size_t count);
+
+/**
+ *  Compares two buffers byte by byte, like memcmp(), but finds where they first differ. Used by the string assertions.
+ *
+ *  @return The offset of the first differing byte, or @c count if the buffers are equal.
+ */
+RZASSERT_C_EXPORT size_t RZAssertFirstDifferentByte(const void *left, const void *right, size_t count);
+
+// Pick the kernel for the buffer's element type at compile time. Other element types don't compile.
+
+#define RZASSERT_FIRST_NON_FINITE(values, count) _Generic((values), \
+    float *: RZAssertFirstNonFiniteFloat, \
+    const float *: RZAssertFirstNonFiniteFloat, \
+    double *: RZAssertFirstNonFiniteDouble, \
+    const double *: RZAssertFirstNonFiniteDouble)((values), (count))
+
+#define RZASSERT_FIRST_OUT_OF_RANGE(values, count, low, high) _Generic((values), \
+    float *: RZAssertFirstOutOfRangeFloat, \
+    const float *: RZAssertFirstOutOfRangeFloat, \
+    double *: RZAssertFirstOutOfRangeDouble, \
+    const double *: RZAssertFirstOutOfRangeDouble, \
+    int *: RZAssertFirstOutOfRangeInt, \
+    const int *: RZAssertFirstOutOfRangeInt)((values), (count), (low), (high))
+
+#define RZASSERT_FIRST_UNSORTED(values, count) _Generic((values), \
+    float *: RZAssertFirstUnsortedFloat, \
+    const float *: RZAssertFirstUnsortedFloat, \
+    double *: RZAssertFirstUnsortedDouble, \
+    const double *: RZAssertFirstUnsortedDouble, \
+    int *: RZAssertFirstUnsortedInt, \
+    const int *: RZAssertFirstUnsortedInt)((values), (count))
+
+#endif
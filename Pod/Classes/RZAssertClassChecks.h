@@ -0,0 +1,141 @@
+//
+//  RZAssertClassChecks.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+#import <objc/runtime.h>
+
+#pragma mark - Collections
+
+/**
+ *  Checks that every element of a collection is a kind of a class, without a message send for elements whose class already passed. For private use only; use @c RZASSERT_ALL_KINDOF.
+ *
+ *  @param collection    An array, set, or other fast-enumerable collection. A nil or empty collection passes.
+ *  @param testClass     The class every element must be a kind of.
+ *  @param failingIndex  On failure, set to the position of the first bad element in enumeration order.
+ *  @param failingObject On failure, set to the first bad element.
+ *
+ *  @return @c YES if every element passes.
+ */
+FOUNDATION_EXPORT BOOL RZAssertAllKindOfClass(id<NSFastEnumeration> collection, Class testClass, NSUInteger *failingIndex, __autoreleasing id *failingObject);
+
+/**
+ *  Checks that every key and every value of a dictionary is a kind of the corresponding class. For private use only; use @c RZASSERT_ALL_KEYS_VALUES_KINDOF.
+ *
+ *  @param dictionary    A dictionary. A nil or empty dictionary passes.
+ *  @param keyClass      The class every key must be a kind of.
+ *  @param valueClass    The class every value must be a kind of.
+ *  @param failingKey    On failure, set to the key of the first bad entry.
+ *  @param failingObject On failure, set to the first bad key or value.
+ *
+ *  @return @c YES if every entry passes.
+ */
+FOUNDATION_EXPORT BOOL RZAssertAllKeysAndValuesKindOfClasses(NSDictionary *dictionary, Class keyClass, Class valueClass, __autoreleasing id *failingKey, __autoreleasing id *failingObject);
+
+#pragma mark - Call Site Caches
+
+#define RZASSERT_CLASS_CACHE_SIZE 4
+
+/**
+ *  Remembers which classes passed a call site's type check, so repeat checks cost a pointer compare instead of a superclass walk. Each @c RZASSERT_KINDOF expansion owns one in static storage. Read and written with atomics, and never locked.
+ *
+ *  A cache belongs to the first class it is used with. Expansions whose class varies between calls use the cache for that first class only, and check other classes uncached.
+ *
+ *  Entries are only added for classes whose instances use NSObject's -isKindOfClass:, so proxies, which forward it, are never cached.
+ */
+typedef struct {
+    /**
+     *  The class being tested for, or 0 until the first check. Set once.
+     */
+    uintptr_t testClass;
+
+    /**
+     *  The value of @c RZAssertClassCacheEpoch when the entries were last cleared. The entries are ignored while it differs.
+     */
+    uint32_t epoch;
+
+    /**
+     *  Classes whose instances passed, or 0.
+     */
+    uintptr_t classes[RZASSERT_CLASS_CACHE_SIZE];
+} RZAssertClassCache;
+
+#define RZASSERT_CLASS_CACHE_INITIALIZER { 0, 0, { 0 } }
+
+/**
+ *  The current generation of every class cache. Starts at 1, so a new cache is filled on its first check. For private use only.
+ */
+FOUNDATION_EXPORT uint32_t RZAssertClassCacheEpoch;
+
+/**
+ *  Performs a full type check, and remembers the object's class in the cache if it passed. For private use only.
+ */
+FOUNDATION_EXPORT BOOL RZAssertClassCacheCheck(RZAssertClassCache *cache, id object, Class testClass);
+
+/**
+ *  Checks whether an object is a kind of a class, consulting the call site's cache first. Equivalent to [object isKindOfClass:testClass]. For private use only.
+ */
+NS_INLINE BOOL RZAssertIsKindOfClassCached(RZAssertClassCache *cache, id object, Class testClass)
+{
+    uintptr_t objectClass = (uintptr_t)object_getClass(object);
+    if ( objectClass == 0 ) {
+        return NO;
+    }
+
+    if ( __atomic_load_n(&cache->epoch, __ATOMIC_ACQUIRE) == __atomic_load_n(&RZAssertClassCacheEpoch, __ATOMIC_RELAXED) &&
+         __atomic_load_n(&cache->testClass, __ATOMIC_RELAXED) == (uintptr_t)testClass ) {
+        for ( NSUInteger i = 0; i < RZASSERT_CLASS_CACHE_SIZE; i++ ) {
+            if ( __atomic_load_n(&cache->classes[i], __ATOMIC_RELAXED) == objectClass ) {
+                return YES;
+            }
+        }
+    }
+
+    return RZAssertClassCacheCheck(cache, object, testClass);
+}
+
+#pragma mark - Protocol Conformance
+
+/**
+ *  Checks whether an object conforms to a protocol, consulting a process-wide cache of (class, protocol) pairs that passed. Equivalent to [object conformsToProtocol:protocol]. The cache is a fixed-size, lock-free hash table; pairs that don't fit are checked uncached. For private use only.
+ */
+FOUNDATION_EXPORT BOOL RZAssertConformsToProtocolCached(id object, Protocol *protocol);
+
+#pragma mark - Invalidation
+
+/**
+ *  Clears every call site's class cache, and the protocol conformance cache.
+ *
+ *  The caches only record checks that passed, and those stay true as the runtime changes: a class's ancestry never changes once it is registered, and class_addProtocol() can add conformance but never remove it. Failed checks are never cached, so a protocol added at runtime is seen by the very next check. Classes and protocols loaded or registered at runtime, including KVO's subclasses, need nothing: they have new addresses, and miss until they pass.
+ *
+ *  The one exception is objc_disposeClassPair(), after which a new class may be allocated at the old class's address and inherit its entries. Call this after disposing of a class that may have reached an RZASSERT_KINDOF or RZASSERT_CONFORMS_PROTOCOL check. The old conformance table is leaked, since other threads may still be reading it, so call it rarely.
+ */
+FOUNDATION_EXPORT void RZAssertInvalidateClassCaches(void);
@@ -0,0 +1,301 @@
+//
+//  RZAssertClassChecks.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertClassChecks.h"
+
+#import <objc/runtime.h>
+
+// Collections are nearly always homogeneous, or hold a handful of concrete classes from
+// one class cluster, so remembering the last few classes that passed turns the check for
+// almost every element into a pointer compare.
+#define RZASSERT_PASSED_CLASS_COUNT 4
+
+// Sized so that dictionaries of ordinary size are copied out without allocating.
+#define RZASSERT_DICTIONARY_STACK_COUNT 64
+
+typedef struct {
+    Class classes[RZASSERT_PASSED_CLASS_COUNT];
+    NSUInteger next;
+} RZAssertPassedClasses;
+
+// Instances of a class normally all answer -isKindOfClass: and -conformsToProtocol: the same
+// way, but proxies forward them to their targets, and other overrides may do anything, so
+// only classes that use NSObject's implementation are remembered.
+static BOOL RZAssertClassUsesNSObjectImplementation(Class objectClass, SEL selector, IMP *NSObjectImplementation)
+{
+    IMP implementation = __atomic_load_n(NSObjectImplementation, __ATOMIC_RELAXED);
+    if ( implementation == NULL ) {
+        implementation = class_getMethodImplementation([NSObject class], selector);
+        __atomic_store_n(NSObjectImplementation, implementation, __ATOMIC_RELAXED);
+    }
+
+    return class_getMethodImplementation(objectClass, selector) == implementation;
+}
+
+static BOOL RZAssertClassIsCacheable(Class objectClass)
+{
+    static IMP s_isKindOfClass = NULL;
+    return RZAssertClassUsesNSObjectImplementation(objectClass, @selector(isKindOfClass:), &s_isKindOfClass);
+}
+
+NS_INLINE BOOL RZAssertObjectIsKindOfClass(RZAssertPassedClasses *passed, id object, Class testClass)
+{
+    // Unused entries are Nil, so a nil object must not reach the loop.
+    Class objectClass = object_getClass(object);
+    if ( objectClass == Nil ) {
+        return NO;
+    }
+
+    for ( NSUInteger i = 0; i < RZASSERT_PASSED_CLASS_COUNT; i++ ) {
+        if ( passed->classes[i] == objectClass ) {
+            return YES;
+        }
+    }
+
+    if ( ![object isKindOfClass:testClass] ) {
+        return NO;
+    }
+
+    if ( !RZAssertClassIsCacheable(objectClass) ) {
+        return YES;
+    }
+
+    passed->classes[passed->next] = objectClass;
+    passed->next = (passed->next + 1) % RZASSERT_PASSED_CLASS_COUNT;
+
+    return YES;
+}
+
+#pragma mark - Collections
+
+BOOL RZAssertAllKindOfClass(id<NSFastEnumeration> collection, Class testClass, NSUInteger *failingIndex, __autoreleasing id *failingObject)
+{
+    RZAssertPassedClasses passed = { { Nil }, 0 };
+    NSUInteger index = 0;
+
+    for ( id object in collection ) {
+        if ( !RZAssertObjectIsKindOfClass(&passed, object, testClass) ) {
+            *failingIndex = index;
+            *failingObject = object;
+            return NO;
+        }
+        index++;
+    }
+
+    return YES;
+}
+
+BOOL RZAssertAllKeysAndValuesKindOfClasses(NSDictionary *dictionary, Class keyClass, Class valueClass, __autoreleasing id *failingKey, __autoreleasing id *failingObject)
+{
+    RZAssertPassedClasses passedKeys = { { Nil }, 0 };
+    RZAssertPassedClasses passedValues = { { Nil }, 0 };
+
+    NSUInteger count = dictionary.count;
+    if ( count == 0 ) {
+        return YES;
+    }
+
+    // Copying the entries out visits each one with a single call, where fast enumeration
+    // of the keys would need a hash lookup per key to find its value. The dictionary
+    // holds the entries, so the buffers don't retain them.
+    __unsafe_unretained id stackKeys[RZASSERT_DICTIONARY_STACK_COUNT];
+    __unsafe_unretained id stackValues[RZASSERT_DICTIONARY_STACK_COUNT];
+    __unsafe_unretained id *keys = stackKeys;
+    __unsafe_unretained id *values = stackValues;
+
+    if ( count > RZASSERT_DICTIONARY_STACK_COUNT ) {
+        keys = (__unsafe_unretained id *)malloc(count * sizeof(id));
+        values = (__unsafe_unretained id *)malloc(count * sizeof(id));
+    }
+
+    [dictionary getObjects:values andKeys:keys count:count];
+
+    BOOL passed = YES;
+    for ( NSUInteger i = 0; i < count; i++ ) {
+        if ( !RZAssertObjectIsKindOfClass(&passedKeys, keys[i], keyClass) ) {
+            *failingKey = keys[i];
+            *failingObject = keys[i];
+            passed = NO;
+            break;
+        }
+        if ( !RZAssertObjectIsKindOfClass(&passedValues, values[i], valueClass) ) {
+            *failingKey = keys[i];
+            *failingObject = values[i];
+            passed = NO;
+            break;
+        }
+    }
+
+    if ( keys != stackKeys ) {
+        free(keys);
+        free(values);
+    }
+
+    return passed;
+}
+
+#pragma mark - Call Site Caches
+
+uint32_t RZAssertClassCacheEpoch = 1;
+
+BOOL RZAssertClassCacheCheck(RZAssertClassCache *cache, id object, Class testClass)
+{
+    if ( ![object isKindOfClass:testClass] ) {
+        return NO;
+    }
+
+    Class objectClass = object_getClass(object);
+    if ( !RZAssertClassIsCacheable(objectClass) ) {
+        return YES;
+    }
+
+    // Claim the cache for this class, unless another class already has it.
+    uintptr_t cachedTestClass = 0;
+    if ( !__atomic_compare_exchange_n(&cache->testClass, &cachedTestClass, (uintptr_t)testClass, NO, __ATOMIC_RELAXED, __ATOMIC_RELAXED) &&
+         cachedTestClass != (uintptr_t)testClass ) {
+        return YES;
+    }
+
+    // Entries from an earlier epoch may name disposed classes, so they are cleared before the
+    // epoch is published. Anything written concurrently names the class of a live object,
+    // which is always safe to keep.
+    uint32_t epoch = __atomic_load_n(&RZAssertClassCacheEpoch, __ATOMIC_RELAXED);
+    if ( __atomic_load_n(&cache->epoch, __ATOMIC_RELAXED) != epoch ) {
+        for ( NSUInteger i = 0; i < RZASSERT_CLASS_CACHE_SIZE; i++ ) {
+            __atomic_store_n(&cache->classes[i], 0, __ATOMIC_RELAXED);
+        }
+        __atomic_store_n(&cache->epoch, epoch, __ATOMIC_RELEASE);
+    }
+
+    // Fill an empty entry if there is one, otherwise replace one picked by the class's address.
+    // Losing a race just means one more miss later.
+    NSUInteger slot = ((uintptr_t)objectClass >> 4) % RZASSERT_CLASS_CACHE_SIZE;
+    for ( NSUInteger i = 0; i < RZASSERT_CLASS_CACHE_SIZE; i++ ) {
+        if ( __atomic_load_n(&cache->classes[i], __ATOMIC_RELAXED) == 0 ) {
+            slot = i;
+            break;
+        }
+    }
+    __atomic_store_n(&cache->classes[slot], (uintptr_t)objectClass, __ATOMIC_RELAXED);
+
+    return YES;
+}
+
+#pragma mark - Protocol Conformance
+
+// Open addressing with linear probing. An entry's class is claimed with a CAS and its protocol
+// stored after, and neither ever changes again, so a reader that matches both has a complete
+// entry. Invalidation replaces the whole table rather than clearing entries in place.
+#define RZASSERT_CONFORMANCE_CACHE_SIZE     1024
+#define RZASSERT_CONFORMANCE_CACHE_PROBES   8
+
+typedef struct {
+    uintptr_t objectClass;
+    uintptr_t protocol;
+} RZAssertConformanceEntry;
+
+static RZAssertConformanceEntry s_initialConformanceEntries[RZASSERT_CONFORMANCE_CACHE_SIZE];
+static RZAssertConformanceEntry *s_conformanceEntries = s_initialConformanceEntries;
+
+NS_INLINE NSUInteger RZAssertConformanceHash(uintptr_t objectClass, uintptr_t protocol)
+{
+    uint64_t hash = ((uint64_t)objectClass ^ ((uint64_t)protocol * 0x9e3779b97f4a7c15ull)) * 0xbf58476d1ce4e5b9ull;
+    return (NSUInteger)(hash >> 32);
+}
+
+static BOOL RZAssertClassIsCacheableForConformance(Class objectClass)
+{
+    static IMP s_conformsToProtocol = NULL;
+    return RZAssertClassUsesNSObjectImplementation(objectClass, @selector(conformsToProtocol:), &s_conformsToProtocol);
+}
+
+BOOL RZAssertConformsToProtocolCached(id object, Protocol *protocol)
+{
+    Class objectClass = object_getClass(object);
+    if ( objectClass == Nil || protocol == nil ) {
+        return NO;
+    }
+
+    uintptr_t classKey = (uintptr_t)objectClass;
+    uintptr_t protocolKey = (uintptr_t)protocol;
+    NSUInteger hash = RZAssertConformanceHash(classKey, protocolKey);
+
+    RZAssertConformanceEntry *entries = __atomic_load_n(&s_conformanceEntries, __ATOMIC_ACQUIRE);
+    for ( NSUInteger i = 0; i < RZASSERT_CONFORMANCE_CACHE_PROBES; i++ ) {
+        RZAssertConformanceEntry *entry = &entries[(hash + i) % RZASSERT_CONFORMANCE_CACHE_SIZE];
+        uintptr_t entryClass = __atomic_load_n(&entry->objectClass, __ATOMIC_ACQUIRE);
+        if ( entryClass == 0 ) {
+            break;
+        }
+        if ( entryClass == classKey && __atomic_load_n(&entry->protocol, __ATOMIC_ACQUIRE) == protocolKey ) {
+            return YES;
+        }
+    }
+
+    if ( ![object conformsToProtocol:protocol] ) {
+        return NO;
+    }
+
+    if ( !RZAssertClassIsCacheableForConformance(objectClass) ) {
+        return YES;
+    }
+
+    // Claim the first free entry along the probe sequence. If the sequence is full, the result
+    // just isn't cached. Racing inserts of the same pair may both succeed, which is harmless.
+    for ( NSUInteger i = 0; i < RZASSERT_CONFORMANCE_CACHE_PROBES; i++ ) {
+        RZAssertConformanceEntry *entry = &entries[(hash + i) % RZASSERT_CONFORMANCE_CACHE_SIZE];
+        uintptr_t entryClass = 0;
+        if ( __atomic_compare_exchange_n(&entry->objectClass, &entryClass, classKey, NO, __ATOMIC_RELAXED, __ATOMIC_ACQUIRE) ) {
+            __atomic_store_n(&entry->protocol, protocolKey, __ATOMIC_RELEASE);
+            break;
+        }
+        if ( entryClass == classKey && __atomic_load_n(&entry->protocol, __ATOMIC_ACQUIRE) == protocolKey ) {
+            break;
+        }
+    }
+
+    return YES;
+}
+
+#pragma mark - Invalidation
+
+void RZAssertInvalidateClassCaches(void)
+{
+    // Readers may still be probing the old table, so it is never freed. Invalidation is meant
+    // to follow the rare objc_disposeClassPair() call, so the leak is bounded in practice.
+    RZAssertConformanceEntry *entries = calloc(RZASSERT_CONFORMANCE_CACHE_SIZE, sizeof(RZAssertConformanceEntry));
+    if ( entries != NULL ) {
+        __atomic_store_n(&s_conformanceEntries, entries, __ATOMIC_RELEASE);
+    }
+
+    uint32_t epoch = __atomic_add_fetch(&RZAssertClassCacheEpoch, 1, __ATOMIC_RELEASE);
+
+    // Zero is never a valid epoch, since new caches start there.
+    if ( epoch == 0 ) {
+        __atomic_compare_exchange_n(&RZAssertClassCacheEpoch, &epoch, 1, NO, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    }
+}
@@ -0,0 +1,53 @@
+//
+//  RZAssertCrashLog.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertFailure.h"
+
+/**
+ *  Appends failures as compact binary records to a fixed-size, memory-mapped circular file. Appending is a copy into shared memory with no system calls, and the records survive the process crashing, because the kernel owns the mapped pages. Decode the file with the rzassert-decode-crash-log tool. For private use only; see +[RZAssert enableCrashLogAtPath:size:error:].
+ */
+@interface RZAssertCrashLog : NSObject
+
+/**
+ *  Maps the file, creating or resizing it as needed. Records already in a file of the same size are kept.
+ *
+ *  @param path  The path of the file.
+ *  @param size  The size of the file, in bytes.
+ *  @param error On failure, describes what went wrong.
+ *
+ *  @return The crash log, or nil if the file could not be mapped.
+ */
+- (instancetype)initWithPath:(NSString *)path size:(NSUInteger)size error:(NSError **)error;
+
+/**
+ *  Appends a record for a failure. Safe to call from any thread.
+ *
+ *  @param failure The failure to record.
+ */
+- (void)appendFailure:(RZAssertFailure *)failure;
+
+@end
@@ -0,0 +1,196 @@
+//
+//  RZAssertCrashLog.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertCrashLog.h"
+#import "RZAssertCrashLogFormat.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const NSUInteger kRZAssertCrashLogMinimumSize = RZASSERT_CRASH_LOG_HEADER_SIZE + 16384;
+
+// Keeps one long failure from evicting the whole log.
+static const size_t kRZAssertCrashLogMaximumStringLength = 512;
+
+static size_t RZAssertCrashLogAlign(size_t length)
+{
+    return (length + RZASSERT_CRASH_LOG_ALIGNMENT - 1) & ~(size_t)(RZASSERT_CRASH_LOG_ALIGNMENT - 1);
+}
+
+@interface RZAssertCrashLog () {
+    void *_mapping;
+    size_t _mappingSize;
+    RZAssertCrashLogHeader *_header;
+    uint8_t *_records;
+    uint64_t _capacity;
+}
+
+@end
+
+@implementation RZAssertCrashLog
+
+- (instancetype)initWithPath:(NSString *)path size:(NSUInteger)size error:(NSError **)error
+{
+    if ( !path ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: path must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    if ( size < kRZAssertCrashLogMinimumSize ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: size must be at least %lu bytes", __PRETTY_FUNCTION__, (unsigned long)kRZAssertCrashLogMinimumSize];
+    }
+
+    self = [super init];
+    if ( self ) {
+        int fileDescriptor = open([path fileSystemRepresentation], O_RDWR | O_CREAT, 0644);
+        struct stat fileStatus;
+        BOOL mapped = NO;
+
+        if ( fileDescriptor >= 0 && fstat(fileDescriptor, &fileStatus) == 0 ) {
+            if ( (NSUInteger)fileStatus.st_size == size || ftruncate(fileDescriptor, (off_t)size) == 0 ) {
+                _mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fileDescriptor, 0);
+                mapped = ( _mapping != MAP_FAILED );
+            }
+        }
+
+        if ( !mapped ) {
+            if ( error ) {
+                *error = [NSError errorWithDomain:NSPOSIXErrorDomain code:errno userInfo:@{ NSFilePathErrorKey: path }];
+            }
+            if ( fileDescriptor >= 0 ) {
+                close(fileDescriptor);
+            }
+            _mapping = NULL;
+            return nil;
+        }
+
+        // The mapping keeps the file alive.
+        close(fileDescriptor);
+
+        _mappingSize = size;
+        _header = (RZAssertCrashLogHeader *)_mapping;
+        _records = (uint8_t *)_mapping + RZASSERT_CRASH_LOG_HEADER_SIZE;
+        _capacity = (size - RZASSERT_CRASH_LOG_HEADER_SIZE) & ~(uint64_t)(RZASSERT_CRASH_LOG_ALIGNMENT - 1);
+
+        BOOL headerValid = ( _header->magic == RZASSERT_CRASH_LOG_MAGIC && _header->version == RZASSERT_CRASH_LOG_VERSION && _header->capacity == _capacity );
+
+        if ( !headerValid ) {
+            memset(_mapping, 0, size);
+            _header->version = RZASSERT_CRASH_LOG_VERSION;
+            _header->capacity = _capacity;
+            _header->writeOffset = 0;
+            __atomic_store_n(&_header->magic, RZASSERT_CRASH_LOG_MAGIC, __ATOMIC_RELEASE);
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    if ( _mapping ) {
+        munmap(_mapping, _mappingSize);
+    }
+}
+
+#pragma mark - Public
+
+- (void)appendFailure:(RZAssertFailure *)failure
+{
+    const RZAssertSite *site = failure.site;
+    const char *kind = site ? site->kind : "";
+    const char *file = site ? site->file : "";
+    const char *function = site ? site->function : "";
+
+    size_t kindLength = MIN(strlen(kind), kRZAssertCrashLogMaximumStringLength);
+    size_t fileLength = MIN(strlen(file), kRZAssertCrashLogMaximumStringLength);
+    size_t functionLength = MIN(strlen(function), kRZAssertCrashLogMaximumStringLength);
+
+    NSString *detail = failure.formattedDetail;
+    size_t maximumDetailLength = MIN([detail lengthOfBytesUsingEncoding:NSUTF8StringEncoding], (NSUInteger)(_capacity / 4));
+
+    size_t length = RZAssertCrashLogAlign(sizeof(RZAssertCrashLogRecord) + kindLength + fileLength + functionLength + maximumDetailLength);
+    uint64_t sequence = 0;
+    uint8_t *bytes = [self reserveRecordOfLength:(uint32_t)length sequence:&sequence];
+    RZAssertCrashLogRecord *record = (RZAssertCrashLogRecord *)bytes;
+
+    // Invalidate whatever record used to start here before writing over it.
+    __atomic_store_n(&record->magic, 0, __ATOMIC_RELAXED);
+    record->length = (uint32_t)length;
+    record->sequence = sequence;
+    record->timestamp = failure.timestamp;
+    record->threadID = failure.threadID;
+    record->line = site ? (uint32_t)site->line : 0;
+    record->kindLength = (uint16_t)kindLength;
+    record->fileLength = (uint16_t)fileLength;
+    record->functionLength = (uint16_t)functionLength;
+    record->reserved = 0;
+
+    uint8_t *strings = bytes + sizeof(RZAssertCrashLogRecord);
+    memcpy(strings, kind, kindLength);
+    strings += kindLength;
+    memcpy(strings, file, fileLength);
+    strings += fileLength;
+    memcpy(strings, function, functionLength);
+    strings += functionLength;
+
+    // Encode straight into the mapping, stopping on a character boundary if the detail was truncated.
+    NSUInteger detailLength = 0;
+    [detail getBytes:strings maxLength:maximumDetailLength usedLength:&detailLength encoding:NSUTF8StringEncoding options:0 range:NSMakeRange(0, detail.length) remainingRange:NULL];
+    record->detailLength = (uint32_t)detailLength;
+
+    __atomic_store_n(&record->magic, RZASSERT_CRASH_LOG_RECORD_MAGIC, __ATOMIC_RELEASE);
+}
+
+#pragma mark - Private
+
+- (uint8_t *)reserveRecordOfLength:(uint32_t)length sequence:(uint64_t *)sequence
+{
+    for ( ;; ) {
+        uint64_t offset = __atomic_fetch_add(&_header->writeOffset, length, __ATOMIC_RELAXED);
+        uint64_t position = offset % _capacity;
+
+        if ( position + length <= _capacity ) {
+            *sequence = offset;
+            return _records + position;
+        }
+
+        // The reservation straddles the end of the record area. Pad out both pieces and try again.
+        [self writePaddingAtPosition:position length:(uint32_t)(_capacity - position)];
+        [self writePaddingAtPosition:0 length:(uint32_t)(position + length - _capacity)];
+    }
+}
+
+- (void)writePaddingAtPosition:(uint64_t)position length:(uint32_t)length
+{
+    RZAssertCrashLogRecord *padding = (RZAssertCrashLogRecord *)(_records + position);
+    padding->length = length;
+    __atomic_store_n(&padding->magic, RZASSERT_CRASH_LOG_PADDING_MAGIC, __ATOMIC_RELEASE);
+}
+
+@end
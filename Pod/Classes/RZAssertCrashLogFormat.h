@@ -0,0 +1,87 @@
+//
+//  RZAssertCrashLogFormat.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// The on-disk layout of the file written by +[RZAssert enableCrashLogAtPath:size:error:].
+// Plain C, so the offline decoder in Tools/ can share it.
+
+#ifndef RZAssertCrashLogFormat_h
+#define RZAssertCrashLogFormat_h
+
+#include <stdint.h>
+
+#define RZASSERT_CRASH_LOG_MAGIC            0x475a4c52u     // "RLZG"
+#define RZASSERT_CRASH_LOG_VERSION          1u
+#define RZASSERT_CRASH_LOG_RECORD_MAGIC     0x43455252u     // "RREC"
+#define RZASSERT_CRASH_LOG_PADDING_MAGIC    0x44415052u     // "RPAD"
+#define RZASSERT_CRASH_LOG_HEADER_SIZE      64u
+#define RZASSERT_CRASH_LOG_ALIGNMENT        8u
+
+/**
+ *  The first RZASSERT_CRASH_LOG_HEADER_SIZE bytes of the file. The record area follows it.
+ */
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    /**
+     *  The size of the record area, in bytes. A multiple of RZASSERT_CRASH_LOG_ALIGNMENT.
+     */
+    uint64_t capacity;
+    /**
+     *  The total number of bytes ever reserved. A record reserved at offset @c o is stored at @c o % @c capacity.
+     */
+    uint64_t writeOffset;
+} RZAssertCrashLogHeader;
+
+/**
+ *  A record in the record area, followed by the kind, file, function and detail strings, in that order, without terminators. Records never wrap around the end of the record area; the unused tail is filled with a padding record instead. Padding records only have a valid @c magic and @c length.
+ *
+ *  @c magic is written last, so a record whose @c magic is RZASSERT_CRASH_LOG_RECORD_MAGIC was completely written, as long as its @c sequence shows it has not since been overwritten.
+ */
+typedef struct {
+    uint32_t magic;
+    /**
+     *  The length of the whole record, including strings and alignment padding.
+     */
+    uint32_t length;
+    /**
+     *  The offset the record was reserved at. Always @c sequence % @c capacity == the record’s position.
+     */
+    uint64_t sequence;
+    /**
+     *  Seconds since 00:00:00 UTC on 1 January 2001.
+     */
+    double timestamp;
+    uint64_t threadID;
+    uint32_t line;
+    uint16_t kindLength;
+    uint16_t fileLength;
+    uint16_t functionLength;
+    uint16_t reserved;
+    uint32_t detailLength;
+} RZAssertCrashLogRecord;
+
+#endif
@@ -0,0 +1,218 @@
+//
+//  RZAssertFailure.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+#pragma mark - Call Sites
+
+/**
+ *  Describes a single assertion macro expansion, and holds its mutable state. Each expansion owns one in static storage, so its address identifies the call site for the life of the process.
+ *
+ *  Sites declared with @c RZASSERT_DECLARE_SITE are also registered in a dedicated linker section, so they can be listed with +[RZAssert enumerateCallSitesUsingBlock:] at runtime, or with the rzassert-list-sites tool offline.
+ */
+typedef struct {
+    /**
+     *  The name of the macro that was expanded, such as "RZASSERT_NOT_NIL".
+     */
+    const char *kind;
+    /**
+     *  The tested expression, as written.
+     */
+    const char *expression;
+    const char *file;
+    int line;
+    const char *function;
+
+    // Rate limiting. The window's start and the failures counted in it share one word,
+    // so a new window and its count are published together. For private use only.
+    uint64_t window;
+    uint64_t suppressedCount;
+
+    // Statistics. 0 until the site is first counted. For private use only.
+    uint32_t statisticsIndex;
+} RZAssertSite;
+
+/**
+ *  Initializes a site that is not registered in the call-site section.
+ */
+#define RZASSERT_SITE_INITIALIZER(kind) { (kind), "", __FILE__, __LINE__, __PRETTY_FUNCTION__, 0, 0, 0 }
+
+#if defined(__APPLE__)
+    #define RZASSERT_SITE_SECTION       __attribute__((used, section("__DATA,__rzassert_sites")))
+    #define RZASSERT_SITE_INFO_SECTION  __attribute__((used, section("__TEXT,__rzassert_info")))
+#else
+    #define RZASSERT_SITE_SECTION       __attribute__((used, section("rzassert_sites")))
+    #define RZASSERT_SITE_INFO_SECTION  __attribute__((used, section("rzassert_info")))
+#endif
+
+#define RZASSERT_STRINGIFY_(x) #x
+#define RZASSERT_STRINGIFY(x) RZASSERT_STRINGIFY_(x)
+
+/**
+ *  Declares a registered call site named @c name, for use inside a function. Used by the assertion macros.
+ *
+ *  The kind, expression, file and line are stored once, as a run of NUL-terminated strings in the info section, where the offline tool can read them without resolving any pointers. The site points into that run, and a pointer to the site goes in the sites section for runtime enumeration.
+ *
+ *  @param name               The name of the static variable to declare.
+ *  @param kindString         A string literal naming the macro.
+ *  @param expressionString   A string literal of the tested expression.
+ */
+#define RZASSERT_DECLARE_SITE(name, kindString, expressionString) \
+    static const char name##_info[] RZASSERT_SITE_INFO_SECTION = kindString "\0" expressionString "\0" __FILE__ "\0" RZASSERT_STRINGIFY(__LINE__); \
+    static RZAssertSite name = { name##_info, name##_info + sizeof(kindString), name##_info + sizeof(kindString) + sizeof(expressionString), __LINE__, __PRETTY_FUNCTION__, 0, 0, 0 }; \
+    static RZAssertSite *name##_entry RZASSERT_SITE_SECTION = &name;
+
+#pragma mark - Failures
+
+/**
+ *  A single assertion failure, as delivered to a handler configured with +[RZAssert configureWithFailureHandler:].
+ *
+ *  Creating a failure only captures the call site, the time, the thread, the format string and its arguments. The message is built the first time something asks for it, so handlers that only need the call site never pay for formatting.
+ *
+ *  Arguments passed for @c %@ are retained, and described when the message is built, which may be after the failing code has moved on. C strings passed for @c %s are copied.
+ */
+@class RZAssertBacktrace;
+
+@interface RZAssertFailure : NSObject
+
+/**
+ *  Creates a failure from an already-formatted message, with no call site.
+ *
+ *  @param message The message.
+ */
+- (instancetype)initWithMessage:(NSString *)message;
+
+/**
+ *  Recreates a failure from its parts, such as one read back by RZAssertWireDecoder. Each argument is converted back to the type its specifier in @c format expects, so the detail is formatted as it was originally.
+ *
+ *  @param site      The call site, or @c NULL.
+ *  @param timestamp When the failure happened, as seconds since the reference date.
+ *  @param threadID  The system identifier of the thread that failed.
+ *  @param format    The format string, or the already-formatted detail if @c arguments is nil.
+ *  @param arguments The arguments for @c format, boxed as in @c arguments, or nil.
+ */
+- (instancetype)initWithSite:(const RZAssertSite *)site timestamp:(NSTimeInterval)timestamp threadID:(uint64_t)threadID format:(NSString *)format arguments:(NSArray *)arguments;
+
+/**
+ *  The call site that failed, or @c NULL if the failure was created from an already-formatted message.
+ */
+@property (assign, nonatomic, readonly) const RZAssertSite *site;
+
+/**
+ *  When the failure happened, as seconds since the reference date.
+ */
+@property (assign, nonatomic, readonly) NSTimeInterval timestamp;
+
+/**
+ *  The system identifier of the thread that failed.
+ */
+@property (assign, nonatomic, readonly) uint64_t threadID;
+
+/**
+ *  The return addresses of the failing call, or nil unless backtraces were enabled with +[RZAssert enableBacktraces]. Failures from the same stack share one backtrace.
+ */
+@property (strong, nonatomic, readonly) RZAssertBacktrace *backtrace;
+
+/**
+ *  The printf-style format string passed to the assertion macro.
+ */
+@property (copy, nonatomic, readonly) NSString *format;
+
+/**
+ *  The arguments captured for @c format, boxed in order. Numbers are NSNumbers, pointers are NSValues, C strings are NSStrings, and nil values are NSNull. Built on first access.
+ */
+@property (copy, nonatomic, readonly) NSArray *arguments;
+
+/**
+ *  @c format, formatted with @c arguments. Built on first access.
+ */
+@property (copy, nonatomic, readonly) NSString *formattedDetail;
+
+/**
+ *  The full message, as passed to a logging handler configured with +[RZAssert configureWithLoggingHandler:]. Built on first access.
+ */
+@property (copy, nonatomic, readonly) NSString *message;
+
+@end
+
+#pragma mark - Message Buffers
+
+/**
+ *  The size of each thread's message buffer, including the terminating NUL. Longer messages are truncated at a character boundary.
+ */
+#define RZASSERT_MESSAGE_BUFFER_SIZE 1024
+
+/**
+ *  A failure message formatted into the failing thread's message buffer, as delivered to a handler configured with +[RZAssert configureWithBufferedLoggingHandler:].
+ *
+ *  Formatting the message allocates nothing. Strings passed for @c %@ are copied in as UTF-8, and other objects are written as their class name and address, because calling @c -description could allocate. Strings an assertion macro builds for its arguments, such as the message of a @c _WITH_MESSAGE variant, are allocated before formatting starts.
+ *
+ *  Each thread's buffer is allocated the first time the thread fails, then reused by its next failure, so it is only valid until the handler returns. Copy it, or call @c RZAssertMessageBufferString(), to keep it.
+ */
+typedef struct {
+    /**
+     *  The call site that failed, or @c NULL for messages logged without one.
+     */
+    const RZAssertSite *site;
+    /**
+     *  The NUL-terminated message, as UTF-8.
+     */
+    const char *UTF8String;
+    /**
+     *  The length of @c UTF8String in bytes, not counting the terminating NUL.
+     */
+    size_t length;
+    /**
+     *  Whether the message was cut short to fit in the buffer.
+     */
+    BOOL truncated;
+} RZAssertMessageBuffer;
+
+/**
+ *  Creates a string from a message buffer. This is the only part of buffered logging that allocates.
+ *
+ *  @param buffer The buffer passed to the handler.
+ *
+ *  @return A new string with the buffer's message.
+ */
+FOUNDATION_EXPORT NSString *RZAssertMessageBufferString(const RZAssertMessageBuffer *buffer);
+
+#pragma mark - Reporting
+
+/**
+ *  Captures a failure at a call site and hands it to RZAssert for delivery. Used by the assertion macros. For private use only.
+ *
+ *  The message is formatted into the thread's message buffer if a buffered logging handler is configured, and an RZAssertFailure is only created if some other handler needs one.
+ *
+ *  @param site   The call site that failed.
+ *  @param format A printf-style format string describing the failure.
+ */
+FOUNDATION_EXPORT void RZAssertReportFailure(RZAssertSite *site, NSString *format, ...) NS_FORMAT_FUNCTION(2, 3);
@@ -0,0 +1,925 @@
+//
+//  RZAssertFailure.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertFailure.h"
+#import "RZAssert.h"
+#import "RZAssertBacktrace.h"
+#import "RZAssertSinkRegistry.h"
+
+#include <objc/runtime.h>
+#include <pthread.h>
+#include <stddef.h>
+
+#if !defined(__APPLE__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Formats with more arguments than this are formatted eagerly instead.
+#define RZASSERT_MAXIMUM_CAPTURED_ARGUMENTS 16
+
+#pragma mark - Format Parsing
+
+typedef NS_ENUM(uint8_t, RZAssertArgumentType) {
+    RZAssertArgumentTypeSigned,
+    RZAssertArgumentTypeUnsigned,
+    RZAssertArgumentTypeDouble,
+    RZAssertArgumentTypeLongDouble,
+    RZAssertArgumentTypePointer,
+    RZAssertArgumentTypeCString,
+    RZAssertArgumentTypeObject,
+};
+
+typedef struct {
+    RZAssertArgumentType type;
+    union {
+        long long signedValue;
+        unsigned long long unsignedValue;
+        double doubleValue;
+        long double longDoubleValue;
+        const void *pointerValue;
+        char *cStringValue;
+        void *objectValue;
+    };
+} RZAssertArgument;
+
+typedef struct {
+    size_t start;
+    size_t lengthStart;
+    size_t lengthEnd;
+    size_t end;
+    char conversion;
+    int starCount;
+} RZAssertSpecifier;
+
+// Finds the next conversion specifier at or after *cursor, and moves *cursor past it.
+// Literal text sits between the old *cursor and specifier->start.
+static BOOL RZAssertNextSpecifier(const char *format, size_t *cursor, RZAssertSpecifier *specifier)
+{
+    const char *percent = strchr(format + *cursor, '%');
+    if ( !percent ) {
+        return NO;
+    }
+
+    size_t index = (size_t)(percent - format);
+    specifier->start = index++;
+    specifier->starCount = 0;
+
+    while ( format[index] != '\0' && strchr("-+ #0'", format[index]) ) {
+        index++;
+    }
+
+    if ( format[index] == '*' ) {
+        specifier->starCount++;
+        index++;
+    }
+    while ( format[index] >= '0' && format[index] <= '9' ) {
+        index++;
+    }
+
+    if ( format[index] == '.' ) {
+        index++;
+        if ( format[index] == '*' ) {
+            specifier->starCount++;
+            index++;
+        }
+        while ( format[index] >= '0' && format[index] <= '9' ) {
+            index++;
+        }
+    }
+
+    specifier->lengthStart = index;
+    while ( format[index] != '\0' && strchr("hlqLjzt", format[index]) ) {
+        index++;
+    }
+    specifier->lengthEnd = index;
+
+    specifier->conversion = format[index];
+    specifier->end = ( format[index] == '\0' ) ? index : index + 1;
+    *cursor = specifier->end;
+
+    return YES;
+}
+
+static BOOL RZAssertSpecifierHasLength(const char *format, const RZAssertSpecifier *specifier, const char *length)
+{
+    size_t lengthLength = specifier->lengthEnd - specifier->lengthStart;
+    return ( strlen(length) == lengthLength && strncmp(format + specifier->lengthStart, length, lengthLength) == 0 );
+}
+
+// Reads one argument for a specifier off the va_list. Returns NO for specifiers that can't be captured.
+// C strings are copied and objects retained only if copyValues is YES; otherwise they are borrowed from the caller.
+static BOOL RZAssertCaptureArgument(const char *format, const RZAssertSpecifier *specifier, va_list *arguments, BOOL copyValues, RZAssertArgument *argument)
+{
+    BOOL hasLength = ( specifier->lengthEnd > specifier->lengthStart );
+
+    switch ( specifier->conversion ) {
+        case 'd':
+        case 'i': {
+            argument->type = RZAssertArgumentTypeSigned;
+            if ( !hasLength )                                                          argument->signedValue = va_arg(*arguments, int);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "hh") )            argument->signedValue = (signed char)va_arg(*arguments, int);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "h") )             argument->signedValue = (short)va_arg(*arguments, int);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "l") )             argument->signedValue = va_arg(*arguments, long);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "ll") ||
+                      RZAssertSpecifierHasLength(format, specifier, "q") )             argument->signedValue = va_arg(*arguments, long long);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "j") )             argument->signedValue = va_arg(*arguments, intmax_t);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "z") )             argument->signedValue = (long long)va_arg(*arguments, size_t);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "t") )             argument->signedValue = va_arg(*arguments, ptrdiff_t);
+            else                                                                       return NO;
+            return YES;
+        }
+        case 'o':
+        case 'u':
+        case 'x':
+        case 'X': {
+            argument->type = RZAssertArgumentTypeUnsigned;
+            if ( !hasLength )                                                          argument->unsignedValue = va_arg(*arguments, unsigned int);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "hh") )            argument->unsignedValue = (unsigned char)va_arg(*arguments, unsigned int);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "h") )             argument->unsignedValue = (unsigned short)va_arg(*arguments, unsigned int);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "l") )             argument->unsignedValue = va_arg(*arguments, unsigned long);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "ll") ||
+                      RZAssertSpecifierHasLength(format, specifier, "q") )             argument->unsignedValue = va_arg(*arguments, unsigned long long);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "j") )             argument->unsignedValue = va_arg(*arguments, uintmax_t);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "z") )             argument->unsignedValue = va_arg(*arguments, size_t);
+            else if ( RZAssertSpecifierHasLength(format, specifier, "t") )             argument->unsignedValue = (unsigned long long)va_arg(*arguments, ptrdiff_t);
+            else                                                                       return NO;
+            return YES;
+        }
+        case 'c':
+        case 'C': {
+            if ( hasLength ) {
+                return NO;
+            }
+            argument->type = RZAssertArgumentTypeSigned;
+            argument->signedValue = va_arg(*arguments, int);
+            return YES;
+        }
+        case 'e':
+        case 'E':
+        case 'f':
+        case 'F':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': {
+            if ( RZAssertSpecifierHasLength(format, specifier, "L") ) {
+                argument->type = RZAssertArgumentTypeLongDouble;
+                argument->longDoubleValue = va_arg(*arguments, long double);
+            }
+            else {
+                argument->type = RZAssertArgumentTypeDouble;
+                argument->doubleValue = va_arg(*arguments, double);
+            }
+            return YES;
+        }
+        case 'p': {
+            argument->type = RZAssertArgumentTypePointer;
+            argument->pointerValue = va_arg(*arguments, void *);
+            return YES;
+        }
+        case 's': {
+            if ( hasLength ) {
+                return NO;
+            }
+            const char *cString = va_arg(*arguments, const char *);
+            argument->type = RZAssertArgumentTypeCString;
+            argument->cStringValue = ( cString && copyValues ) ? strdup(cString) : (char *)cString;
+            return YES;
+        }
+        case '@': {
+            argument->type = RZAssertArgumentTypeObject;
+            id object = va_arg(*arguments, id);
+            argument->objectValue = copyValues ? (void *)CFBridgingRetain(object) : (__bridge void *)object;
+            return YES;
+        }
+        default: {
+            // %n, %S, wide strings, positional arguments, and anything else unusual.
+            return NO;
+        }
+    }
+}
+
+static void RZAssertReleaseArgument(RZAssertArgument *argument)
+{
+    if ( argument->type == RZAssertArgumentTypeCString ) {
+        free(argument->cStringValue);
+    }
+    else if ( argument->type == RZAssertArgumentTypeObject && argument->objectValue ) {
+        CFRelease(argument->objectValue);
+    }
+}
+
+#pragma mark - Thread
+
+static uint64_t RZAssertCurrentThreadID(void)
+{
+#if defined(__APPLE__)
+    uint64_t threadID = 0;
+    pthread_threadid_np(NULL, &threadID);
+    return threadID;
+#else
+    return (uint64_t)syscall(SYS_gettid);
+#endif
+}
+
+#pragma mark - RZAssertFailure
+
+@interface RZAssertFailure () {
+    RZAssertArgument _capturedArguments[RZASSERT_MAXIMUM_CAPTURED_ARGUMENTS];
+    NSUInteger _capturedArgumentCount;
+}
+
+@property (assign, nonatomic, readwrite) const RZAssertSite *site;
+@property (assign, nonatomic, readwrite) NSTimeInterval timestamp;
+@property (assign, nonatomic, readwrite) uint64_t threadID;
+@property (strong, nonatomic, readwrite) RZAssertBacktrace *backtrace;
+@property (copy, nonatomic, readwrite) NSString *format;
+
+// Atomic, because several sinks may ask for the same failure's message at once.
+@property (copy, atomic) NSArray *cachedArguments;
+@property (copy, atomic) NSString *cachedFormattedDetail;
+@property (copy, atomic) NSString *cachedMessage;
+
+@end
+
+@implementation RZAssertFailure
+
+- (instancetype)initWithMessage:(NSString *)message
+{
+    if ( !message ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: message must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    self = [super init];
+    if ( self ) {
+        _timestamp = [NSDate timeIntervalSinceReferenceDate];
+        _threadID = RZAssertCurrentThreadID();
+        _format = [message copy];
+        _cachedArguments = @[];
+        _cachedFormattedDetail = _format;
+        _cachedMessage = _format;
+    }
+
+    return self;
+}
+
+- (instancetype)initWithSite:(const RZAssertSite *)site format:(NSString *)format arguments:(va_list)arguments
+{
+    self = [super init];
+    if ( self ) {
+        _site = site;
+        _timestamp = [NSDate timeIntervalSinceReferenceDate];
+        _threadID = RZAssertCurrentThreadID();
+        _format = [format copy];
+
+        va_list eagerArguments;
+        va_copy(eagerArguments, arguments);
+
+        if ( ![self captureArguments:arguments] ) {
+            // Fall back to formatting now, while the arguments are still alive.
+            [self releaseCapturedArguments];
+            _cachedArguments = @[];
+            _cachedFormattedDetail = [[NSString alloc] initWithFormat:format arguments:eagerArguments];
+        }
+
+        va_end(eagerArguments);
+    }
+
+    return self;
+}
+
+- (instancetype)initWithSite:(const RZAssertSite *)site timestamp:(NSTimeInterval)timestamp threadID:(uint64_t)threadID format:(NSString *)format arguments:(NSArray *)arguments
+{
+    if ( !format ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: format must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    self = [super init];
+    if ( self ) {
+        _site = site;
+        _timestamp = timestamp;
+        _threadID = threadID;
+        _format = [format copy];
+
+        if ( !arguments || ![self restoreArguments:arguments] ) {
+            [self releaseCapturedArguments];
+            _cachedArguments = arguments ?: @[];
+            _cachedFormattedDetail = _format;
+        }
+
+        if ( !site ) {
+            _cachedMessage = self.formattedDetail;
+        }
+    }
+
+    return self;
+}
+
+- (void)dealloc
+{
+    [self releaseCapturedArguments];
+}
+
+#pragma mark - Public
+
+- (NSArray *)arguments
+{
+    NSArray *arguments = self.cachedArguments;
+
+    if ( !arguments ) {
+        NSMutableArray *boxedArguments = [NSMutableArray arrayWithCapacity:_capturedArgumentCount];
+
+        for ( NSUInteger i = 0; i < _capturedArgumentCount; i++ ) {
+            const RZAssertArgument *argument = &_capturedArguments[i];
+            id boxedArgument = nil;
+
+            switch ( argument->type ) {
+                case RZAssertArgumentTypeSigned:        boxedArgument = @(argument->signedValue); break;
+                case RZAssertArgumentTypeUnsigned:      boxedArgument = @(argument->unsignedValue); break;
+                case RZAssertArgumentTypeDouble:        boxedArgument = @(argument->doubleValue); break;
+                case RZAssertArgumentTypeLongDouble:    boxedArgument = @((double)argument->longDoubleValue); break;
+                case RZAssertArgumentTypePointer:       boxedArgument = [NSValue valueWithPointer:argument->pointerValue]; break;
+                case RZAssertArgumentTypeCString:       boxedArgument = argument->cStringValue ? @(argument->cStringValue) : nil; break;
+                case RZAssertArgumentTypeObject:        boxedArgument = (__bridge id)argument->objectValue; break;
+            }
+
+            [boxedArguments addObject:boxedArgument ?: [NSNull null]];
+        }
+
+        arguments = [boxedArguments copy];
+        self.cachedArguments = arguments;
+    }
+
+    return arguments;
+}
+
+- (NSString *)formattedDetail
+{
+    NSString *formattedDetail = self.cachedFormattedDetail;
+
+    if ( !formattedDetail ) {
+        formattedDetail = [self buildFormattedDetail];
+        self.cachedFormattedDetail = formattedDetail;
+    }
+
+    return formattedDetail;
+}
+
+- (NSString *)message
+{
+    NSString *message = self.cachedMessage;
+
+    if ( !message ) {
+        message = [NSString stringWithFormat:@"**** Assertion failure in %s, %s:%d\n%@", self.site->function, self.site->file, self.site->line, self.formattedDetail];
+        self.cachedMessage = message;
+    }
+
+    return message;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p> %@", NSStringFromClass([self class]), self, self.message];
+}
+
+#pragma mark - Private
+
+- (BOOL)captureArguments:(va_list)arguments
+{
+    const char *format = [self.format UTF8String];
+    size_t cursor = 0;
+    RZAssertSpecifier specifier;
+    BOOL captured = YES;
+
+    // A va_list parameter may have decayed to a pointer, so take the address of a local copy instead.
+    va_list remainingArguments;
+    va_copy(remainingArguments, arguments);
+
+    while ( captured && RZAssertNextSpecifier(format, &cursor, &specifier) ) {
+        if ( specifier.conversion == '%' ) {
+            continue;
+        }
+
+        if ( _capturedArgumentCount + (NSUInteger)specifier.starCount + 1 > RZASSERT_MAXIMUM_CAPTURED_ARGUMENTS ) {
+            captured = NO;
+            break;
+        }
+
+        for ( int i = 0; i < specifier.starCount; i++ ) {
+            RZAssertArgument *argument = &_capturedArguments[_capturedArgumentCount++];
+            argument->type = RZAssertArgumentTypeSigned;
+            argument->signedValue = va_arg(remainingArguments, int);
+        }
+
+        captured = RZAssertCaptureArgument(format, &specifier, &remainingArguments, YES, &_capturedArguments[_capturedArgumentCount]);
+        if ( captured ) {
+            _capturedArgumentCount++;
+        }
+    }
+
+    va_end(remainingArguments);
+
+    return captured;
+}
+
+// The inverse of -arguments: unboxes each argument as the type its specifier captures.
+- (BOOL)restoreArguments:(NSArray *)arguments
+{
+    const char *format = [self.format UTF8String];
+    size_t cursor = 0;
+    RZAssertSpecifier specifier;
+    NSUInteger argumentIndex = 0;
+
+    while ( RZAssertNextSpecifier(format, &cursor, &specifier) ) {
+        if ( specifier.conversion == '%' ) {
+            continue;
+        }
+
+        if ( _capturedArgumentCount + (NSUInteger)specifier.starCount + 1 > RZASSERT_MAXIMUM_CAPTURED_ARGUMENTS ||
+             argumentIndex + (NSUInteger)specifier.starCount + 1 > arguments.count ) {
+            return NO;
+        }
+
+        for ( int i = 0; i < specifier.starCount; i++ ) {
+            RZAssertArgument *argument = &_capturedArguments[_capturedArgumentCount++];
+            argument->type = RZAssertArgumentTypeSigned;
+            argument->signedValue = [arguments[argumentIndex++] longLongValue];
+        }
+
+        id boxedArgument = arguments[argumentIndex++];
+        id value = ( boxedArgument == [NSNull null] ) ? nil : boxedArgument;
+        RZAssertArgument *argument = &_capturedArguments[_capturedArgumentCount];
+
+        switch ( specifier.conversion ) {
+            case 'd':
+            case 'i':
+            case 'c':
+            case 'C':
+                argument->type = RZAssertArgumentTypeSigned;
+                argument->signedValue = [value longLongValue];
+                break;
+            case 'o':
+            case 'u':
+            case 'x':
+            case 'X':
+                argument->type = RZAssertArgumentTypeUnsigned;
+                argument->unsignedValue = [value unsignedLongLongValue];
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if ( RZAssertSpecifierHasLength(format, &specifier, "L") ) {
+                    argument->type = RZAssertArgumentTypeLongDouble;
+                    argument->longDoubleValue = [value doubleValue];
+                }
+                else {
+                    argument->type = RZAssertArgumentTypeDouble;
+                    argument->doubleValue = [value doubleValue];
+                }
+                break;
+            case 'p':
+                argument->type = RZAssertArgumentTypePointer;
+                argument->pointerValue = [value isKindOfClass:[NSNumber class]] ? (const void *)(uintptr_t)[value unsignedLongLongValue] : [value pointerValue];
+                break;
+            case 's':
+                argument->type = RZAssertArgumentTypeCString;
+                argument->cStringValue = value ? strdup([[value description] UTF8String]) : NULL;
+                break;
+            case '@':
+                argument->type = RZAssertArgumentTypeObject;
+                argument->objectValue = value ? (void *)CFBridgingRetain(value) : NULL;
+                break;
+            default:
+                return NO;
+        }
+
+        _capturedArgumentCount++;
+    }
+
+    return YES;
+}
+
+- (void)releaseCapturedArguments
+{
+    for ( NSUInteger i = 0; i < _capturedArgumentCount; i++ ) {
+        RZAssertReleaseArgument(&_capturedArguments[i]);
+    }
+    _capturedArgumentCount = 0;
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+#pragma clang diagnostic ignored "-Wformat-security"
+
+// Rebuilds the detail one specifier at a time, so each captured argument is passed back with its own type.
+- (NSString *)buildFormattedDetail
+{
+    const char *format = [self.format UTF8String];
+    NSMutableString *formattedDetail = [NSMutableString string];
+    size_t cursor = 0;
+    size_t literalStart = 0;
+    NSUInteger argumentIndex = 0;
+    RZAssertSpecifier specifier;
+
+    while ( RZAssertNextSpecifier(format, &cursor, &specifier) ) {
+        [formattedDetail appendString:[[NSString alloc] initWithBytes:format + literalStart length:specifier.start - literalStart encoding:NSUTF8StringEncoding]];
+        literalStart = specifier.end;
+
+        if ( specifier.conversion == '%' ) {
+            [formattedDetail appendString:@"%"];
+            continue;
+        }
+
+        int stars[2] = { 0, 0 };
+        for ( int i = 0; i < specifier.starCount; i++ ) {
+            stars[i] = (int)_capturedArguments[argumentIndex++].signedValue;
+        }
+
+        const RZAssertArgument *argument = &_capturedArguments[argumentIndex++];
+
+        // Integers were widened when they were captured, so widen the length modifier to match.
+        const char *length = "";
+        if ( argument->type == RZAssertArgumentTypeSigned || argument->type == RZAssertArgumentTypeUnsigned ) {
+            length = ( specifier.conversion == 'c' || specifier.conversion == 'C' ) ? "" : "ll";
+        }
+        else if ( argument->type == RZAssertArgumentTypeLongDouble ) {
+            length = "L";
+        }
+
+        NSString *piece = [NSString stringWithFormat:@"%%%.*s%s%c", (int)(specifier.lengthStart - specifier.start - 1), format + specifier.start + 1, length, specifier.conversion];
+
+#define RZASSERT_FORMAT_PIECE(value) \
+    ( specifier.starCount == 0 ? [NSString stringWithFormat:piece, (value)] : \
+      specifier.starCount == 1 ? [NSString stringWithFormat:piece, stars[0], (value)] : \
+                                 [NSString stringWithFormat:piece, stars[0], stars[1], (value)] )
+
+        switch ( argument->type ) {
+            case RZAssertArgumentTypeSigned: {
+                if ( specifier.conversion == 'c' || specifier.conversion == 'C' ) {
+                    [formattedDetail appendString:RZASSERT_FORMAT_PIECE((int)argument->signedValue)];
+                }
+                else {
+                    [formattedDetail appendString:RZASSERT_FORMAT_PIECE(argument->signedValue)];
+                }
+                break;
+            }
+            case RZAssertArgumentTypeUnsigned:      [formattedDetail appendString:RZASSERT_FORMAT_PIECE(argument->unsignedValue)]; break;
+            case RZAssertArgumentTypeDouble:        [formattedDetail appendString:RZASSERT_FORMAT_PIECE(argument->doubleValue)]; break;
+            case RZAssertArgumentTypeLongDouble:    [formattedDetail appendString:RZASSERT_FORMAT_PIECE(argument->longDoubleValue)]; break;
+            case RZAssertArgumentTypePointer:       [formattedDetail appendString:RZASSERT_FORMAT_PIECE(argument->pointerValue)]; break;
+            case RZAssertArgumentTypeCString:       [formattedDetail appendString:RZASSERT_FORMAT_PIECE(argument->cStringValue)]; break;
+            case RZAssertArgumentTypeObject:        [formattedDetail appendString:RZASSERT_FORMAT_PIECE((__bridge id)argument->objectValue)]; break;
+        }
+
+#undef RZASSERT_FORMAT_PIECE
+    }
+
+    [formattedDetail appendString:[[NSString alloc] initWithBytes:format + literalStart length:strlen(format) - literalStart encoding:NSUTF8StringEncoding]];
+
+    return [formattedDetail copy];
+}
+
+#pragma clang diagnostic pop
+
+@end
+
+#pragma mark - Message Buffers
+
+// Appends to a fixed buffer, keeping it NUL-terminated, and notes when anything didn't fit.
+typedef struct {
+    char *bytes;
+    size_t capacity;
+    size_t length;
+    BOOL truncated;
+} RZAssertMessageWriter;
+
+static void RZAssertMessageWriterAppend(RZAssertMessageWriter *writer, const char *bytes, size_t length)
+{
+    size_t available = writer->capacity - 1 - writer->length;
+    if ( length > available ) {
+        length = available;
+        writer->truncated = YES;
+    }
+
+    memcpy(writer->bytes + writer->length, bytes, length);
+    writer->length += length;
+    writer->bytes[writer->length] = '\0';
+}
+
+// Accounts for text snprintf wrote directly into the buffer.
+static void RZAssertMessageWriterAdvance(RZAssertMessageWriter *writer, int written)
+{
+    if ( written < 0 ) {
+        writer->bytes[writer->length] = '\0';
+        return;
+    }
+
+    size_t available = writer->capacity - 1 - writer->length;
+    if ( (size_t)written > available ) {
+        writer->length += available;
+        writer->truncated = YES;
+    }
+    else {
+        writer->length += (size_t)written;
+    }
+}
+
+static void RZAssertMessageWriterAppendCharacter(RZAssertMessageWriter *writer, uint32_t character)
+{
+    char bytes[3];
+    size_t length = 0;
+
+    if ( character < 0x80 ) {
+        bytes[length++] = (char)character;
+    }
+    else if ( character < 0x800 ) {
+        bytes[length++] = (char)(0xc0 | (character >> 6));
+        bytes[length++] = (char)(0x80 | (character & 0x3f));
+    }
+    else {
+        bytes[length++] = (char)(0xe0 | ((character >> 12) & 0x0f));
+        bytes[length++] = (char)(0x80 | ((character >> 6) & 0x3f));
+        bytes[length++] = (char)(0x80 | (character & 0x3f));
+    }
+
+    RZAssertMessageWriterAppend(writer, bytes, length);
+}
+
+static void RZAssertMessageWriterAppendObject(RZAssertMessageWriter *writer, id object)
+{
+    if ( object == nil ) {
+        RZAssertMessageWriterAppend(writer, "(null)", 6);
+    }
+    else if ( [object isKindOfClass:[NSString class]] ) {
+        NSString *string = object;
+        NSUInteger usedLength = 0;
+        NSRange remainingRange = NSMakeRange(0, 0);
+
+        // Converts whole characters only, straight into the buffer.
+        [string getBytes:writer->bytes + writer->length
+               maxLength:writer->capacity - 1 - writer->length
+              usedLength:&usedLength
+                encoding:NSUTF8StringEncoding
+                 options:0
+                   range:NSMakeRange(0, string.length)
+          remainingRange:&remainingRange];
+
+        writer->length += usedLength;
+        writer->bytes[writer->length] = '\0';
+        writer->truncated = writer->truncated || ( remainingRange.length > 0 );
+    }
+    else {
+        size_t available = writer->capacity - writer->length;
+        RZAssertMessageWriterAdvance(writer, snprintf(writer->bytes + writer->length, available, "<%s: %p>", object_getClassName(object), (__bridge void *)object));
+    }
+}
+
+// snprintf may have stopped partway through a multibyte character.
+static void RZAssertMessageWriterTrimPartialCharacter(RZAssertMessageWriter *writer)
+{
+    size_t start = writer->length;
+    while ( start > 0 && ((unsigned char)writer->bytes[start - 1] & 0xc0) == 0x80 ) {
+        start--;
+    }
+
+    if ( start == 0 ) {
+        return;
+    }
+
+    unsigned char lead = (unsigned char)writer->bytes[start - 1];
+    size_t expectedLength = ( lead >= 0xf0 ) ? 4 : ( lead >= 0xe0 ) ? 3 : ( lead >= 0xc0 ) ? 2 : 1;
+
+    if ( writer->length - (start - 1) < expectedLength ) {
+        writer->length = start - 1;
+        writer->bytes[writer->length] = '\0';
+    }
+}
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wformat-nonliteral"
+#pragma clang diagnostic ignored "-Wformat-security"
+
+static void RZAssertMessageWriterAppendArgument(RZAssertMessageWriter *writer, const char *format, const RZAssertSpecifier *specifier, const int stars[2], const RZAssertArgument *argument)
+{
+    if ( argument->type == RZAssertArgumentTypeObject ) {
+        RZAssertMessageWriterAppendObject(writer, (__bridge id)argument->objectValue);
+        return;
+    }
+
+    if ( specifier->conversion == 'c' || specifier->conversion == 'C' ) {
+        RZAssertMessageWriterAppendCharacter(writer, (uint32_t)(specifier->conversion == 'c' ? (unsigned char)argument->signedValue : (uint16_t)argument->signedValue));
+        return;
+    }
+
+    // Integers were widened when they were captured, so widen the length modifier to match.
+    const char *length = "";
+    if ( argument->type == RZAssertArgumentTypeSigned || argument->type == RZAssertArgumentTypeUnsigned ) {
+        length = "ll";
+    }
+    else if ( argument->type == RZAssertArgumentTypeLongDouble ) {
+        length = "L";
+    }
+
+    // Flags, width and precision are kept unless they are absurdly long.
+    char piece[32];
+    int flagsLength = (int)(specifier->lengthStart - specifier->start - 1);
+    if ( flagsLength > 24 ) {
+        flagsLength = 0;
+    }
+    snprintf(piece, sizeof(piece), "%%%.*s%s%c", flagsLength, format + specifier->start + 1, length, specifier->conversion);
+
+    char *end = writer->bytes + writer->length;
+    size_t available = writer->capacity - writer->length;
+    int written = 0;
+
+#define RZASSERT_WRITE_PIECE(value) \
+    written = ( specifier->starCount == 0 ? snprintf(end, available, piece, (value)) : \
+                specifier->starCount == 1 ? snprintf(end, available, piece, stars[0], (value)) : \
+                                            snprintf(end, available, piece, stars[0], stars[1], (value)) )
+
+    switch ( argument->type ) {
+        case RZAssertArgumentTypeSigned:        RZASSERT_WRITE_PIECE(argument->signedValue); break;
+        case RZAssertArgumentTypeUnsigned:      RZASSERT_WRITE_PIECE(argument->unsignedValue); break;
+        case RZAssertArgumentTypeDouble:        RZASSERT_WRITE_PIECE(argument->doubleValue); break;
+        case RZAssertArgumentTypeLongDouble:    RZASSERT_WRITE_PIECE(argument->longDoubleValue); break;
+        case RZAssertArgumentTypePointer:       RZASSERT_WRITE_PIECE(argument->pointerValue); break;
+        case RZAssertArgumentTypeCString:       RZASSERT_WRITE_PIECE(argument->cStringValue ?: "(null)"); break;
+        case RZAssertArgumentTypeObject:        break;
+    }
+
+#undef RZASSERT_WRITE_PIECE
+
+    RZAssertMessageWriterAdvance(writer, written);
+}
+
+#pragma clang diagnostic pop
+
+// Formats the same message as -[RZAssertFailure message], one specifier at a time, without allocating.
+static void RZAssertMessageWriterAppendFailure(RZAssertMessageWriter *writer, const RZAssertSite *site, NSString *format, va_list arguments)
+{
+    RZAssertMessageWriterAdvance(writer, snprintf(writer->bytes, writer->capacity, "**** Assertion failure in %s, %s:%d\n", site->function, site->file, site->line));
+
+    char formatBytes[RZASSERT_MESSAGE_BUFFER_SIZE];
+    if ( ![format getCString:formatBytes maxLength:sizeof(formatBytes) encoding:NSUTF8StringEncoding] ) {
+        // Too long to parse here, so show the format as written.
+        RZAssertMessageWriterAppendObject(writer, format);
+        return;
+    }
+
+    va_list remainingArguments;
+    va_copy(remainingArguments, arguments);
+
+    size_t cursor = 0;
+    size_t literalStart = 0;
+    RZAssertSpecifier specifier;
+
+    while ( RZAssertNextSpecifier(formatBytes, &cursor, &specifier) ) {
+        RZAssertMessageWriterAppend(writer, formatBytes + literalStart, specifier.start - literalStart);
+        literalStart = specifier.end;
+
+        if ( specifier.conversion == '%' ) {
+            RZAssertMessageWriterAppend(writer, "%", 1);
+            continue;
+        }
+
+        int stars[2] = { 0, 0 };
+        for ( int i = 0; i < specifier.starCount; i++ ) {
+            stars[i] = va_arg(remainingArguments, int);
+        }
+
+        RZAssertArgument argument;
+        if ( !RZAssertCaptureArgument(formatBytes, &specifier, &remainingArguments, NO, &argument) ) {
+            // Nothing after an argument of unknown size can be read, so keep the rest of the format as written.
+            literalStart = specifier.start;
+            break;
+        }
+
+        RZAssertMessageWriterAppendArgument(writer, formatBytes, &specifier, stars, &argument);
+    }
+
+    RZAssertMessageWriterAppend(writer, formatBytes + literalStart, strlen(formatBytes) - literalStart);
+
+    va_end(remainingArguments);
+}
+
+static void RZAssertDeliverMessageBuffer(char *storage, const RZAssertSite *site, NSString *format, va_list arguments)
+{
+    RZAssertMessageWriter writer = { storage, RZASSERT_MESSAGE_BUFFER_SIZE, 0, NO };
+    storage[0] = '\0';
+
+    RZAssertMessageWriterAppendFailure(&writer, site, format, arguments);
+    if ( writer.truncated ) {
+        RZAssertMessageWriterTrimPartialCharacter(&writer);
+    }
+
+    RZAssertMessageBuffer buffer = { site, storage, writer.length, writer.truncated };
+    RZAssertSinkRegistryDeliverMessageBuffer(&buffer);
+}
+
+// Kept out of line, so only a handler that fails an assertion itself pays for a second buffer on the stack.
+static __attribute__((noinline)) void RZAssertDeliverNestedMessageBuffer(const RZAssertSite *site, NSString *format, va_list arguments)
+{
+    char storage[RZASSERT_MESSAGE_BUFFER_SIZE];
+    RZAssertDeliverMessageBuffer(storage, site, format, arguments);
+}
+
+NSString *RZAssertMessageBufferString(const RZAssertMessageBuffer *buffer)
+{
+    if ( !buffer ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: buffer must not be NULL", __PRETTY_FUNCTION__];
+    }
+
+    return [[NSString alloc] initWithBytes:buffer->UTF8String length:buffer->length encoding:NSUTF8StringEncoding];
+}
+
+#pragma mark - Reporting
+
+typedef struct {
+    BOOL inUse;
+    char storage[RZASSERT_MESSAGE_BUFFER_SIZE];
+} RZAssertThreadMessageBuffer;
+
+static pthread_key_t s_messageBufferKey;
+static pthread_once_t s_messageBufferKeyOnce = PTHREAD_ONCE_INIT;
+
+static void RZAssertMessageBufferKeyCreate(void)
+{
+    pthread_key_create(&s_messageBufferKey, free);
+}
+
+// Allocated the first time a thread reports a failure, and freed when the thread exits.
+static RZAssertThreadMessageBuffer *RZAssertThreadMessageBufferGet(void)
+{
+    pthread_once(&s_messageBufferKeyOnce, RZAssertMessageBufferKeyCreate);
+
+    RZAssertThreadMessageBuffer *buffer = pthread_getspecific(s_messageBufferKey);
+    if ( RZASSERT_UNLIKELY(buffer == NULL) ) {
+        buffer = calloc(1, sizeof(RZAssertThreadMessageBuffer));
+        pthread_setspecific(s_messageBufferKey, buffer);
+    }
+
+    return buffer;
+}
+
+void RZAssertReportFailure(RZAssertSite *site, NSString *format, ...)
+{
+    uint64_t control = __atomic_load_n(&RZAssertControlWord, __ATOMIC_ACQUIRE);
+
+    va_list arguments;
+    va_start(arguments, format);
+
+    if ( control & RZASSERT_CONTROL_MESSAGE_BUFFER_BIT ) {
+        RZAssertThreadMessageBuffer *buffer = RZAssertThreadMessageBufferGet();
+
+        if ( RZASSERT_LIKELY(buffer != NULL && !buffer->inUse) ) {
+            buffer->inUse = YES;
+            RZAssertDeliverMessageBuffer(buffer->storage, site, format, arguments);
+            buffer->inUse = NO;
+        }
+        else {
+            RZAssertDeliverNestedMessageBuffer(site, format, arguments);
+        }
+    }
+
+    // Only built if a handler needs the structured failure, or its NSString message.
+    if ( control & RZASSERT_CONTROL_FAILURE_BIT ) {
+        RZAssertFailure *failure = [[RZAssertFailure alloc] initWithSite:site format:format arguments:arguments];
+        if ( control & RZASSERT_CONTROL_BACKTRACE_BIT ) {
+            // Starts at the function that failed.
+            failure.backtrace = RZAssertBacktraceCapture(1);
+        }
+        [RZAssert reportFailure:failure];
+    }
+
+    va_end(arguments);
+}
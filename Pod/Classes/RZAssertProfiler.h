@@ -0,0 +1,123 @@
+//
+//  RZAssertProfiler.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertFailure.h"
+
+/**
+ *  The number of latency histogram buckets. Bucket @c i counts durations of at least 2^i and less than 2^(i+1) nanoseconds; the last bucket also counts anything longer.
+ */
+#define RZASSERT_PROFILER_BUCKET_COUNT 32
+
+/**
+ *  The most call sites the profiler can track. Sites first run after the table is full are not profiled.
+ */
+#define RZASSERT_PROFILER_CAPACITY 1024
+
+/**
+ *  The parts of an assertion the profiler times separately.
+ */
+typedef NS_ENUM(NSInteger, RZAssertProfilerPhase) {
+    /**
+     *  Evaluating the operands and the condition.
+     */
+    RZAssertProfilerPhaseCondition = 0,
+    /**
+     *  Reporting a failure, from deciding whether to log it to returning from the logger.
+     */
+    RZAssertProfilerPhaseFailure,
+};
+
+/**
+ *  How long one call site spent in its condition and in its failure path, as returned by +[RZAssert mostExpensiveSitesWithLimit:]. Only covers executions while profiling was enabled.
+ */
+@interface RZAssertSiteProfile : NSObject
+
+- (instancetype)initWithSite:(const RZAssertSite *)site conditionHistogram:(const uint64_t *)conditionHistogram conditionNanoseconds:(uint64_t)conditionNanoseconds failureHistogram:(const uint64_t *)failureHistogram failureNanoseconds:(uint64_t)failureNanoseconds;
+
+/**
+ *  The call site.
+ */
+@property (assign, nonatomic, readonly) const RZAssertSite *site;
+
+/**
+ *  How many times the condition was timed, and their total duration.
+ */
+@property (assign, nonatomic, readonly) uint64_t conditionCount;
+@property (assign, nonatomic, readonly) uint64_t conditionNanoseconds;
+
+/**
+ *  How many failures were timed, and their total duration.
+ */
+@property (assign, nonatomic, readonly) uint64_t failureCount;
+@property (assign, nonatomic, readonly) uint64_t failureNanoseconds;
+
+/**
+ *  The number of durations in each histogram bucket, as NSNumbers. See @c RZASSERT_PROFILER_BUCKET_COUNT.
+ */
+@property (copy, nonatomic, readonly) NSArray *conditionHistogram;
+@property (copy, nonatomic, readonly) NSArray *failureHistogram;
+
+/**
+ *  An upper bound on the given percentile of the condition's duration, from its histogram.
+ *
+ *  @param percentile A percentile between 0 and 100.
+ *
+ *  @return The upper edge of the bucket containing the percentile, in nanoseconds, or 0 if the condition was never timed.
+ */
+- (uint64_t)conditionNanosecondsAtPercentile:(double)percentile;
+
+@end
+
+/**
+ *  Allocates the profiler's table, the first time it is called. Call before setting the profiling control bit. For private use only.
+ */
+FOUNDATION_EXPORT void RZAssertProfilerPrepare(void);
+
+/**
+ *  Reads the monotonic clock used by the profiler. For private use only.
+ *
+ *  @return The current time in clock ticks: mach absolute time units on Apple platforms, otherwise nanoseconds. Never 0.
+ */
+FOUNDATION_EXPORT uint64_t RZAssertProfilerNow(void);
+
+/**
+ *  Adds the time since @c start to a site's histogram for a phase. Lock-free: the site claims a table entry with a compare-and-swap, and counts are atomic adds. Called by the assertion macros while profiling is enabled. For private use only.
+ *
+ *  @param site  The site that was timed.
+ *  @param phase The part of the assertion that was timed.
+ *  @param start A value returned by @c RZAssertProfilerNow() before the phase began.
+ */
+FOUNDATION_EXPORT void RZAssertProfilerRecord(RZAssertSite *site, RZAssertProfilerPhase phase, uint64_t start);
+
+/**
+ *  Reads every profiled site. For private use only; use +[RZAssert mostExpensiveSitesWithLimit:].
+ *
+ *  @param limit The most sites to return.
+ *
+ *  @return An array of up to @c limit RZAssertSiteProfile objects, most total time first.
+ */
+FOUNDATION_EXPORT NSArray *RZAssertProfilerMostExpensiveSites(NSUInteger limit);
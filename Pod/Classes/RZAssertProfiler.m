@@ -0,0 +1,229 @@
+//
+//  RZAssertProfiler.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertProfiler.h"
+
+#if defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+// One entry per site, claimed by swapping the site pointer into an empty slot. Entries are never
+// released, so a claimed slot always belongs to the same site.
+typedef struct RZAssertProfileEntry {
+    uintptr_t site;
+    uint64_t nanoseconds[2];
+    uint64_t histograms[2][RZASSERT_PROFILER_BUCKET_COUNT];
+} RZAssertProfileEntry;
+
+static RZAssertProfileEntry *s_profileEntries = NULL;
+
+#if defined(__APPLE__)
+static mach_timebase_info_data_t s_profilerTimebase;
+#endif
+
+#pragma mark - Table
+
+void RZAssertProfilerPrepare(void)
+{
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+#if defined(__APPLE__)
+        mach_timebase_info(&s_profilerTimebase);
+#endif
+        __atomic_store_n(&s_profileEntries, calloc(RZASSERT_PROFILER_CAPACITY, sizeof(RZAssertProfileEntry)), __ATOMIC_RELEASE);
+    });
+}
+
+static RZAssertProfileEntry *RZAssertProfilerEntryForSite(RZAssertSite *site)
+{
+    RZAssertProfileEntry *entries = __atomic_load_n(&s_profileEntries, __ATOMIC_ACQUIRE);
+    if ( entries == NULL ) {
+        return NULL;
+    }
+
+    uintptr_t key = (uintptr_t)site;
+    size_t index = (size_t)((key >> 3) * 0x9e3779b97f4a7c15ull) % RZASSERT_PROFILER_CAPACITY;
+
+    for ( size_t probe = 0; probe < RZASSERT_PROFILER_CAPACITY; probe++ ) {
+        RZAssertProfileEntry *entry = &entries[(index + probe) % RZASSERT_PROFILER_CAPACITY];
+        uintptr_t current = __atomic_load_n(&entry->site, __ATOMIC_RELAXED);
+
+        if ( current == 0 ) {
+            if ( __atomic_compare_exchange_n(&entry->site, &current, key, NO, __ATOMIC_RELAXED, __ATOMIC_RELAXED) ) {
+                return entry;
+            }
+            // Lost the race for this slot; current now holds the winner.
+        }
+        if ( current == key ) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+#pragma mark - Timing
+
+uint64_t RZAssertProfilerNow(void)
+{
+#if defined(__APPLE__)
+    return mach_absolute_time() | 1;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (((uint64_t)now.tv_sec * NSEC_PER_SEC) + (uint64_t)now.tv_nsec) | 1;
+#endif
+}
+
+void RZAssertProfilerRecord(RZAssertSite *site, RZAssertProfilerPhase phase, uint64_t start)
+{
+    uint64_t elapsed = RZAssertProfilerNow() - start;
+#if defined(__APPLE__)
+    elapsed = elapsed * s_profilerTimebase.numer / s_profilerTimebase.denom;
+#endif
+
+    RZAssertProfileEntry *entry = RZAssertProfilerEntryForSite(site);
+    if ( entry == NULL ) {
+        return;
+    }
+
+    unsigned int bucket = 63 - (unsigned int)__builtin_clzll(elapsed | 1);
+    if ( bucket >= RZASSERT_PROFILER_BUCKET_COUNT ) {
+        bucket = RZASSERT_PROFILER_BUCKET_COUNT - 1;
+    }
+
+    __atomic_fetch_add(&entry->histograms[phase][bucket], 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&entry->nanoseconds[phase], elapsed, __ATOMIC_RELAXED);
+}
+
+#pragma mark - Reporting
+
+NSArray *RZAssertProfilerMostExpensiveSites(NSUInteger limit)
+{
+    RZAssertProfileEntry *entries = __atomic_load_n(&s_profileEntries, __ATOMIC_ACQUIRE);
+    if ( entries == NULL ) {
+        return @[];
+    }
+
+    NSMutableArray *profiles = [NSMutableArray array];
+
+    for ( size_t i = 0; i < RZASSERT_PROFILER_CAPACITY; i++ ) {
+        RZAssertProfileEntry *entry = &entries[i];
+        const RZAssertSite *site = (const RZAssertSite *)__atomic_load_n(&entry->site, __ATOMIC_RELAXED);
+        if ( site == NULL ) {
+            continue;
+        }
+
+        uint64_t histograms[2][RZASSERT_PROFILER_BUCKET_COUNT];
+        for ( size_t phase = 0; phase < 2; phase++ ) {
+            for ( size_t bucket = 0; bucket < RZASSERT_PROFILER_BUCKET_COUNT; bucket++ ) {
+                histograms[phase][bucket] = __atomic_load_n(&entry->histograms[phase][bucket], __ATOMIC_RELAXED);
+            }
+        }
+
+        [profiles addObject:[[RZAssertSiteProfile alloc] initWithSite:site
+                                                   conditionHistogram:histograms[RZAssertProfilerPhaseCondition]
+                                                 conditionNanoseconds:__atomic_load_n(&entry->nanoseconds[RZAssertProfilerPhaseCondition], __ATOMIC_RELAXED)
+                                                     failureHistogram:histograms[RZAssertProfilerPhaseFailure]
+                                                   failureNanoseconds:__atomic_load_n(&entry->nanoseconds[RZAssertProfilerPhaseFailure], __ATOMIC_RELAXED)]];
+    }
+
+    [profiles sortUsingComparator:^NSComparisonResult(RZAssertSiteProfile *profile1, RZAssertSiteProfile *profile2) {
+        uint64_t total1 = profile1.conditionNanoseconds + profile1.failureNanoseconds;
+        uint64_t total2 = profile2.conditionNanoseconds + profile2.failureNanoseconds;
+
+        if ( total1 == total2 ) {
+            return NSOrderedSame;
+        }
+        return ( total1 > total2 ) ? NSOrderedAscending : NSOrderedDescending;
+    }];
+
+    if ( profiles.count > limit ) {
+        [profiles removeObjectsInRange:NSMakeRange(limit, profiles.count - limit)];
+    }
+
+    return [profiles copy];
+}
+
+#pragma mark - RZAssertSiteProfile
+
+static NSArray *RZAssertProfilerHistogramArray(const uint64_t *histogram, uint64_t *count)
+{
+    NSMutableArray *array = [NSMutableArray arrayWithCapacity:RZASSERT_PROFILER_BUCKET_COUNT];
+    *count = 0;
+
+    for ( size_t bucket = 0; bucket < RZASSERT_PROFILER_BUCKET_COUNT; bucket++ ) {
+        [array addObject:@(histogram[bucket])];
+        *count += histogram[bucket];
+    }
+
+    return [array copy];
+}
+
+@implementation RZAssertSiteProfile
+
+- (instancetype)initWithSite:(const RZAssertSite *)site conditionHistogram:(const uint64_t *)conditionHistogram conditionNanoseconds:(uint64_t)conditionNanoseconds failureHistogram:(const uint64_t *)failureHistogram failureNanoseconds:(uint64_t)failureNanoseconds
+{
+    self = [super init];
+    if ( self ) {
+        _site = site;
+        _conditionHistogram = RZAssertProfilerHistogramArray(conditionHistogram, &_conditionCount);
+        _conditionNanoseconds = conditionNanoseconds;
+        _failureHistogram = RZAssertProfilerHistogramArray(failureHistogram, &_failureCount);
+        _failureNanoseconds = failureNanoseconds;
+    }
+    return self;
+}
+
+- (uint64_t)conditionNanosecondsAtPercentile:(double)percentile
+{
+    if ( self.conditionCount == 0 ) {
+        return 0;
+    }
+
+    double target = self.conditionCount * MAX(0.0, MIN(percentile, 100.0)) / 100.0;
+    uint64_t seen = 0;
+
+    for ( NSUInteger bucket = 0; bucket < RZASSERT_PROFILER_BUCKET_COUNT - 1; bucket++ ) {
+        seen += [self.conditionHistogram[bucket] unsignedLongLongValue];
+        if ( seen > 0 && seen >= target ) {
+            return 1ull << (bucket + 1);
+        }
+    }
+
+    return UINT64_MAX;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; %s at %s:%d; conditions: %llu in %llu ns; failures: %llu in %llu ns>", NSStringFromClass([self class]), (void *)self, self.site->kind, self.site->file, self.site->line, (unsigned long long)self.conditionCount, (unsigned long long)self.conditionNanoseconds, (unsigned long long)self.failureCount, (unsigned long long)self.failureNanoseconds];
+}
+
+@end
@@ -0,0 +1,75 @@
+//
+//  RZAssertSinkRegistry.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssert.h"
+
+/**
+ *  A destination for failures, with an optional filter. Immutable, so a published list of sinks can be read without locking. For private use only.
+ */
+@interface RZAssertSink : NSObject
+
+- (instancetype)initWithFilter:(BOOL(^)(RZAssertFailure *failure))filter handler:(void(^)(RZAssertFailure *failure))handler;
+
+- (instancetype)initWithMessageBufferHandler:(void(^)(const RZAssertMessageBuffer *buffer))messageBufferHandler;
+
+/**
+ *  Returns @c YES for the failures the sink wants, or is nil if it wants all of them.
+ */
+@property (copy, nonatomic, readonly) BOOL (^filter)(RZAssertFailure *failure);
+
+/**
+ *  Receives failures, or is nil if the sink only takes message buffers.
+ */
+@property (copy, nonatomic, readonly) void (^handler)(RZAssertFailure *failure);
+
+/**
+ *  Receives message buffers, or is nil if the sink only takes failures.
+ */
+@property (copy, nonatomic, readonly) void (^messageBufferHandler)(const RZAssertMessageBuffer *buffer);
+
+@end
+
+/**
+ *  Replaces the published list of sinks. Readers that already hold the previous list finish with it; it is released once no thread holds it. Writers are serialized with each other, but never block readers. For private use only.
+ *
+ *  @param sinks The sinks to deliver failures to, in order, or nil for none.
+ */
+FOUNDATION_EXPORT void RZAssertSinkRegistryPublish(NSArray *sinks);
+
+/**
+ *  Delivers a failure to every published sink with a handler whose filter accepts it, without taking a lock. Safe to call from any thread, and from within a sink. If a sink throws, the exception propagates and the remaining sinks are skipped. For private use only.
+ *
+ *  @param failure The failure to deliver.
+ */
+FOUNDATION_EXPORT void RZAssertSinkRegistryDeliver(RZAssertFailure *failure);
+
+/**
+ *  Delivers a message buffer to every published sink with a message buffer handler, without taking a lock or allocating, on the calling thread. Safe to call from any thread, and from within a sink. For private use only.
+ *
+ *  @param buffer The buffer to deliver.
+ */
+FOUNDATION_EXPORT void RZAssertSinkRegistryDeliverMessageBuffer(const RZAssertMessageBuffer *buffer);
@@ -0,0 +1,285 @@
+//
+//  RZAssertSinkRegistry.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertSinkRegistry.h"
+
+#include <pthread.h>
+
+#pragma mark - RZAssertSink
+
+@implementation RZAssertSink
+
+- (instancetype)initWithFilter:(BOOL(^)(RZAssertFailure *failure))filter handler:(void(^)(RZAssertFailure *failure))handler
+{
+    if ( !handler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: handler must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    self = [super init];
+    if ( self ) {
+        _filter = [filter copy];
+        _handler = [handler copy];
+    }
+
+    return self;
+}
+
+- (instancetype)initWithMessageBufferHandler:(void(^)(const RZAssertMessageBuffer *buffer))messageBufferHandler
+{
+    if ( !messageBufferHandler ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: messageBufferHandler must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    self = [super init];
+    if ( self ) {
+        _messageBufferHandler = [messageBufferHandler copy];
+    }
+
+    return self;
+}
+
+@end
+
+#pragma mark - Hazard Pointers
+
+// The sink list is an immutable NSArray, published as a retained pointer. A reader
+// announces the list it is about to use in one of its thread's hazard slots, then
+// checks that the list is still published. A writer that replaces the list only
+// releases it once no hazard slot names it. So readers never lock or write shared
+// memory, and a list is never released while a sink from it is running.
+//
+// Sinks may fail assertions themselves, so each thread has a slot per nesting level.
+// Deeper than that, a reader uses the transient slot just long enough to retain the list.
+
+#define RZASSERT_HAZARD_SLOT_COUNT 4
+
+typedef struct RZAssertHazardRecord {
+    struct RZAssertHazardRecord *next;
+    int32_t active;
+    NSUInteger depth;
+    void *transientSlot;
+    void *slots[RZASSERT_HAZARD_SLOT_COUNT];
+} RZAssertHazardRecord;
+
+typedef struct RZAssertRetiredList {
+    struct RZAssertRetiredList *next;
+    void *sinks;
+} RZAssertRetiredList;
+
+static void *s_publishedSinks = NULL;
+
+// Records are never freed; a thread that exits gives its record back for reuse.
+static RZAssertHazardRecord *s_hazardRecords = NULL;
+static pthread_key_t s_hazardRecordKey;
+static pthread_once_t s_hazardRecordKeyOnce = PTHREAD_ONCE_INIT;
+
+// Guarded by s_writeLock.
+static pthread_mutex_t s_writeLock = PTHREAD_MUTEX_INITIALIZER;
+static RZAssertRetiredList *s_retiredLists = NULL;
+
+static void RZAssertHazardRecordRelease(void *context)
+{
+    RZAssertHazardRecord *record = context;
+    record->depth = 0;
+    __atomic_store_n(&record->active, 0, __ATOMIC_RELEASE);
+}
+
+static void RZAssertHazardRecordKeyCreate(void)
+{
+    pthread_key_create(&s_hazardRecordKey, RZAssertHazardRecordRelease);
+}
+
+static RZAssertHazardRecord *RZAssertHazardRecordForCurrentThread(void)
+{
+    pthread_once(&s_hazardRecordKeyOnce, RZAssertHazardRecordKeyCreate);
+
+    RZAssertHazardRecord *record = pthread_getspecific(s_hazardRecordKey);
+    if ( RZASSERT_LIKELY(record != NULL) ) {
+        return record;
+    }
+
+    for ( record = __atomic_load_n(&s_hazardRecords, __ATOMIC_ACQUIRE); record != NULL; record = record->next ) {
+        int32_t inactive = 0;
+        if ( __atomic_compare_exchange_n(&record->active, &inactive, 1, false, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED) ) {
+            break;
+        }
+    }
+
+    if ( record == NULL ) {
+        record = calloc(1, sizeof(RZAssertHazardRecord));
+        record->active = 1;
+
+        RZAssertHazardRecord *head = __atomic_load_n(&s_hazardRecords, __ATOMIC_RELAXED);
+        do {
+            record->next = head;
+        } while ( !__atomic_compare_exchange_n(&s_hazardRecords, &head, record, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED) );
+    }
+
+    pthread_setspecific(s_hazardRecordKey, record);
+    return record;
+}
+
+static void *RZAssertHazardProtect(void **slot)
+{
+    void *sinks = __atomic_load_n(&s_publishedSinks, __ATOMIC_SEQ_CST);
+
+    for ( ;; ) {
+        __atomic_store_n(slot, sinks, __ATOMIC_SEQ_CST);
+
+        void *publishedSinks = __atomic_load_n(&s_publishedSinks, __ATOMIC_SEQ_CST);
+        if ( publishedSinks == sinks ) {
+            return sinks;
+        }
+
+        sinks = publishedSinks;
+    }
+}
+
+static BOOL RZAssertHazardIsProtected(void *sinks)
+{
+    for ( RZAssertHazardRecord *record = __atomic_load_n(&s_hazardRecords, __ATOMIC_ACQUIRE); record != NULL; record = record->next ) {
+        if ( __atomic_load_n(&record->transientSlot, __ATOMIC_SEQ_CST) == sinks ) {
+            return YES;
+        }
+
+        for ( NSUInteger i = 0; i < RZASSERT_HAZARD_SLOT_COUNT; i++ ) {
+            if ( __atomic_load_n(&record->slots[i], __ATOMIC_SEQ_CST) == sinks ) {
+                return YES;
+            }
+        }
+    }
+
+    return NO;
+}
+
+#pragma mark - Delivery
+
+typedef void (*RZAssertSinkVisitor)(RZAssertSink *sink, const void *context);
+
+// Calls the visitor with each published sink, holding the list with a hazard slot.
+static void RZAssertSinkRegistryVisit(RZAssertSinkVisitor visitor, const void *context)
+{
+    RZAssertHazardRecord *record = RZAssertHazardRecordForCurrentThread();
+    NSUInteger depth = record->depth;
+    NSArray *retainedSinks = nil;
+    void *sinks = NULL;
+
+    if ( RZASSERT_LIKELY(depth < RZASSERT_HAZARD_SLOT_COUNT) ) {
+        sinks = RZAssertHazardProtect(&record->slots[depth]);
+    }
+    else {
+        sinks = RZAssertHazardProtect(&record->transientSlot);
+        retainedSinks = (__bridge NSArray *)sinks;
+        __atomic_store_n(&record->transientSlot, NULL, __ATOMIC_RELEASE);
+    }
+
+    // A sink may throw, for example by failing an NSAssert in a debug build. The depth and
+    // the slot are restored regardless, or the list could never be released, and every later
+    // visit on this thread would use the transient slot. The list isn't retained across the
+    // sinks, since ARC wouldn't release it while unwinding.
+    @try {
+        if ( sinks ) {
+            record->depth = depth + 1;
+
+            __unsafe_unretained NSArray *sinkList = retainedSinks ?: (__bridge NSArray *)sinks;
+            for ( NSUInteger i = 0, count = sinkList.count; i < count; i++ ) {
+                visitor(sinkList[i], context);
+            }
+        }
+    }
+    @finally {
+        record->depth = depth;
+
+        if ( depth < RZASSERT_HAZARD_SLOT_COUNT ) {
+            __atomic_store_n(&record->slots[depth], NULL, __ATOMIC_RELEASE);
+        }
+    }
+}
+
+static void RZAssertSinkDeliverFailure(RZAssertSink *sink, const void *context)
+{
+    RZAssertFailure *failure = (__bridge RZAssertFailure *)context;
+
+    if ( sink.handler && ( sink.filter == nil || sink.filter(failure) ) ) {
+        sink.handler(failure);
+    }
+}
+
+static void RZAssertSinkDeliverMessageBuffer(RZAssertSink *sink, const void *context)
+{
+    if ( sink.messageBufferHandler ) {
+        sink.messageBufferHandler(context);
+    }
+}
+
+#pragma mark - Public
+
+void RZAssertSinkRegistryPublish(NSArray *sinks)
+{
+    void *newSinks = ( sinks.count > 0 ) ? (__bridge_retained void *)[sinks copy] : NULL;
+
+    pthread_mutex_lock(&s_writeLock);
+
+    void *oldSinks = __atomic_exchange_n(&s_publishedSinks, newSinks, __ATOMIC_SEQ_CST);
+
+    if ( oldSinks ) {
+        RZAssertRetiredList *retired = malloc(sizeof(RZAssertRetiredList));
+        retired->sinks = oldSinks;
+        retired->next = s_retiredLists;
+        s_retiredLists = retired;
+    }
+
+    // Release whatever no reader holds any more. The rest waits for the next publish.
+    NSMutableArray *releasedSinks = [NSMutableArray array];
+
+    for ( RZAssertRetiredList **link = &s_retiredLists; *link != NULL; ) {
+        RZAssertRetiredList *retired = *link;
+
+        if ( RZAssertHazardIsProtected(retired->sinks) ) {
+            link = &retired->next;
+        }
+        else {
+            [releasedSinks addObject:CFBridgingRelease(retired->sinks)];
+            *link = retired->next;
+            free(retired);
+        }
+    }
+
+    pthread_mutex_unlock(&s_writeLock);
+
+    // releasedSinks drops the last references here, outside the lock, in case a sink's dealloc publishes.
+}
+
+void RZAssertSinkRegistryDeliver(RZAssertFailure *failure)
+{
+    RZAssertSinkRegistryVisit(RZAssertSinkDeliverFailure, (__bridge const void *)failure);
+}
+
+void RZAssertSinkRegistryDeliverMessageBuffer(const RZAssertMessageBuffer *buffer)
+{
+    RZAssertSinkRegistryVisit(RZAssertSinkDeliverMessageBuffer, buffer);
+}
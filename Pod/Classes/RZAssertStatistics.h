@@ -0,0 +1,67 @@
+//
+//  RZAssertStatistics.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertFailure.h"
+
+/**
+ *  How often one call site was checked and failed, as returned by +[RZAssert statisticsSnapshot]. Only counts executions while statistics were enabled.
+ */
+@interface RZAssertSiteStatistics : NSObject
+
+- (instancetype)initWithSite:(const RZAssertSite *)site evaluationCount:(uint64_t)evaluationCount failureCount:(uint64_t)failureCount;
+
+/**
+ *  The call site.
+ */
+@property (assign, nonatomic, readonly) const RZAssertSite *site;
+
+/**
+ *  How many times the site's condition was evaluated.
+ */
+@property (assign, nonatomic, readonly) uint64_t evaluationCount;
+
+/**
+ *  How many of those evaluations failed.
+ */
+@property (assign, nonatomic, readonly) uint64_t failureCount;
+
+@end
+
+/**
+ *  Counts one evaluation of a site, in the calling thread's own counters, so threads checking the same hot site never write to a shared cache line. Called by the assertion macros while statistics are enabled. For private use only.
+ *
+ *  @param site   The site that was checked.
+ *  @param failed Whether the check failed.
+ */
+FOUNDATION_EXPORT void RZAssertStatisticsRecord(RZAssertSite *site, BOOL failed);
+
+/**
+ *  Sums every thread's counters, including those of threads that have exited. For private use only; use +[RZAssert statisticsSnapshot].
+ *
+ *  @return An array of RZAssertSiteStatistics, one for each site counted so far, in the order they were first counted.
+ */
+FOUNDATION_EXPORT NSArray *RZAssertStatisticsSnapshot(void);
@@ -0,0 +1,231 @@
+//
+//  RZAssertStatistics.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertStatistics.h"
+
+#include <pthread.h>
+
+#define RZASSERT_STATISTICS_MINIMUM_CAPACITY 64
+
+// Each thread owns an array of counters, indexed by site, that only it writes. Sites get dense
+// indices, from 1, the first time they are counted. Snapshots read the arrays with relaxed
+// loads, so a snapshot taken while threads are counting may miss their latest increments.
+typedef struct RZAssertStatisticsShard {
+    // Two counters per site: evaluations, then failures.
+    uint64_t *counts;
+    uint32_t capacity;
+    struct RZAssertStatisticsShard *next;
+} RZAssertStatisticsShard;
+
+// Guards everything below, and each shard's counts pointer. Counting only takes it to assign
+// an index or grow a shard.
+static pthread_mutex_t s_statisticsMutex = PTHREAD_MUTEX_INITIALIZER;
+static RZAssertStatisticsShard *s_shards = NULL;
+static RZAssertSite **s_sites = NULL;
+static uint32_t s_siteCount = 0;
+static uint32_t s_siteCapacity = 0;
+
+// Counts from threads that have exited.
+static uint64_t *s_retiredCounts = NULL;
+static uint32_t s_retiredCapacity = 0;
+
+// Each thread's shard. Created before the first site gets an index, so a thread that
+// has seen a nonzero index can read it.
+static pthread_key_t s_shardKey;
+static pthread_once_t s_shardKeyOnce = PTHREAD_ONCE_INIT;
+
+#pragma mark - Storage
+
+static uint32_t RZAssertStatisticsCapacityForIndex(uint32_t index)
+{
+    uint32_t capacity = RZASSERT_STATISTICS_MINIMUM_CAPACITY;
+    while ( capacity <= index ) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+// Grows a counter array to hold an index, keeping its counts. Called with the mutex held.
+static void RZAssertStatisticsGrowCounts(uint64_t **counts, uint32_t *capacity, uint32_t index)
+{
+    if ( index < *capacity ) {
+        return;
+    }
+
+    uint32_t newCapacity = RZAssertStatisticsCapacityForIndex(index);
+    uint64_t *newCounts = calloc(2 * (size_t)newCapacity, sizeof(uint64_t));
+    for ( uint32_t i = 0; i < *capacity; i++ ) {
+        newCounts[2 * i] = __atomic_load_n(&(*counts)[2 * i], __ATOMIC_RELAXED);
+        newCounts[2 * i + 1] = __atomic_load_n(&(*counts)[2 * i + 1], __ATOMIC_RELAXED);
+    }
+
+    free(*counts);
+    *counts = newCounts;
+    *capacity = newCapacity;
+}
+
+// Folds an exiting thread's counts into the retired counts, so they survive it.
+static void RZAssertStatisticsRetireShard(void *value)
+{
+    RZAssertStatisticsShard *shard = value;
+
+    pthread_mutex_lock(&s_statisticsMutex);
+
+    if ( shard->capacity > 0 ) {
+        RZAssertStatisticsGrowCounts(&s_retiredCounts, &s_retiredCapacity, shard->capacity - 1);
+    }
+    for ( uint32_t i = 0; i < 2 * shard->capacity; i++ ) {
+        s_retiredCounts[i] += shard->counts[i];
+    }
+
+    for ( RZAssertStatisticsShard **link = &s_shards; *link; link = &(*link)->next ) {
+        if ( *link == shard ) {
+            *link = shard->next;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&s_statisticsMutex);
+
+    free(shard->counts);
+    free(shard);
+}
+
+static void RZAssertStatisticsCreateShardKey(void)
+{
+    pthread_key_create(&s_shardKey, RZAssertStatisticsRetireShard);
+}
+
+// The slow path: gives the site an index, and the thread a shard big enough to count it.
+static RZAssertStatisticsShard *RZAssertStatisticsPrepare(RZAssertSite *site, uint32_t *index)
+{
+    pthread_once(&s_shardKeyOnce, RZAssertStatisticsCreateShardKey);
+
+    pthread_mutex_lock(&s_statisticsMutex);
+
+    *index = __atomic_load_n(&site->statisticsIndex, __ATOMIC_RELAXED);
+    if ( *index == 0 ) {
+        if ( s_siteCount + 1 >= s_siteCapacity ) {
+            s_siteCapacity = RZAssertStatisticsCapacityForIndex(s_siteCount + 1);
+            s_sites = realloc(s_sites, s_siteCapacity * sizeof(RZAssertSite *));
+        }
+        *index = ++s_siteCount;
+        s_sites[*index] = site;
+        __atomic_store_n(&site->statisticsIndex, *index, __ATOMIC_RELEASE);
+    }
+
+    RZAssertStatisticsShard *shard = pthread_getspecific(s_shardKey);
+    if ( shard == NULL ) {
+        shard = calloc(1, sizeof(RZAssertStatisticsShard));
+        shard->next = s_shards;
+        s_shards = shard;
+        pthread_setspecific(s_shardKey, shard);
+    }
+
+    RZAssertStatisticsGrowCounts(&shard->counts, &shard->capacity, *index);
+
+    pthread_mutex_unlock(&s_statisticsMutex);
+
+    return shard;
+}
+
+#pragma mark - Counting
+
+void RZAssertStatisticsRecord(RZAssertSite *site, BOOL failed)
+{
+    uint32_t index = __atomic_load_n(&site->statisticsIndex, __ATOMIC_ACQUIRE);
+    RZAssertStatisticsShard *shard = ( index != 0 ) ? pthread_getspecific(s_shardKey) : NULL;
+
+    if ( shard == NULL || index >= shard->capacity ) {
+        shard = RZAssertStatisticsPrepare(site, &index);
+    }
+
+    // Only this thread writes its counters, so a plain increment can't lose counts. The
+    // atomic store just keeps concurrent snapshots well defined.
+    uint64_t *counts = shard->counts + 2 * index;
+    __atomic_store_n(&counts[0], counts[0] + 1, __ATOMIC_RELAXED);
+    if ( failed ) {
+        __atomic_store_n(&counts[1], counts[1] + 1, __ATOMIC_RELAXED);
+    }
+}
+
+NSArray *RZAssertStatisticsSnapshot(void)
+{
+    pthread_mutex_lock(&s_statisticsMutex);
+
+    uint32_t siteCount = s_siteCount;
+    uint64_t *totals = calloc(2 * ((size_t)siteCount + 1), sizeof(uint64_t));
+    RZAssertSite **sites = calloc((size_t)siteCount + 1, sizeof(RZAssertSite *));
+
+    for ( uint32_t i = 1; i <= siteCount; i++ ) {
+        sites[i] = s_sites[i];
+    }
+
+    for ( uint32_t i = 0; i < 2 * MIN(s_retiredCapacity, siteCount + 1); i++ ) {
+        totals[i] += s_retiredCounts[i];
+    }
+
+    for ( RZAssertStatisticsShard *shard = s_shards; shard; shard = shard->next ) {
+        for ( uint32_t i = 0; i < 2 * MIN(shard->capacity, siteCount + 1); i++ ) {
+            totals[i] += __atomic_load_n(&shard->counts[i], __ATOMIC_RELAXED);
+        }
+    }
+
+    pthread_mutex_unlock(&s_statisticsMutex);
+
+    NSMutableArray *statistics = [NSMutableArray arrayWithCapacity:siteCount];
+    for ( uint32_t i = 1; i <= siteCount; i++ ) {
+        [statistics addObject:[[RZAssertSiteStatistics alloc] initWithSite:sites[i] evaluationCount:totals[2 * i] failureCount:totals[2 * i + 1]]];
+    }
+
+    free(totals);
+    free(sites);
+
+    return [statistics copy];
+}
+
+#pragma mark - RZAssertSiteStatistics
+
+@implementation RZAssertSiteStatistics
+
+- (instancetype)initWithSite:(const RZAssertSite *)site evaluationCount:(uint64_t)evaluationCount failureCount:(uint64_t)failureCount
+{
+    self = [super init];
+    if ( self ) {
+        _site = site;
+        _evaluationCount = evaluationCount;
+        _failureCount = failureCount;
+    }
+    return self;
+}
+
+- (NSString *)description
+{
+    return [NSString stringWithFormat:@"<%@: %p; %s at %s:%d; evaluations: %llu; failures: %llu>", NSStringFromClass([self class]), (void *)self, self.site->kind, self.site->file, self.site->line, (unsigned long long)self.evaluationCount, (unsigned long long)self.failureCount];
+}
+
+@end
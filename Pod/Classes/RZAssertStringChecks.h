@@ -0,0 +1,61 @@
+//
+//  RZAssertStringChecks.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#if __has_feature(modules)
+@import Foundation;
+#else
+#import <Foundation/Foundation.h>
+#endif
+
+/**
+ *  The number of UTF-16 code units shown on each side of the first difference in a string failure message.
+ */
+#define RZASSERT_STRING_CONTEXT_LENGTH 32
+
+/**
+ *  Checks whether two strings are equal, with the same result as -isEqualToString:, except that two nil strings are equal. Identical pointers and different lengths are decided without reading the contents. Otherwise the strings' backing storage is compared with a vector kernel when both expose it directly, and copied out in chunks when they don't. For private use only; use @c RZASSERT_EQUAL_STRINGS.
+ *
+ *  @param left  A string, or nil.
+ *  @param right A string, or nil.
+ *
+ *  @return @c YES if the strings are equal.
+ */
+FOUNDATION_EXPORT BOOL RZAssertStringsEqual(NSString *left, NSString *right);
+
+/**
+ *  Finds the first UTF-16 code unit at which two strings differ. For private use only.
+ *
+ *  @return The offset of the first difference, which is the length of the shorter string if one is a prefix of the other, or @c NSNotFound if the strings are equal.
+ */
+FOUNDATION_EXPORT NSUInteger RZAssertFirstStringDifference(NSString *left, NSString *right);
+
+/**
+ *  Describes where two unequal strings first differ, showing only a bounded window of each around that offset. For private use only.
+ *
+ *  @return A description for a failure message.
+ */
+FOUNDATION_EXPORT NSString *RZAssertDescribeStringDifference(NSString *left, NSString *right);
@@ -0,0 +1,153 @@
+//
+//  RZAssertStringChecks.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertStringChecks.h"
+#import "RZAssertBufferChecks.h"
+
+// Strings without direct storage are copied out this many code units at a time.
+#define RZASSERT_STRING_CHUNK_LENGTH 256
+
+#pragma mark - Comparison
+
+// Compares strings of equal length, starting at an offset, and returns the first differing
+// offset, or length.
+static NSUInteger RZAssertFirstDifferenceFrom(NSString *left, NSString *right, NSUInteger start, NSUInteger length)
+{
+#if defined(__APPLE__)
+    // Both strings are stored as UTF-16, or both as ASCII, which CF exposes as UTF-8, so one
+    // byte scan compares them without copying.
+    CFStringRef leftString = (__bridge CFStringRef)left;
+    CFStringRef rightString = (__bridge CFStringRef)right;
+
+    const UniChar *leftCharacters = CFStringGetCharactersPtr(leftString);
+    const UniChar *rightCharacters = CFStringGetCharactersPtr(rightString);
+    if ( leftCharacters != NULL && rightCharacters != NULL ) {
+        size_t offset = RZAssertFirstDifferentByte(leftCharacters + start, rightCharacters + start, (length - start) * sizeof(UniChar));
+        return start + offset / sizeof(UniChar);
+    }
+
+    const char *leftBytes = CFStringGetCStringPtr(leftString, kCFStringEncodingUTF8);
+    const char *rightBytes = CFStringGetCStringPtr(rightString, kCFStringEncodingUTF8);
+    if ( leftBytes != NULL && rightBytes != NULL ) {
+        return start + RZAssertFirstDifferentByte(leftBytes + start, rightBytes + start, length - start);
+    }
+#endif
+
+    unichar leftChunk[RZASSERT_STRING_CHUNK_LENGTH];
+    unichar rightChunk[RZASSERT_STRING_CHUNK_LENGTH];
+
+    for ( NSUInteger location = start; location < length; location += RZASSERT_STRING_CHUNK_LENGTH ) {
+        NSRange range = NSMakeRange(location, MIN((NSUInteger)RZASSERT_STRING_CHUNK_LENGTH, length - location));
+        [left getCharacters:leftChunk range:range];
+        [right getCharacters:rightChunk range:range];
+
+        size_t offset = RZAssertFirstDifferentByte(leftChunk, rightChunk, range.length * sizeof(unichar));
+        if ( offset < range.length * sizeof(unichar) ) {
+            return location + offset / sizeof(unichar);
+        }
+    }
+
+    return length;
+}
+
+BOOL RZAssertStringsEqual(NSString *left, NSString *right)
+{
+    if ( left == right ) {
+        return YES;
+    }
+
+    if ( left == nil || right == nil ) {
+        return NO;
+    }
+
+    NSUInteger length = left.length;
+    if ( right.length != length ) {
+        return NO;
+    }
+
+    return RZAssertFirstDifferenceFrom(left, right, 0, length) == length;
+}
+
+NSUInteger RZAssertFirstStringDifference(NSString *left, NSString *right)
+{
+    if ( left == right ) {
+        return NSNotFound;
+    }
+
+    if ( left == nil || right == nil ) {
+        return 0;
+    }
+
+    NSUInteger leftLength = left.length;
+    NSUInteger rightLength = right.length;
+    NSUInteger commonLength = MIN(leftLength, rightLength);
+
+    NSUInteger offset = RZAssertFirstDifferenceFrom(left, right, 0, commonLength);
+    if ( offset == commonLength && leftLength == rightLength ) {
+        return NSNotFound;
+    }
+
+    return offset;
+}
+
+#pragma mark - Descriptions
+
+// Quotes a window of a string around an offset, widened so it doesn't split a composed
+// character, with newlines and tabs escaped so the excerpt stays on one line.
+static NSString *RZAssertStringExcerpt(NSString *string, NSUInteger offset)
+{
+    if ( string == nil ) {
+        return @"(nil)";
+    }
+
+    NSUInteger length = string.length;
+    NSUInteger start = offset > RZASSERT_STRING_CONTEXT_LENGTH ? offset - RZASSERT_STRING_CONTEXT_LENGTH : 0;
+    NSUInteger end = MIN(length, offset + RZASSERT_STRING_CONTEXT_LENGTH);
+
+    NSRange range = NSMakeRange(MIN(start, length), end - MIN(start, length));
+    if ( range.length > 0 ) {
+        range = [string rangeOfComposedCharacterSequencesForRange:range];
+    }
+
+    NSMutableString *excerpt = [[string substringWithRange:range] mutableCopy];
+    [excerpt replaceOccurrencesOfString:@"\\" withString:@"\\\\" options:0 range:NSMakeRange(0, excerpt.length)];
+    [excerpt replaceOccurrencesOfString:@"\n" withString:@"\\n" options:0 range:NSMakeRange(0, excerpt.length)];
+    [excerpt replaceOccurrencesOfString:@"\r" withString:@"\\r" options:0 range:NSMakeRange(0, excerpt.length)];
+    [excerpt replaceOccurrencesOfString:@"\t" withString:@"\\t" options:0 range:NSMakeRange(0, excerpt.length)];
+
+    return [NSString stringWithFormat:@"%@\"%@\"%@", range.location > 0 ? @"…" : @"", excerpt, NSMaxRange(range) < length ? @"…" : @""];
+}
+
+NSString *RZAssertDescribeStringDifference(NSString *left, NSString *right)
+{
+    NSUInteger offset = RZAssertFirstStringDifference(left, right);
+    if ( offset == NSNotFound ) {
+        return @"Strings are equal";
+    }
+
+    return [NSString stringWithFormat:@"First difference at offset: %lu \nLengths: %lu, %lu \nLeft: %@ \nRight: %@", (unsigned long)offset, (unsigned long)left.length, (unsigned long)right.length, RZAssertStringExcerpt(left, offset), RZAssertStringExcerpt(right, offset)];
+}
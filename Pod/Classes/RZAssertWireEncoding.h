@@ -0,0 +1,105 @@
+//
+//  RZAssertWireEncoding.h
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertFailure.h"
+
+// A compact binary encoding of failures for shipping logs, where most of a flat message is the
+// same file, function and format text repeated. A stream starts with the 4-byte magic "RZW1",
+// followed by blocks, each starting with a tag byte. Integers are unsigned LEB128 varints, and
+// signed ones are zigzag-encoded first. Strings are a varint byte length and UTF-8 bytes.
+//
+//   String (1): string. Gets the next string ID, from 1.
+//   Site   (2): kind, expression, file and function string IDs, line. Gets the next site ID, from 1.
+//   Record (3): site ID or 0, text string ID or 0 followed by the text inline, flags, signed
+//               microseconds since the previous record (or the reference date), thread ID, and
+//               unless flag 1 is set, an argument count and the arguments.
+//
+// Flag 1 means the text is the formatted detail; otherwise it is the format, and the arguments
+// follow. Each argument is a type byte and a value: null (0), signed (1) and unsigned (2)
+// varints, a double (3) as 8 little-endian bytes, a pointer (4) as a varint, or a string (5).
+// Objects are sent as their descriptions.
+
+#define RZASSERT_WIRE_MAGIC     "RZW1"
+
+typedef NS_ENUM(uint8_t, RZAssertWireBlock) {
+    RZAssertWireBlockString = 1,
+    RZAssertWireBlockSite   = 2,
+    RZAssertWireBlockRecord = 3,
+};
+
+typedef NS_ENUM(uint8_t, RZAssertWireArgument) {
+    RZAssertWireArgumentNull        = 0,
+    RZAssertWireArgumentSigned      = 1,
+    RZAssertWireArgumentUnsigned    = 2,
+    RZAssertWireArgumentDouble      = 3,
+    RZAssertWireArgumentPointer     = 4,
+    RZAssertWireArgumentString      = 5,
+};
+
+#define RZASSERT_WIRE_RECORD_LITERAL    0x01
+
+FOUNDATION_EXPORT NSString *const RZAssertWireErrorDomain;
+
+typedef NS_ENUM(NSInteger, RZAssertWireError) {
+    /**
+     *  The data is truncated, or not in the wire format.
+     */
+    RZAssertWireErrorMalformed = 1,
+};
+
+/**
+ *  Encodes failures into the wire format. Each call site's strings and each format string are sent once, the first time a record needs them, in dictionary blocks at the start of the chunk; later records refer to them by ID. Not thread-safe; use each encoder from one thread or queue at a time.
+ */
+@interface RZAssertWireEncoder : NSObject
+
+/**
+ *  Encodes failures as the next chunk of the stream. Chunks must be decoded in order, by one decoder.
+ *
+ *  @param failures An array of RZAssertFailure objects.
+ *
+ *  @return The chunk, starting with the stream header if it is the first.
+ */
+- (NSData *)encodeFailures:(NSArray *)failures;
+
+@end
+
+/**
+ *  Decodes chunks written by an RZAssertWireEncoder back into failures, with the same messages. Sites are recreated once per distinct call site, and stay valid for the life of the process. Not thread-safe.
+ */
+@interface RZAssertWireDecoder : NSObject
+
+/**
+ *  Decodes the next chunk of a stream.
+ *
+ *  @param data  A chunk returned by -[RZAssertWireEncoder encodeFailures:].
+ *  @param error On failure, describes what went wrong.
+ *
+ *  @return An array of RZAssertFailure objects, or nil if the chunk could not be decoded.
+ */
+- (NSArray *)decodeData:(NSData *)data error:(NSError **)error;
+
+@end
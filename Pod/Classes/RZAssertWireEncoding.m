@@ -0,0 +1,489 @@
+//
+//  RZAssertWireEncoding.m
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+#import "RZAssertWireEncoding.h"
+
+NSString *const RZAssertWireErrorDomain = @"RZAssertWireErrorDomain";
+
+static const double kRZAssertWireMicrosecondsPerSecond = 1000000.0;
+
+#pragma mark - Writing
+
+static void RZAssertWireWriteByte(NSMutableData *data, uint8_t byte)
+{
+    [data appendBytes:&byte length:1];
+}
+
+static void RZAssertWireWriteVarint(NSMutableData *data, uint64_t value)
+{
+    uint8_t bytes[10];
+    size_t length = 0;
+
+    do {
+        uint8_t byte = value & 0x7f;
+        value >>= 7;
+        bytes[length++] = byte | ( value ? 0x80 : 0 );
+    } while ( value );
+
+    [data appendBytes:bytes length:length];
+}
+
+static void RZAssertWireWriteSignedVarint(NSMutableData *data, int64_t value)
+{
+    RZAssertWireWriteVarint(data, ((uint64_t)value << 1) ^ (uint64_t)(value >> 63));
+}
+
+static void RZAssertWireWriteString(NSMutableData *data, NSString *string)
+{
+    const char *UTF8String = [string UTF8String] ?: "";
+    size_t length = strlen(UTF8String);
+
+    RZAssertWireWriteVarint(data, length);
+    [data appendBytes:UTF8String length:length];
+}
+
+static int64_t RZAssertWireMicroseconds(NSTimeInterval timestamp)
+{
+    return (int64_t)llround(timestamp * kRZAssertWireMicrosecondsPerSecond);
+}
+
+#pragma mark - Reading
+
+typedef struct {
+    const uint8_t *bytes;
+    size_t length;
+    size_t offset;
+    BOOL failed;
+} RZAssertWireReader;
+
+static uint8_t RZAssertWireReadByte(RZAssertWireReader *reader)
+{
+    if ( reader->offset >= reader->length ) {
+        reader->failed = YES;
+        return 0;
+    }
+    return reader->bytes[reader->offset++];
+}
+
+static uint64_t RZAssertWireReadVarint(RZAssertWireReader *reader)
+{
+    uint64_t value = 0;
+
+    for ( unsigned int shift = 0; shift < 64; shift += 7 ) {
+        uint8_t byte = RZAssertWireReadByte(reader);
+        value |= (uint64_t)(byte & 0x7f) << shift;
+        if ( !(byte & 0x80) ) {
+            return value;
+        }
+    }
+
+    reader->failed = YES;
+    return 0;
+}
+
+static int64_t RZAssertWireReadSignedVarint(RZAssertWireReader *reader)
+{
+    uint64_t value = RZAssertWireReadVarint(reader);
+    return (int64_t)(value >> 1) ^ -(int64_t)(value & 1);
+}
+
+static NSString *RZAssertWireReadString(RZAssertWireReader *reader)
+{
+    uint64_t length = RZAssertWireReadVarint(reader);
+
+    if ( reader->failed || length > reader->length - reader->offset ) {
+        reader->failed = YES;
+        return nil;
+    }
+
+    NSString *string = [[NSString alloc] initWithBytes:reader->bytes + reader->offset length:(NSUInteger)length encoding:NSUTF8StringEncoding];
+    reader->offset += (size_t)length;
+    reader->failed = reader->failed || ( string == nil );
+
+    return string;
+}
+
+#pragma mark - Decoded Sites
+
+// Failures point at their sites without owning them, so decoded sites are interned for the
+// life of the process, once per distinct call site.
+static const RZAssertSite *RZAssertWireInternSite(NSString *kind, NSString *expression, NSString *file, NSString *function, int line)
+{
+    static NSMutableDictionary *s_sites = nil;
+    static dispatch_once_t onceToken;
+    dispatch_once(&onceToken, ^{
+        s_sites = [NSMutableDictionary dictionary];
+    });
+
+    NSArray *key = @[ kind, expression, file, function, @(line) ];
+
+    @synchronized(s_sites) {
+        NSValue *existing = s_sites[key];
+        if ( existing ) {
+            return [existing pointerValue];
+        }
+
+        RZAssertSite *site = calloc(1, sizeof(RZAssertSite));
+        site->kind = strdup([kind UTF8String]);
+        site->expression = strdup([expression UTF8String]);
+        site->file = strdup([file UTF8String]);
+        site->function = strdup([function UTF8String]);
+        site->line = line;
+
+        s_sites[key] = [NSValue valueWithPointer:site];
+        return site;
+    }
+}
+
+#pragma mark - RZAssertWireEncoder
+
+@interface RZAssertWireEncoder ()
+
+@property (strong, nonatomic) NSMutableDictionary *stringIdentifiers;
+@property (strong, nonatomic) NSMutableDictionary *siteIdentifiers;
+@property (assign, nonatomic) int64_t previousMicroseconds;
+@property (assign, nonatomic) BOOL wroteHeader;
+
+@end
+
+@implementation RZAssertWireEncoder
+
+- (instancetype)init
+{
+    self = [super init];
+    if ( self ) {
+        _stringIdentifiers = [NSMutableDictionary dictionary];
+        _siteIdentifiers = [NSMutableDictionary dictionary];
+    }
+    return self;
+}
+
+#pragma mark - Public
+
+- (NSData *)encodeFailures:(NSArray *)failures
+{
+    if ( !failures ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: failures must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    NSMutableData *dictionary = [NSMutableData data];
+    NSMutableData *records = [NSMutableData data];
+
+    if ( !self.wroteHeader ) {
+        [dictionary appendBytes:RZASSERT_WIRE_MAGIC length:strlen(RZASSERT_WIRE_MAGIC)];
+        self.wroteHeader = YES;
+    }
+
+    for ( RZAssertFailure *failure in failures ) {
+        [self encodeFailure:failure records:records dictionary:dictionary];
+    }
+
+    [dictionary appendData:records];
+    return [dictionary copy];
+}
+
+#pragma mark - Private
+
+- (uint64_t)identifierForString:(NSString *)string dictionary:(NSMutableData *)dictionary
+{
+    NSNumber *identifier = self.stringIdentifiers[string];
+
+    if ( !identifier ) {
+        identifier = @(self.stringIdentifiers.count + 1);
+        self.stringIdentifiers[string] = identifier;
+
+        RZAssertWireWriteByte(dictionary, RZAssertWireBlockString);
+        RZAssertWireWriteString(dictionary, string);
+    }
+
+    return [identifier unsignedLongLongValue];
+}
+
+- (uint64_t)identifierForSite:(const RZAssertSite *)site dictionary:(NSMutableData *)dictionary
+{
+    NSValue *key = [NSValue valueWithPointer:site];
+    NSNumber *identifier = self.siteIdentifiers[key];
+
+    if ( !identifier ) {
+        uint64_t kind = [self identifierForString:@(site->kind ?: "") dictionary:dictionary];
+        uint64_t expression = [self identifierForString:@(site->expression ?: "") dictionary:dictionary];
+        uint64_t file = [self identifierForString:@(site->file ?: "") dictionary:dictionary];
+        uint64_t function = [self identifierForString:@(site->function ?: "") dictionary:dictionary];
+
+        identifier = @(self.siteIdentifiers.count + 1);
+        self.siteIdentifiers[key] = identifier;
+
+        RZAssertWireWriteByte(dictionary, RZAssertWireBlockSite);
+        RZAssertWireWriteVarint(dictionary, kind);
+        RZAssertWireWriteVarint(dictionary, expression);
+        RZAssertWireWriteVarint(dictionary, file);
+        RZAssertWireWriteVarint(dictionary, function);
+        RZAssertWireWriteSignedVarint(dictionary, site->line);
+    }
+
+    return [identifier unsignedLongLongValue];
+}
+
+- (void)encodeFailure:(RZAssertFailure *)failure records:(NSMutableData *)records dictionary:(NSMutableData *)dictionary
+{
+    const RZAssertSite *site = failure.site;
+    NSArray *arguments = failure.arguments;
+
+    // Failures formatted eagerly, or created from a message, have no arguments to send.
+    BOOL literal = ( arguments.count == 0 );
+    NSString *text = literal ? failure.formattedDetail : failure.format;
+
+    uint64_t siteIdentifier = site ? [self identifierForSite:site dictionary:dictionary] : 0;
+    // Messages logged without a site are rarely repeated, so they aren't worth interning.
+    uint64_t textIdentifier = site ? [self identifierForString:text dictionary:dictionary] : 0;
+
+    RZAssertWireWriteByte(records, RZAssertWireBlockRecord);
+    RZAssertWireWriteVarint(records, siteIdentifier);
+    RZAssertWireWriteVarint(records, textIdentifier);
+    if ( textIdentifier == 0 ) {
+        RZAssertWireWriteString(records, text);
+    }
+    RZAssertWireWriteByte(records, literal ? RZASSERT_WIRE_RECORD_LITERAL : 0);
+
+    int64_t microseconds = RZAssertWireMicroseconds(failure.timestamp);
+    RZAssertWireWriteSignedVarint(records, microseconds - self.previousMicroseconds);
+    self.previousMicroseconds = microseconds;
+
+    RZAssertWireWriteVarint(records, failure.threadID);
+
+    if ( literal ) {
+        return;
+    }
+
+    RZAssertWireWriteVarint(records, arguments.count);
+
+    for ( id argument in arguments ) {
+        if ( argument == [NSNull null] ) {
+            RZAssertWireWriteByte(records, RZAssertWireArgumentNull);
+        }
+        else if ( [argument isKindOfClass:[NSNumber class]] ) {
+            char type = [argument objCType][0];
+
+            if ( type == 'd' || type == 'f' ) {
+                double value = [argument doubleValue];
+                uint64_t bits;
+                memcpy(&bits, &value, sizeof(bits));
+                uint8_t bytes[8];
+                for ( size_t i = 0; i < sizeof(bytes); i++ ) {
+                    bytes[i] = (uint8_t)(bits >> (8 * i));
+                }
+                RZAssertWireWriteByte(records, RZAssertWireArgumentDouble);
+                [records appendBytes:bytes length:sizeof(bytes)];
+            }
+            else if ( strchr("CISLQ", type) ) {
+                RZAssertWireWriteByte(records, RZAssertWireArgumentUnsigned);
+                RZAssertWireWriteVarint(records, [argument unsignedLongLongValue]);
+            }
+            else {
+                RZAssertWireWriteByte(records, RZAssertWireArgumentSigned);
+                RZAssertWireWriteSignedVarint(records, [argument longLongValue]);
+            }
+        }
+        else if ( [argument isKindOfClass:[NSValue class]] && strcmp([argument objCType], @encode(void *)) == 0 ) {
+            RZAssertWireWriteByte(records, RZAssertWireArgumentPointer);
+            RZAssertWireWriteVarint(records, (uintptr_t)[argument pointerValue]);
+        }
+        else {
+            RZAssertWireWriteByte(records, RZAssertWireArgumentString);
+            RZAssertWireWriteString(records, [argument description]);
+        }
+    }
+}
+
+@end
+
+#pragma mark - RZAssertWireDecoder
+
+@interface RZAssertWireDecoder ()
+
+@property (strong, nonatomic) NSMutableArray *strings;
+@property (strong, nonatomic) NSMutableArray *sites;
+@property (assign, nonatomic) int64_t previousMicroseconds;
+@property (assign, nonatomic) BOOL readHeader;
+
+@end
+
+@implementation RZAssertWireDecoder
+
+- (instancetype)init
+{
+    self = [super init];
+    if ( self ) {
+        _strings = [NSMutableArray array];
+        _sites = [NSMutableArray array];
+    }
+    return self;
+}
+
+#pragma mark - Public
+
+- (NSArray *)decodeData:(NSData *)data error:(NSError **)error
+{
+    if ( !data ) {
+        [NSException raise:NSInvalidArgumentException format:@"%s: data must not be nil", __PRETTY_FUNCTION__];
+    }
+
+    RZAssertWireReader reader = { data.bytes, data.length, 0, NO };
+    NSMutableArray *failures = [NSMutableArray array];
+
+    if ( !self.readHeader ) {
+        size_t magicLength = strlen(RZASSERT_WIRE_MAGIC);
+        if ( reader.length < magicLength || memcmp(reader.bytes, RZASSERT_WIRE_MAGIC, magicLength) != 0 ) {
+            return [self failWithError:error reason:@"missing stream header"];
+        }
+        reader.offset = magicLength;
+        self.readHeader = YES;
+    }
+
+    while ( reader.offset < reader.length ) {
+        RZAssertWireBlock block = RZAssertWireReadByte(&reader);
+
+        switch ( block ) {
+            case RZAssertWireBlockString: {
+                NSString *string = RZAssertWireReadString(&reader);
+                if ( string ) {
+                    [self.strings addObject:string];
+                }
+                break;
+            }
+            case RZAssertWireBlockSite: {
+                NSString *kind = [self stringWithIdentifier:RZAssertWireReadVarint(&reader)];
+                NSString *expression = [self stringWithIdentifier:RZAssertWireReadVarint(&reader)];
+                NSString *file = [self stringWithIdentifier:RZAssertWireReadVarint(&reader)];
+                NSString *function = [self stringWithIdentifier:RZAssertWireReadVarint(&reader)];
+                int line = (int)RZAssertWireReadSignedVarint(&reader);
+
+                if ( !kind || !expression || !file || !function ) {
+                    return [self failWithError:error reason:@"site refers to an unknown string"];
+                }
+                [self.sites addObject:[NSValue valueWithPointer:RZAssertWireInternSite(kind, expression, file, function, line)]];
+                break;
+            }
+            case RZAssertWireBlockRecord: {
+                RZAssertFailure *failure = [self decodeRecord:&reader];
+                if ( !failure ) {
+                    return [self failWithError:error reason:@"malformed record"];
+                }
+                [failures addObject:failure];
+                break;
+            }
+            default: {
+                return [self failWithError:error reason:[NSString stringWithFormat:@"unknown block %u", (unsigned int)block]];
+            }
+        }
+
+        if ( reader.failed ) {
+            return [self failWithError:error reason:@"truncated block"];
+        }
+    }
+
+    return [failures copy];
+}
+
+#pragma mark - Private
+
+- (NSString *)stringWithIdentifier:(uint64_t)identifier
+{
+    return ( identifier > 0 && identifier <= self.strings.count ) ? self.strings[(NSUInteger)identifier - 1] : nil;
+}
+
+- (RZAssertFailure *)decodeRecord:(RZAssertWireReader *)reader
+{
+    uint64_t siteIdentifier = RZAssertWireReadVarint(reader);
+    uint64_t textIdentifier = RZAssertWireReadVarint(reader);
+    NSString *text = ( textIdentifier == 0 ) ? RZAssertWireReadString(reader) : [self stringWithIdentifier:textIdentifier];
+    uint8_t flags = RZAssertWireReadByte(reader);
+    int64_t microseconds = self.previousMicroseconds + RZAssertWireReadSignedVarint(reader);
+    uint64_t threadID = RZAssertWireReadVarint(reader);
+
+    if ( reader->failed || !text || siteIdentifier > self.sites.count ) {
+        return nil;
+    }
+    self.previousMicroseconds = microseconds;
+
+    NSMutableArray *arguments = nil;
+
+    if ( !(flags & RZASSERT_WIRE_RECORD_LITERAL) ) {
+        uint64_t count = RZAssertWireReadVarint(reader);
+        if ( count > reader->length - reader->offset ) {
+            return nil;
+        }
+
+        arguments = [NSMutableArray arrayWithCapacity:(NSUInteger)count];
+
+        for ( uint64_t i = 0; i < count && !reader->failed; i++ ) {
+            RZAssertWireArgument type = RZAssertWireReadByte(reader);
+            id argument = nil;
+
+            switch ( type ) {
+                case RZAssertWireArgumentNull:      argument = [NSNull null]; break;
+                case RZAssertWireArgumentSigned:    argument = @(RZAssertWireReadSignedVarint(reader)); break;
+                case RZAssertWireArgumentUnsigned:  argument = @(RZAssertWireReadVarint(reader)); break;
+                case RZAssertWireArgumentPointer:   argument = [NSValue valueWithPointer:(const void *)(uintptr_t)RZAssertWireReadVarint(reader)]; break;
+                case RZAssertWireArgumentString:    argument = RZAssertWireReadString(reader); break;
+                case RZAssertWireArgumentDouble: {
+                    uint64_t bits = 0;
+                    for ( size_t b = 0; b < 8; b++ ) {
+                        bits |= (uint64_t)RZAssertWireReadByte(reader) << (8 * b);
+                    }
+                    double value;
+                    memcpy(&value, &bits, sizeof(value));
+                    argument = @(value);
+                    break;
+                }
+            }
+
+            if ( !argument ) {
+                return nil;
+            }
+            [arguments addObject:argument];
+        }
+
+        if ( reader->failed ) {
+            return nil;
+        }
+    }
+
+    const RZAssertSite *site = ( siteIdentifier > 0 ) ? [self.sites[(NSUInteger)siteIdentifier - 1] pointerValue] : NULL;
+
+    return [[RZAssertFailure alloc] initWithSite:site timestamp:microseconds / kRZAssertWireMicrosecondsPerSecond threadID:threadID format:text arguments:arguments];
+}
+
+- (NSArray *)failWithError:(NSError **)error reason:(NSString *)reason
+{
+    if ( error ) {
+        *error = [NSError errorWithDomain:RZAssertWireErrorDomain code:RZAssertWireErrorMalformed userInfo:@{ NSLocalizedDescriptionKey: [NSString stringWithFormat:@"Could not decode assertion records: %@.", reason] }];
+    }
+    return nil;
+}
+
+@end
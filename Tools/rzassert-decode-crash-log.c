@@ -0,0 +1,180 @@
+//
+//  rzassert-decode-crash-log.c
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Prints the records in a file written by +[RZAssert enableCrashLogAtPath:size:error:], oldest first.
+//
+// Usage: rzassert-decode-crash-log <path>
+//
+// Build with `rake tools`.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "RZAssertCrashLogFormat.h"
+
+// Seconds between the Unix epoch and the reference date used for record timestamps.
+static const double kReferenceDateOffset = 978307200.0;
+
+typedef struct {
+    uint64_t sequence;
+    const RZAssertCrashLogRecord *record;
+} DecodedRecord;
+
+static int compareDecodedRecords(const void *left, const void *right)
+{
+    uint64_t leftSequence = ((const DecodedRecord *)left)->sequence;
+    uint64_t rightSequence = ((const DecodedRecord *)right)->sequence;
+
+    return ( leftSequence > rightSequence ) - ( leftSequence < rightSequence );
+}
+
+static unsigned char *readFile(const char *path, size_t *length)
+{
+    FILE *file = fopen(path, "rb");
+    if ( !file ) {
+        return NULL;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long fileLength = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *bytes = ( fileLength > 0 ) ? malloc((size_t)fileLength) : NULL;
+    if ( bytes && fread(bytes, 1, (size_t)fileLength, file) != (size_t)fileLength ) {
+        free(bytes);
+        bytes = NULL;
+    }
+
+    fclose(file);
+    *length = (size_t)fileLength;
+
+    return bytes;
+}
+
+static void printRecord(const RZAssertCrashLogRecord *record)
+{
+    const char *strings = (const char *)record + sizeof(RZAssertCrashLogRecord);
+    const char *kind = strings;
+    const char *file = kind + record->kindLength;
+    const char *function = file + record->fileLength;
+    const char *detail = function + record->functionLength;
+
+    char timestamp[64] = "";
+    time_t seconds = (time_t)(record->timestamp + kReferenceDateOffset);
+    struct tm components;
+    if ( gmtime_r(&seconds, &components) ) {
+        strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &components);
+    }
+
+    if ( record->kindLength > 0 ) {
+        printf("%s UTC thread %llu: %.*s at %.*s:%u in %.*s\n",
+               timestamp, (unsigned long long)record->threadID,
+               (int)record->kindLength, kind,
+               (int)record->fileLength, file, record->line,
+               (int)record->functionLength, function);
+    }
+    else {
+        printf("%s UTC thread %llu:\n", timestamp, (unsigned long long)record->threadID);
+    }
+
+    printf("%.*s\n\n", (int)record->detailLength, detail);
+}
+
+int main(int argc, const char *argv[])
+{
+    if ( argc != 2 ) {
+        fprintf(stderr, "usage: %s <crash log>\n", argv[0]);
+        return 2;
+    }
+
+    size_t length = 0;
+    unsigned char *bytes = readFile(argv[1], &length);
+    if ( !bytes ) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    const RZAssertCrashLogHeader *header = (const RZAssertCrashLogHeader *)bytes;
+    if ( length < RZASSERT_CRASH_LOG_HEADER_SIZE || header->magic != RZASSERT_CRASH_LOG_MAGIC ) {
+        fprintf(stderr, "%s: not an RZAssert crash log\n", argv[1]);
+        free(bytes);
+        return 1;
+    }
+
+    if ( header->version != RZASSERT_CRASH_LOG_VERSION || header->capacity > length - RZASSERT_CRASH_LOG_HEADER_SIZE ) {
+        fprintf(stderr, "%s: unsupported version %u or corrupt header\n", argv[1], header->version);
+        free(bytes);
+        return 1;
+    }
+
+    const unsigned char *records = bytes + RZASSERT_CRASH_LOG_HEADER_SIZE;
+    uint64_t capacity = header->capacity;
+    uint64_t writeOffset = header->writeOffset;
+    uint64_t oldestIntactOffset = ( writeOffset > capacity ) ? writeOffset - capacity : 0;
+
+    DecodedRecord *decodedRecords = calloc(capacity / sizeof(RZAssertCrashLogRecord) + 1, sizeof(DecodedRecord));
+    size_t decodedCount = 0;
+
+    // Records can be overwritten partway through, so rather than walking from a known start,
+    // look at every aligned position and keep records whose sequence proves they are intact.
+    for ( uint64_t position = 0; position + sizeof(RZAssertCrashLogRecord) <= capacity; position += RZASSERT_CRASH_LOG_ALIGNMENT ) {
+        const RZAssertCrashLogRecord *record = (const RZAssertCrashLogRecord *)(records + position);
+
+        if ( record->magic != RZASSERT_CRASH_LOG_RECORD_MAGIC ) {
+            continue;
+        }
+
+        uint64_t stringsLength = (uint64_t)record->kindLength + record->fileLength + record->functionLength + record->detailLength;
+        int intact = ( record->length >= sizeof(RZAssertCrashLogRecord) + stringsLength &&
+                       position + record->length <= capacity &&
+                       record->sequence % capacity == position &&
+                       record->sequence >= oldestIntactOffset &&
+                       record->sequence + record->length <= writeOffset );
+
+        if ( intact ) {
+            decodedRecords[decodedCount].sequence = record->sequence;
+            decodedRecords[decodedCount].record = record;
+            decodedCount++;
+            position += record->length - RZASSERT_CRASH_LOG_ALIGNMENT;
+        }
+    }
+
+    qsort(decodedRecords, decodedCount, sizeof(DecodedRecord), compareDecodedRecords);
+
+    for ( size_t i = 0; i < decodedCount; i++ ) {
+        printRecord(decodedRecords[i].record);
+    }
+
+    fprintf(stderr, "%zu records\n", decodedCount);
+
+    free(decodedRecords);
+    free(bytes);
+
+    return 0;
+}
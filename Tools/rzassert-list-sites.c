@@ -0,0 +1,305 @@
+//
+//  rzassert-list-sites.c
+//  RZAssert
+//
+//  Copyright (c) 2014 Raizlabs. All rights reserved.
+//  http://raizlabs.com/
+//
+//  Permission is hereby granted, free of charge, to any person obtaining
+//  a copy of this software and associated documentation files (the
+//  "Software"), to deal in the Software without restriction, including
+//  without limitation the rights to use, copy, modify, merge, publish,
+//  distribute, sublicense, and/or sell copies of the Software, and to
+//  permit persons to whom the Software is furnished to do so, subject to
+//  the following conditions:
+//
+//  The above copyright notice and this permission notice shall be
+//  included in all copies or substantial portions of the Software.
+//
+//  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+//  EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+//  MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND
+//  NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE
+//  LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION
+//  OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+//  WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+//
+
+// Lists every RZAssert call site compiled into a binary, by reading the section that
+// RZASSERT_DECLARE_SITE fills. Works on 64-bit ELF files and 64-bit Mach-O files,
+// including universal binaries.
+//
+// Usage: rzassert-list-sites <binary>
+//
+// Build with `rake tools`.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ELF_SECTION_NAME        "rzassert_info"
+#define MACHO_SEGMENT_NAME      "__TEXT"
+#define MACHO_SECTION_NAME      "__rzassert_info"
+
+#define MACHO_MAGIC_64          0xfeedfacfu
+#define MACHO_FAT_MAGIC         0xcafebabeu
+#define MACHO_LC_SEGMENT_64     0x19u
+
+// Layouts from <elf.h> and <mach-o/loader.h>, restated so the tool builds on either platform.
+
+typedef struct {
+    unsigned char ident[16];
+    uint16_t type;
+    uint16_t machine;
+    uint32_t version;
+    uint64_t entry;
+    uint64_t programHeaderOffset;
+    uint64_t sectionHeaderOffset;
+    uint32_t flags;
+    uint16_t headerSize;
+    uint16_t programHeaderSize;
+    uint16_t programHeaderCount;
+    uint16_t sectionHeaderSize;
+    uint16_t sectionHeaderCount;
+    uint16_t sectionNamesIndex;
+} ELFHeader;
+
+typedef struct {
+    uint32_t name;
+    uint32_t type;
+    uint64_t flags;
+    uint64_t address;
+    uint64_t offset;
+    uint64_t size;
+    uint32_t link;
+    uint32_t info;
+    uint64_t alignment;
+    uint64_t entrySize;
+} ELFSectionHeader;
+
+typedef struct {
+    uint32_t magic;
+    int32_t cpuType;
+    int32_t cpuSubtype;
+    uint32_t fileType;
+    uint32_t commandCount;
+    uint32_t commandsSize;
+    uint32_t flags;
+    uint32_t reserved;
+} MachHeader;
+
+typedef struct {
+    uint32_t command;
+    uint32_t commandSize;
+} MachLoadCommand;
+
+typedef struct {
+    uint32_t command;
+    uint32_t commandSize;
+    char segmentName[16];
+    uint64_t address;
+    uint64_t addressSize;
+    uint64_t fileOffset;
+    uint64_t fileSize;
+    int32_t maximumProtection;
+    int32_t initialProtection;
+    uint32_t sectionCount;
+    uint32_t flags;
+} MachSegmentCommand;
+
+typedef struct {
+    char sectionName[16];
+    char segmentName[16];
+    uint64_t address;
+    uint64_t size;
+    uint32_t offset;
+    uint32_t alignment;
+    uint32_t relocationOffset;
+    uint32_t relocationCount;
+    uint32_t flags;
+    uint32_t reserved1;
+    uint32_t reserved2;
+    uint32_t reserved3;
+} MachSection;
+
+typedef struct {
+    const unsigned char *bytes;
+    size_t length;
+} Section;
+
+static uint32_t readBigEndian32(const unsigned char *bytes)
+{
+    return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3];
+}
+
+static int inBounds(size_t length, uint64_t offset, uint64_t size)
+{
+    return ( offset <= length && size <= length - offset );
+}
+
+static int findELFSection(const unsigned char *file, size_t length, Section *section)
+{
+    const ELFHeader *header = (const ELFHeader *)file;
+
+    if ( length < sizeof(ELFHeader) || memcmp(header->ident, "\x7f" "ELF", 4) != 0 || header->ident[4] != 2 ) {
+        return 0;
+    }
+
+    if ( !inBounds(length, header->sectionHeaderOffset, (uint64_t)header->sectionHeaderCount * sizeof(ELFSectionHeader)) || header->sectionNamesIndex >= header->sectionHeaderCount ) {
+        return 0;
+    }
+
+    const ELFSectionHeader *sections = (const ELFSectionHeader *)(file + header->sectionHeaderOffset);
+    const ELFSectionHeader *names = &sections[header->sectionNamesIndex];
+
+    for ( uint16_t i = 0; i < header->sectionHeaderCount; i++ ) {
+        if ( sections[i].name >= names->size || !inBounds(length, names->offset, names->size) ) {
+            continue;
+        }
+
+        const char *name = (const char *)file + names->offset + sections[i].name;
+        if ( strcmp(name, ELF_SECTION_NAME) == 0 && inBounds(length, sections[i].offset, sections[i].size) ) {
+            section->bytes = file + sections[i].offset;
+            section->length = (size_t)sections[i].size;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+static int findMachOSection(const unsigned char *file, size_t length, Section *section)
+{
+    if ( length >= 8 && readBigEndian32(file) == MACHO_FAT_MAGIC ) {
+        // Universal binary: the site list is the same in every slice, so use the first 64-bit one.
+        uint32_t architectureCount = readBigEndian32(file + 4);
+
+        for ( uint32_t i = 0; i < architectureCount; i++ ) {
+            const unsigned char *architecture = file + 8 + (size_t)i * 20;
+            if ( !inBounds(length, (uint64_t)(architecture - file), 20) ) {
+                break;
+            }
+
+            uint32_t offset = readBigEndian32(architecture + 8);
+            uint32_t size = readBigEndian32(architecture + 12);
+            if ( inBounds(length, offset, size) && findMachOSection(file + offset, size, section) ) {
+                return 1;
+            }
+        }
+
+        return 0;
+    }
+
+    const MachHeader *header = (const MachHeader *)file;
+    if ( length < sizeof(MachHeader) || header->magic != MACHO_MAGIC_64 ) {
+        return 0;
+    }
+
+    size_t commandOffset = sizeof(MachHeader);
+
+    for ( uint32_t i = 0; i < header->commandCount; i++ ) {
+        if ( !inBounds(length, commandOffset, sizeof(MachLoadCommand)) ) {
+            break;
+        }
+
+        const MachLoadCommand *command = (const MachLoadCommand *)(file + commandOffset);
+
+        if ( command->command == MACHO_LC_SEGMENT_64 && inBounds(length, commandOffset, command->commandSize) ) {
+            const MachSegmentCommand *segment = (const MachSegmentCommand *)command;
+            const MachSection *sections = (const MachSection *)(segment + 1);
+
+            for ( uint32_t j = 0; j < segment->sectionCount; j++ ) {
+                if ( strncmp(sections[j].segmentName, MACHO_SEGMENT_NAME, 16) == 0 &&
+                     strncmp(sections[j].sectionName, MACHO_SECTION_NAME, 16) == 0 &&
+                     inBounds(length, sections[j].offset, sections[j].size) ) {
+                    section->bytes = file + sections[j].offset;
+                    section->length = (size_t)sections[j].size;
+                    return 1;
+                }
+            }
+        }
+
+        if ( command->commandSize == 0 ) {
+            break;
+        }
+        commandOffset += command->commandSize;
+    }
+
+    return 0;
+}
+
+// Each site is four NUL-terminated strings: kind, expression, file, line.
+static size_t printSites(const Section *section)
+{
+    const char *cursor = (const char *)section->bytes;
+    const char *end = cursor + section->length;
+    size_t siteCount = 0;
+
+    for ( ;; ) {
+        while ( cursor < end && *cursor == '\0' ) {
+            cursor++;
+        }
+
+        const char *fields[4];
+        int fieldCount = 0;
+
+        while ( fieldCount < 4 && cursor < end ) {
+            const char *terminator = memchr(cursor, '\0', (size_t)(end - cursor));
+            if ( !terminator ) {
+                return siteCount;
+            }
+
+            fields[fieldCount++] = cursor;
+            cursor = terminator + 1;
+        }
+
+        if ( fieldCount < 4 ) {
+            return siteCount;
+        }
+
+        printf("%s:%s: %s(%s)\n", fields[2], fields[3], fields[0], fields[1]);
+        siteCount++;
+    }
+}
+
+int main(int argc, const char *argv[])
+{
+    if ( argc != 2 ) {
+        fprintf(stderr, "usage: %s <binary>\n", argv[0]);
+        return 2;
+    }
+
+    FILE *file = fopen(argv[1], "rb");
+    if ( !file ) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+
+    unsigned char *bytes = ( length > 0 ) ? malloc((size_t)length) : NULL;
+    if ( !bytes || fread(bytes, 1, (size_t)length, file) != (size_t)length ) {
+        fprintf(stderr, "%s: could not read file\n", argv[1]);
+        fclose(file);
+        free(bytes);
+        return 1;
+    }
+    fclose(file);
+
+    Section section;
+    if ( !findELFSection(bytes, (size_t)length, &section) && !findMachOSection(bytes, (size_t)length, &section) ) {
+        fprintf(stderr, "%s: no RZAssert call sites found\n", argv[1]);
+        free(bytes);
+        return 1;
+    }
+
+    size_t siteCount = printSites(&section);
+    fprintf(stderr, "%zu call sites\n", siteCount);
+
+    free(bytes);
+
+    return 0;
+}